@@ -0,0 +1,196 @@
+#include "timer.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <cstdio>
+#include <random>
+#include "tsl.hpp"
+
+#ifdef __linux__
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+//benchmark options (set from the command line)
+struct Options {
+	size_t      cols    = 1000 ;//scan width in pixels
+	size_t      rows    = 1000 ;//scan height in pixels
+	bool        hex     = true ;//hexagonal grid (square otherwise)
+	size_t      tokens  = 10   ;//tokens per line (8, 9, 10, or more for extra columns)
+	size_t      phases  = 2    ;//number of phases in the header
+	size_t      threads = 0    ;//threads for the parallel parsers (0 to use all hardware threads)
+	size_t      reps    = 3    ;//timed repetitions of each case (the best is reported)
+	std::string file           ;//existing file to benchmark instead of a synthetic one
+	bool        keep    = false;//keep the synthetic file after benchmarking
+};
+
+//@brief: write a synthetic ang file
+//@param fileName: file to write
+//@param opt: scan geometry / contents
+void generate(const std::string& fileName, const Options& opt) {
+	std::ofstream os(fileName.c_str(), std::ios::out | std::ios::binary);
+	if(!os) throw std::runtime_error("couldn't create " + fileName);
+
+	//write the header
+	static const std::uint32_t Syms[4] = {43, 62, 32, 2};
+	const float xStep = 0.5f, yStep = opt.hex ? 0.433013f : 0.5f;
+	const size_t nOdd = opt.cols, nEven = opt.hex ? opt.cols - 1 : opt.cols;
+	os << "# TEM_PIXperUM          1.000000\n# x-star                0.512300\n# y-star                0.471100\n# z-star                0.680000\n# WorkingDistance       15.000000\n#\n";
+	for(size_t p = 0; p < opt.phases; p++) {
+		os << "# Phase " << p + 1 << "\n# MaterialName  \tPhase" << p + 1 << "\n# Formula     \t\n# Info \t\t\n# Symmetry              " << Syms[p % 4] << '\n';
+		os << "# LatticeConstants      3.520 3.520 3.520  90.000  90.000  90.000\n# NumberFamilies        3\n";
+		os << "# hklFamilies   \t 1  1  1 1 100.000000 1\n# hklFamilies   \t 2  0  0 1 45.000000 1\n# hklFamilies   \t 2  2  0 1 30.000000 1\n";
+		for(size_t i = 0; i < 6; i++) os << "# ElasticConstants \t0.000000 0.000000 0.000000 0.000000 0.000000 0.000000\n";
+		os << "# Categories0 0 0 0 0 \n#\n";
+	}
+	os << "# GRID: " << (opt.hex ? "HexGrid" : "SqrGrid") << "\n# XSTEP: " << xStep << "\n# YSTEP: " << yStep << '\n';
+	os << "# NCOLS_ODD: " << nOdd << "\n# NCOLS_EVEN: " << nEven << "\n# NROWS: " << opt.rows << '\n';
+	os << "#\n# OPERATOR: \tbenchmark\n#\n# SAMPLEID: \t\n#\n# SCANID: \t\n#\n";
+
+	//write the data in large blocks
+	std::mt19937 gen(0);//fixed seed so files are reproducible
+	std::uniform_real_distribution<float> phi(0.0f, 6.283185f), Phi(0.0f, 3.141593f), unit(0.0f, 1.0f);
+	std::uniform_int_distribution<size_t> phase(opt.phases > 1 ? 1 : 0, opt.phases);
+	std::string block;
+	char line[512];
+	for(size_t r = 0; r < opt.rows; r++) {
+		const size_t width = 0 == r % 2 ? nOdd : nEven;
+		const float shift = opt.hex && 1 == r % 2 ? 0.5f * xStep : 0.0f;
+		for(size_t c = 0; c < width; c++) {
+			int n = std::snprintf(line, sizeof(line), "%9.5f %9.5f %9.5f %12.5f %12.5f %.1f  %.3f  %zu", phi(gen), Phi(gen), phi(gen), c * xStep + shift, r * yStep, unit(gen) * 3000, unit(gen), phase(gen));
+			if(opt.tokens > 8) n += std::snprintf(line + n, sizeof(line) - n, " %.6f", unit(gen) * 2000);
+			if(opt.tokens > 9) n += std::snprintf(line + n, sizeof(line) - n, "  %.3f", unit(gen) * 3);
+			for(size_t i = 10; i < opt.tokens; i++) n += std::snprintf(line + n, sizeof(line) - n, " %.3f", unit(gen));//extra columns are skipped by the readers
+			block.append(line, n);
+			block.push_back('\n');
+		}
+		if(block.size() > (1 << 20)) {
+			os.write(block.data(), block.size());
+			block.clear();
+		}
+	}
+	os.write(block.data(), block.size());
+	if(!os) throw std::runtime_error("couldn't write " + fileName);
+}
+
+//@brief: evict a file from the page cache
+//@param fileName: file to evict
+//@return: true if the file was evicted, false if this isn't supported
+bool dropCache(const std::string& fileName) {
+#ifdef __linux__
+	const int fd = open(fileName.c_str(), O_RDONLY);
+	if(fd < 0) return false;
+	fdatasync(fd);//dirty pages can't be dropped
+	const bool dropped = 0 == posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+	close(fd);
+	return dropped;
+#else
+	return false;
+#endif
+}
+
+//@brief: time a read path with a cold and warm page cache and print the throughput
+//@param name: name of read path
+//@param fileName: file the read path reads (evicted for cold reads)
+//@param points: number of points in the scan
+//@param opt: benchmark options
+//@param read: function to time
+template <typename F> void run(const std::string& name, const std::string& fileName, const size_t points, const Options& opt, F read) {
+	const double mb = double(std::filesystem::file_size(fileName)) / (1024 * 1024);
+	for(const bool cold : {true, false}) {
+		if(cold && !dropCache(fileName)) {
+			std::cout << std::left << std::setw(28) << name << std::setw(6) << "cold" << "(page cache eviction unsupported)\n";
+			continue;
+		}
+		if(!cold) read();//warm the cache
+		double best = std::numeric_limits<double>::infinity();
+		for(size_t i = 0; i < opt.reps; i++) {
+			if(cold) dropCache(fileName);
+			Timer t;
+			read();
+			best = std::min(best, t.poll());
+		}
+		std::cout << std::left << std::setw(28) << name << std::setw(6) << (cold ? "cold" : "warm") << std::right << std::fixed;
+		std::cout << std::setprecision(4) << std::setw(10) << best << " s" << std::setprecision(1) << std::setw(10) << mb / best << " MB/s" << std::setw(10) << points / best / 1e6 << " Mpts/s\n";
+	}
+}
+
+int main(int argc, char* argv[]) {
+	//parse arguments
+	Options opt;
+	try {
+		for(int i = 1; i < argc; i++) {
+			const std::string arg = argv[i];
+			if("--help" == arg || "-h" == arg) {
+				std::cout << "usage: " << argv[0] << " [--cols n] [--rows n] [--grid hex|sqr] [--tokens n] [--phases n] [--threads n] [--reps n] [--file name.ang] [--keep]\n";
+				return EXIT_SUCCESS;
+			}
+			if("--keep" == arg) {
+				opt.keep = true;
+				continue;
+			}
+			if(i + 1 == argc) throw std::runtime_error("missing value for " + arg);
+			const std::string value = argv[++i];
+			if     ("--cols"    == arg) opt.cols    = std::stoul(value);
+			else if("--rows"    == arg) opt.rows    = std::stoul(value);
+			else if("--grid"    == arg) opt.hex     = "sqr" != value;
+			else if("--tokens"  == arg) opt.tokens  = std::stoul(value);
+			else if("--phases"  == arg) opt.phases  = std::stoul(value);
+			else if("--threads" == arg) opt.threads = std::stoul(value);
+			else if("--reps"    == arg) opt.reps    = std::stoul(value);
+			else if("--file"    == arg) opt.file    = value;
+			else throw std::runtime_error("unknown argument " + arg);
+		}
+		if(opt.tokens < 8) throw std::runtime_error("ang files have at least 8 tokens per line");
+		if(opt.cols < 2 || 0 == opt.rows || 0 == opt.phases || 0 == opt.reps) throw std::runtime_error("scan dimensions, phase count, and repetitions must be positive");
+	} catch (std::exception& e) {
+		std::cerr << e.what() << '\n';
+		return EXIT_FAILURE;
+	}
+
+	try {
+		//generate a scan (or use an existing one)
+		const bool synthetic = opt.file.empty();
+		const std::string fileName = synthetic ? (std::filesystem::temp_directory_path() / "tsl_bench.ang").string() : opt.file;
+		const std::string sidecar = tsl::OrientationMap::SidecarName(fileName);
+		if(synthetic) {
+			Timer timer;
+			generate(fileName, opt);
+			std::cout << "generated '" << fileName << "' in " << timer.poll() << "s\n";
+		}
+		if(std::filesystem::exists(sidecar)) throw std::runtime_error(sidecar + " already exists (remove it so the text parsers are benchmarked)");
+
+		//print scan summary
+		const size_t threads = 0 == opt.threads ? std::max<size_t>(1, std::thread::hardware_concurrency()) : opt.threads;
+		tsl::OrientationMap om;
+		om.read(fileName, threads);
+		const size_t points = om.numPoints();
+		std::cout << om.gridType << " scan (" << om.nColsOdd << '/' << om.nColsEven << ") x " << om.nRows << ", " << points << " points, " << om.phaseList.size() << " phase(s), ";
+		std::cout << std::filesystem::file_size(fileName) / (1024 * 1024) << " MB, " << threads << " thread(s), best of " << opt.reps << "\n\n";
+
+		//time the text parsers
+		const std::string threaded = "mmap x" + std::to_string(threads);
+		run("istream"                , fileName, points, opt, [&](){om.readStream(fileName);});
+		run("mmap x1"                , fileName, points, opt, [&](){om.read(fileName, 1);});
+		run(threaded                 , fileName, points, opt, [&](){om.read(fileName, threads);});
+		run(threaded + " eu+phase"   , fileName, points, opt, [&](){om.read(fileName, threads, tsl::Column::Eu | tsl::Column::Phase);});
+		run(threaded + " +quats"     , fileName, points, opt, [&](){om.read(fileName, threads, tsl::Column::All | tsl::Column::Qu);});
+		run("read ahead x" + std::to_string(threads), fileName, points, opt, [&](){om.readBuffered(fileName, threads);});
+		run("stream reader 256 rows", fileName, points, opt, [&](){
+			tsl::AngStreamReader reader(fileName);
+			reader.readBlocks(256, tsl::Column::All, [](const tsl::ScanBuffers&, const size_t, const size_t){});
+		});
+
+		//time the binary sidecar
+		om.read(fileName, threads);
+		om.writeSidecar(fileName);
+		run("angb sidecar"     , sidecar, points, opt, [&](){om.read(fileName, threads);});
+		run("angb view"        , sidecar, points, opt, [&](){tsl::OrientationMapView view(fileName, true);});
+		std::filesystem::remove(sidecar);
+		if(synthetic && !opt.keep) std::filesystem::remove(fileName);
+	} catch (std::exception& e) {
+		std::cerr << e.what() << '\n';
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -1,18 +1,4 @@
-#include <chrono>
-
-struct  Timer {
-	std::chrono::high_resolution_clock::time_point tp;
-	Timer() : tp(std::chrono::high_resolution_clock::now()) {}
-
-	//@brief: compute time since previous call (or construction)
-	//@return: time in seconds
-	double poll() {
-		std::chrono::high_resolution_clock::time_point now = std::chrono::high_resolution_clock::now();//get current time
-		std::chrono::duration<double> elapsed = now - tp;//compute duration since last poll
-		tp = now;//update last polled time
-		return elapsed.count();//return elapsed time in fractional seconds
-	}
-};
+#include "timer.hpp"
 
 #include <iostream>
 #include "tsl.hpp"
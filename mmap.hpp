@@ -34,6 +34,14 @@
 
 #include <string>
 #include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 namespace memorymap {
 	//wraper for type of memory map access pattern hints
@@ -43,6 +51,16 @@ namespace memorymap {
 		Random     //expect random access (modify caching behavior accordingly)
 	};
 
+	//optional tuning of how a file is mapped
+	struct Options {
+		std::uint64_t readAhead;//number of bytes from the start of the file to start reading in the background once mapped (UINT64_MAX for the entire file)
+		bool          populate ;//fault in the entire file before the constructor returns (MAP_POPULATE on linux, a background prefetch of the entire file elsewhere)
+		bool          hugePages;//request transparent huge pages for mappings of at least 2 MB (MADV_HUGEPAGE on linux, ignored elsewhere)
+
+		//@brief: construct default options (no read ahead, population, or huge pages)
+		Options() : readAhead(0), populate(false), hugePages(false) {}
+	};
+
 	//@brief: cross platform memory mapped file interface
 	class File {
 		public:
@@ -52,7 +70,8 @@ namespace memorymap {
 			//@param hint: access pattern hint
 			//@param write: true to allow write access, false for read only (true + a non existent file -> write only)
 			//@param size: size to create or resize file to (or 0 to use current file size, ignored if no write access is requested)
-			File(std::string filename, Hint hint = Hint::Normal, const bool write = false, const uint64_t size = 0);
+			//@param options: read ahead / population / huge page options
+			File(std::string filename, Hint hint = Hint::Normal, const bool write = false, const uint64_t size = 0, const Options& options = Options());
 
 			//@brief: close the memory mapped file / cleanup on destruction (+write changes to disk if needed)
 			~File();
@@ -77,6 +96,20 @@ namespace memorymap {
 			//@return: true for read/write, false for read only
 			bool writeAccess() const {return canWrite;}
 
+			//@brief: ask the os to start reading part of the file in the background (MADV_WILLNEED / PrefetchVirtualMemory)
+			//@param offset: offset of first byte to prefetch
+			//@param bytes: number of bytes to prefetch (clipped to the end of the file)
+			//@return: true if the request was accepted, false if it failed or isn't supported
+			//@note: the range is expanded to whole pages
+			bool prefetch(const std::uint64_t offset, const std::uint64_t bytes) const;
+
+			//@brief: tell the os part of the file isn't needed anymore so its pages can be dropped from this process (MADV_DONTNEED / VirtualUnlock)
+			//@param offset: offset of first byte to release
+			//@param bytes: number of bytes to release (clipped to the end of the file)
+			//@return: true if the request was accepted, false if it failed or isn't supported
+			//@note: only whole pages inside the range are released, released pages are read again (from the page cache if still cached) if they are accessed later
+			bool release(const std::uint64_t offset, const std::uint64_t bytes) const;
+
 		private:
 			void*         fileBuffer;//pointer to raw data in memory map
 			std::uint64_t fileBytes ;//size of file in bytes
@@ -93,6 +126,66 @@ namespace memorymap {
 			File(File const &) = delete;
 			void operator=(File const &) = delete;
 	};
+
+	//@brief: sequential file reader that issues large reads into a ring of aligned buffers on a background thread (an alternative to memory mapping for file systems where page faults are slow)
+	class ReadAheadFile {
+		public:
+			//@brief: open a file and start reading it in the background
+			//@param filename: name of file to read
+			//@param blockBytes: size of each read (rounded up to a multiple of 4 KB)
+			//@param blockCount: number of buffers in the ring (at least 2, up to blockCount - 1 blocks are read ahead of the block being used)
+			//@param headroom: space reserved in front of each buffer for bytes carried over from the previous block (rounded up to a multiple of 4 KB)
+			ReadAheadFile(std::string filename, const size_t blockBytes = 8 * 1024 * 1024, const size_t blockCount = 4, const size_t headroom = 64 * 1024);
+
+			//@brief: stop reading and close the file
+			~ReadAheadFile();
+
+			//@brief: get size of file in bytes
+			//@return: size of file in bytes
+			std::uint64_t size() const {return fileBytes;}
+
+			//@brief: get the next block of the file (waiting for its read to finish if needed)
+			//@param keep: start of unused bytes at the end of the previous block to place directly in front of the next block (e.g. a partial line), or NULL
+			//@param bytes: location to write the size of the block (including kept bytes)
+			//@return: read only pointer to the block (valid until the next call), or NULL once the entire file has been returned (the previous block stays valid)
+			char const * next(char const * keep, size_t& bytes);
+
+		private:
+			struct Block {
+				char * data ;//start of block data (headroom bytes into the buffer)
+				size_t bytes;//number of bytes read into the block
+			};
+
+			//@brief: read blocks into the ring until the file ends or the reader is destroyed (run on the background thread)
+			void readLoop();
+
+			//@brief: read part of the file
+			//@param offset: offset of first byte to read
+			//@param buffer: location to read into
+			//@param bytes: number of bytes to read
+			void readAt(const std::uint64_t offset, char * const buffer, const size_t bytes);
+
+			std::string             name      ;//name of file (for error messages)
+			std::unique_ptr<char[]> storage   ;//memory for all buffers (left uninitialized)
+			std::vector<Block>      blocks    ;//ring of buffers
+			size_t                  blockBytes;//size of each read
+			size_t                  headroom  ;//space in front of each block for carried over bytes
+			std::uint64_t           fileBytes ;//size of file in bytes
+			size_t                  total     ;//number of blocks in the file
+			size_t                  filled    ;//number of blocks read
+			size_t                  consumed  ;//number of blocks returned by next()
+			bool                    stop      ;//flag to stop the reader thread
+			std::string             error     ;//error message from the reader thread
+			std::mutex              mutex     ;//protects filled / consumed / stop / error
+			std::condition_variable changed   ;//signaled when a block is read or released
+			void*                   fileHandle;//handle to opened file (windows)
+			int                     fileId    ;//opened file number (*nix)
+			std::thread             reader    ;//background reader
+
+			//disable copying
+			ReadAheadFile(ReadAheadFile const &) = delete;
+			void operator=(ReadAheadFile const &) = delete;
+	};
 }
 
 //the two main interfaces to memory maps are provided by windows and unix style interfaces, this block handles the includes / #defines to switch between them at compile time as needed
@@ -136,9 +229,11 @@ namespace memorymap {
 	#endif
 	#ifdef __64_FUNCS_DEPRECATED_//___64 functions are deprecated
 		#define STAT stat
+		#define FSTAT fstat
 		#define MMAP mmap
 	#else//explicitely use 64 bit functions
 		#define STAT stat64
+		#define FSTAT fstat64
 		#define MMAP mmap64
 	#endif
 #else
@@ -188,6 +283,36 @@ namespace memorymap {
 			#endif
 			throw std::logic_error("failed to parse memory map hint");
 		}
+
+		//@brief: get the size of a virtual memory page
+		//@return: page size in bytes
+		std::uint64_t pageSize() {
+			#if _MMAP_API_TYPE_ == _MMAP_WIN_//windows
+				SYSTEM_INFO info;
+				GetSystemInfo(&info);
+				return (std::uint64_t)info.dwPageSize;
+			#elif _MMAP_API_TYPE_ == _MMAP_NIX_// *nix
+				const long size = sysconf(_SC_PAGESIZE);
+				return size > 0 ? (std::uint64_t)size : 4096;
+			#else//unknown platform
+				static_assert(false, "memorymap::detail::pageSize isn't implemented for this platform");
+			#endif
+		}
+
+		#if _MMAP_API_TYPE_ == _MMAP_WIN_//windows
+		//@brief: prefetch a range of a mapping with PrefetchVirtualMemory (looked up at runtime since it requires windows 8)
+		//@param address: start of range
+		//@param bytes: size of range
+		//@return: true if the prefetch was requested
+		bool prefetchVirtualMemory(void* address, const std::uint64_t bytes) {
+			struct RangeEntry {PVOID VirtualAddress; SIZE_T NumberOfBytes;};//WIN32_MEMORY_RANGE_ENTRY (not declared for older WINVER)
+			typedef BOOL (WINAPI *PrefetchFunc)(HANDLE, ULONG_PTR, RangeEntry*, ULONG);
+			static const PrefetchFunc prefetch = (PrefetchFunc)GetProcAddress(GetModuleHandleA("kernel32.dll"), "PrefetchVirtualMemory");
+			if(NULL == prefetch) return false;
+			RangeEntry range = {address, (SIZE_T)bytes};
+			return 0 != prefetch(GetCurrentProcess(), 1, &range, 0);
+		}
+		#endif
 	}
 
 	//@brief: open a memory mapped file
@@ -195,7 +320,8 @@ namespace memorymap {
 	//@param hint: access pattern hint
 	//@param write: true to allow write access, false for read only
 	//@param size: size to create or resize file to (or 0 to use current file size, ignored if no write access is requested)
-	File::File(std::string fileName, Hint hint, const bool write, const uint64_t size) : fileBuffer(NULL), fileBytes(write ? size : 0), fileHandle(NULL), fileMap(NULL), canWrite(write) {
+	//@param options: read ahead / population / huge page options
+	File::File(std::string fileName, Hint hint, const bool write, const uint64_t size, const Options& options) : fileBuffer(NULL), fileBytes(write ? size : 0), canWrite(write), fileHandle(NULL), fileMap(NULL), fileId(-1) {
 		#if _MMAP_API_TYPE_ == _MMAP_WIN_//windows
 			const DWORD attrib = GetFileAttributesA(fileName.c_str());//get info about the file
 			const bool fileExists = (attrib != INVALID_FILE_ATTRIBUTES && !(attrib & FILE_ATTRIBUTE_DIRECTORY));//check if the file exists
@@ -226,6 +352,7 @@ namespace memorymap {
 					if(NULL != fileHandle)	CloseHandle(fileHandle);//close the handle if it was opened
 					throw std::runtime_error(fileName + " couldn't be memory mapped: " + detail::getErrorMessage());
 				}
+				if(options.populate) prefetch(0, fileBytes);
 			}
 		#elif _MMAP_API_TYPE_ == _MMAP_NIX_// *nix
 			//unix/mac #defined values
@@ -244,16 +371,27 @@ namespace memorymap {
 						}
 					}
 					if(!error) {//did we get/update the file size without issue?
-						fileBuffer = MMAP(NULL, fileBytes, PROT_READ | (canWrite ? PROT_WRITE : 0), MAP_SHARED, fileId, 0);//create the memory map with appropriate access
-						if(MAP_FAILED != fileBuffer) madvise(fileBuffer, fileBytes, (int)hint);//give the os our access hint if the map was successful
+						int flags = MAP_SHARED;
+						#ifdef MAP_POPULATE
+							if(options.populate) flags |= MAP_POPULATE;//fault in the whole file up front
+						#endif
+						fileBuffer = MMAP(NULL, fileBytes, PROT_READ | (canWrite ? PROT_WRITE : 0), flags, fileId, 0);//create the memory map with appropriate access
+						if(MAP_FAILED != fileBuffer) madvise(fileBuffer, fileBytes, (int)detail::translateHint(hint));//give the os our access hint if the map was successful
 					}
 				}
 			}
 			if(NULL == fileBuffer || MAP_FAILED == fileBuffer) {//if the raw pointer is null/bad something went wrong
-				if(-1 == fileId) close(fileId);//close the file if it was opened
+				if(-1 != fileId) close(fileId);//close the file if it was opened
 				throw std::runtime_error(fileName + " couldn't be memory mapped: " + detail::getErrorMessage());
 			}
+			#ifdef MADV_HUGEPAGE
+				if(options.hugePages && fileBytes >= 2 * 1024 * 1024) madvise(fileBuffer, fileBytes, MADV_HUGEPAGE);//huge pages are only a request, failure isn't an error
+			#endif
+			#ifndef MAP_POPULATE
+				if(options.populate) prefetch(0, fileBytes);
+			#endif
 		#endif
+		if(options.readAhead > 0 && !options.populate) prefetch(0, options.readAhead);
 	}
 
 	File::~File() {
@@ -266,6 +404,193 @@ namespace memorymap {
 			close(fileId);//close file
 		#endif
 	}
+
+	//@brief: ask the os to start reading part of the file in the background (MADV_WILLNEED / PrefetchVirtualMemory)
+	//@param offset: offset of first byte to prefetch
+	//@param bytes: number of bytes to prefetch (clipped to the end of the file)
+	//@return: true if the request was accepted, false if it failed or isn't supported
+	bool File::prefetch(const std::uint64_t offset, const std::uint64_t bytes) const {
+		if(offset >= fileBytes || 0 == bytes) return true;//nothing to do
+		const std::uint64_t page = detail::pageSize();
+		const std::uint64_t first = offset - offset % page;//expand to whole pages
+		const std::uint64_t last = bytes > fileBytes - offset ? fileBytes : offset + bytes;
+		char* const address = (char*)fileBuffer + first;
+		#if _MMAP_API_TYPE_ == _MMAP_WIN_//windows
+			return detail::prefetchVirtualMemory(address, last - first);
+		#elif _MMAP_API_TYPE_ == _MMAP_NIX_// *nix
+			return 0 == madvise(address, last - first, MADV_WILLNEED);
+		#endif
+	}
+
+	//@brief: tell the os part of the file isn't needed anymore so its pages can be dropped from this process (MADV_DONTNEED / VirtualUnlock)
+	//@param offset: offset of first byte to release
+	//@param bytes: number of bytes to release (clipped to the end of the file)
+	//@return: true if the request was accepted, false if it failed or isn't supported
+	bool File::release(const std::uint64_t offset, const std::uint64_t bytes) const {
+		if(offset >= fileBytes || 0 == bytes) return true;//nothing to do
+		const std::uint64_t page = detail::pageSize();
+		const std::uint64_t first = (offset + page - 1) / page * page;//shrink to whole pages
+		const std::uint64_t end = bytes > fileBytes - offset ? fileBytes : offset + bytes;
+		const std::uint64_t last = end == fileBytes ? end : end - end % page;//the partial page at the end of the file can be released
+		if(last <= first) return true;//no whole pages in range
+		char* const address = (char*)fileBuffer + first;
+		#if _MMAP_API_TYPE_ == _MMAP_WIN_//windows
+			VirtualUnlock(address, (SIZE_T)(last - first));//unlocking pages that aren't locked removes them from the working set (and reports ERROR_NOT_LOCKED)
+			return true;
+		#elif _MMAP_API_TYPE_ == _MMAP_NIX_// *nix
+			return 0 == madvise(address, last - first, MADV_DONTNEED);
+		#endif
+	}
+
+	//@brief: open a file and start reading it in the background
+	//@param filename: name of file to read
+	//@param blockBytes: size of each read (rounded up to a multiple of 4 KB)
+	//@param blockCount: number of buffers in the ring (at least 2, up to blockCount - 1 blocks are read ahead of the block being used)
+	//@param headroom: space reserved in front of each buffer for bytes carried over from the previous block (rounded up to a multiple of 4 KB)
+	ReadAheadFile::ReadAheadFile(std::string fileName, const size_t blockBytes, const size_t blockCount, const size_t headroom) :
+		name(fileName), blockBytes(std::max<size_t>(1, (blockBytes + 4095) / 4096) * 4096), headroom((headroom + 4095) / 4096 * 4096), fileBytes(0), total(0), filled(0), consumed(0), stop(false), fileHandle(NULL), fileId(-1) {
+		if(blockCount < 2) throw std::runtime_error("read ahead needs at least 2 buffers");
+
+		//open the file and get its size
+		#if _MMAP_API_TYPE_ == _MMAP_WIN_//windows
+			fileHandle = (HANDLE) CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN | FILE_FLAG_OVERLAPPED, NULL);
+			LARGE_INTEGER lInt;
+			if(INVALID_HANDLE_VALUE == fileHandle || 0 == GetFileSizeEx(fileHandle, &lInt)) {
+				const std::string message = detail::getErrorMessage();
+				if(INVALID_HANDLE_VALUE != fileHandle) CloseHandle(fileHandle);
+				throw std::runtime_error(fileName + " couldn't be opened: " + message);
+			}
+			fileBytes = (std::uint64_t)lInt.QuadPart;
+		#elif _MMAP_API_TYPE_ == _MMAP_NIX_// *nix
+			struct STAT fileStat;
+			fileId = open(fileName.c_str(), O_RDONLY);
+			if(-1 == fileId || -1 == FSTAT(fileId, &fileStat)) {
+				const std::string message = detail::getErrorMessage();
+				if(-1 != fileId) close(fileId);
+				throw std::runtime_error(fileName + " couldn't be opened: " + message);
+			}
+			fileBytes = fileStat.st_size;
+			#ifdef POSIX_FADV_SEQUENTIAL
+				posix_fadvise(fileId, 0, 0, POSIX_FADV_SEQUENTIAL);//let the os read ahead aggressively too
+			#endif
+		#endif
+
+		//carve page aligned buffers from a single allocation and start reading
+		this->blockBytes = (size_t)std::min<std::uint64_t>(this->blockBytes, (fileBytes + 4095) / 4096 * 4096 + 4096);//don't allocate more than needed for small files
+		total = (size_t)((fileBytes + this->blockBytes - 1) / this->blockBytes);
+		const size_t stride = this->headroom + this->blockBytes;
+		storage.reset(new char[blockCount * stride + 4096]);
+		char * const base = storage.get() + (4096 - (size_t)((std::uintptr_t)storage.get() % 4096)) % 4096;
+		for(size_t i = 0; i < blockCount; i++) blocks.push_back(Block{base + i * stride + this->headroom, 0});
+		reader = std::thread(&ReadAheadFile::readLoop, this);
+	}
+
+	//@brief: stop reading and close the file
+	ReadAheadFile::~ReadAheadFile() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stop = true;
+		}
+		changed.notify_all();
+		reader.join();
+		#if _MMAP_API_TYPE_ == _MMAP_WIN_//windows
+			CloseHandle(fileHandle);//close file
+		#elif _MMAP_API_TYPE_ == _MMAP_NIX_// *nix
+			close(fileId);//close file
+		#endif
+	}
+
+	//@brief: get the next block of the file (waiting for its read to finish if needed)
+	//@param keep: start of unused bytes at the end of the previous block to place directly in front of the next block (e.g. a partial line), or NULL
+	//@param bytes: location to write the size of the block (including kept bytes)
+	//@return: read only pointer to the block (valid until the next call), or NULL once the entire file has been returned (the previous block stays valid)
+	char const * ReadAheadFile::next(char const * keep, size_t& bytes) {
+		bytes = 0;
+		if(consumed == total) return NULL;//end of file
+
+		//get bytes to carry over from the block in use
+		size_t keepBytes = 0;
+		if(NULL != keep && consumed > 0) {
+			const Block& current = blocks[(consumed - 1) % blocks.size()];
+			if(keep < current.data - headroom || keep > current.data + current.bytes) throw std::logic_error("kept bytes must be inside the previous block");
+			keepBytes = current.data + current.bytes - keep;
+			if(keepBytes > headroom) throw std::runtime_error(name + " has a line longer than the read ahead headroom");
+		}
+
+		//wait for the next block, then copy carried over bytes in front of it and release the previous block
+		std::unique_lock<std::mutex> lock(mutex);
+		changed.wait(lock, [this](){return filled > consumed || !error.empty();});
+		if(!error.empty()) throw std::runtime_error(error);
+		const Block& block = blocks[consumed % blocks.size()];
+		if(keepBytes > 0) std::memmove(block.data - keepBytes, keep, keepBytes);//the previous block's buffer can't be refilled until consumed is incremented
+		bytes = block.bytes + keepBytes;
+		++consumed;
+		lock.unlock();
+		changed.notify_all();
+		return block.data - keepBytes;
+	}
+
+	//@brief: read blocks into the ring until the file ends or the reader is destroyed (run on the background thread)
+	void ReadAheadFile::readLoop() {
+		try {
+			for(size_t n = 0; n < total; n++) {
+				//wait for the buffer to be released (the block in use is consumed - 1)
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					changed.wait(lock, [&](){return stop || n + 1 < consumed + blocks.size();});
+					if(stop) return;
+				}
+
+				//fill the buffer without holding the lock
+				Block& block = blocks[n % blocks.size()];
+				const std::uint64_t offset = (std::uint64_t)n * blockBytes;
+				block.bytes = (size_t)std::min<std::uint64_t>(blockBytes, fileBytes - offset);
+				readAt(offset, block.data, block.bytes);
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					filled = n + 1;
+				}
+				changed.notify_all();
+			}
+		} catch (std::exception& e) {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				error = e.what();
+			}
+			changed.notify_all();
+		}
+	}
+
+	//@brief: read part of the file
+	//@param offset: offset of first byte to read
+	//@param buffer: location to read into
+	//@param bytes: number of bytes to read
+	void ReadAheadFile::readAt(const std::uint64_t offset, char * const buffer, const size_t bytes) {
+		size_t done = 0;
+		while(done < bytes) {
+			#if _MMAP_API_TYPE_ == _MMAP_WIN_//windows
+				OVERLAPPED overlapped = {};
+				const std::uint64_t position = offset + done;
+				overlapped.Offset     = (DWORD)(position & 0xFFFFFFFF);
+				overlapped.OffsetHigh = (DWORD)(position >> 32);
+				overlapped.hEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+				DWORD count = 0;
+				const DWORD request = (DWORD)std::min<size_t>(bytes - done, 1u << 30);
+				bool ok = 0 != ReadFile(fileHandle, buffer + done, request, NULL, &overlapped) || ERROR_IO_PENDING == GetLastError();
+				if(ok) ok = 0 != GetOverlappedResult(fileHandle, &overlapped, &count, TRUE);//wait for the overlapped read
+				CloseHandle(overlapped.hEvent);
+				if(!ok) throw std::runtime_error(name + " couldn't be read: " + detail::getErrorMessage());
+			#elif _MMAP_API_TYPE_ == _MMAP_NIX_// *nix
+				const ssize_t count = pread(fileId, buffer + done, bytes - done, (off_t)(offset + done));
+				if(count < 0) {
+					if(EINTR == errno) continue;
+					throw std::runtime_error(name + " couldn't be read: " + detail::getErrorMessage());
+				}
+			#endif
+			if(0 == count) throw std::runtime_error(name + " ended unexpectedly");
+			done += (size_t)count;
+		}
+	}
 }
 
 #endif//_mmap_h_
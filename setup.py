@@ -0,0 +1,12 @@
+#build the tsl python module from tsl_py.cpp (metadata is in pyproject.toml)
+#	pip install .
+#	python test_tsl.py
+
+import sys
+from setuptools import setup
+from pybind11.setup_helpers import Pybind11Extension, build_ext
+
+setup(
+	ext_modules = [Pybind11Extension('tsl', ['tsl_py.cpp'], cxx_std = 17, include_dirs = ['.'], extra_link_args = [] if 'win32' == sys.platform else ['-pthread'])],
+	cmdclass = {'build_ext': build_ext},
+)
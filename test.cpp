@@ -0,0 +1,705 @@
+//regression tests for the readers and scan kernels
+//build and run with e.g.:
+//	c++ -O2 -std=c++17 test.cpp -o test -pthread && ./test
+//add -DTSL_USE_ZSTD (and -lzstd) to cover the .ang.zst reader
+
+#include <iostream>
+#include <random>
+#include "tsl.hpp"
+
+//@brief: throw if a condition doesn't hold
+//@param pass: condition to check
+//@param what: description of the failure
+void check(const bool pass, const std::string& what) {
+	if(!pass) throw std::runtime_error(what);
+}
+
+//@brief: build a synthetic single phase scan with random orientations
+//@param cols: width of odd rows in pixels
+//@param rows: number of rows
+//@param hex: hexagonal grid (square otherwise)
+//@return: orientation map with every column filled
+tsl::OrientationMap synthetic(const size_t cols, const size_t rows, const bool hex) {
+	tsl::OrientationMap om;
+	om.pixPerUm = 1.0f;
+	om.xStar = 0.5f; om.yStar = 0.5f; om.zStar = 0.7f;
+	om.workingDistance = 15.0f;
+	om.xStep = 0.5f;
+	om.yStep = hex ? 0.433013f : 0.5f;
+	om.nColsOdd  = cols;
+	om.nColsEven = hex ? cols - 1 : cols;
+	om.nRows = rows;
+	om.operatorName = "test";
+	om.gridType = hex ? tsl::GridType::Hexagonal : tsl::GridType::Square;
+	tsl::Phase p = {};
+	p.num = 1;
+	p.name = "Nickel";
+	p.sym = 43;
+	om.phaseList.push_back(p);
+	om.allocate(10);
+
+	//fill rows in file order (each row is stored from its last column to its first)
+	std::mt19937 gen(0);
+	std::uniform_real_distribution<float> phi(0.0f, 6.283185f), Phi(0.0f, 3.141593f), unit(0.0f, 1.0f);
+	for(size_t r = 0; r < rows; r++) {
+		const float shift = hex && 1 == r % 2 ? 0.5f * om.xStep : 0.0f;
+		for(size_t c = 0; c < om.rowWidth(r); c++) {
+			const size_t i = om.index(r, c);
+			om.eu[3*i  ] = phi(gen);
+			om.eu[3*i+1] = Phi(gen);
+			om.eu[3*i+2] = phi(gen);
+			om.x  [i] = c * om.xStep + shift;
+			om.y  [i] = r * om.yStep;
+			om.iq [i] = unit(gen) * 3000;
+			om.ci [i] = unit(gen);
+			om.sem[i] = unit(gen) * 2000;
+			om.fit[i] = unit(gen) * 3;
+			om.phase[i] = 1;
+		}
+	}
+	return om;
+}
+
+//@brief: check that regions of hexagonal scans have the same neighbors as the full scan
+//@param dir: directory to write temporary files to
+void testRegionNeighbors(const std::filesystem::path& dir) {
+	const std::string fileName = (dir / "region.ang").string();
+	synthetic(24, 20, true).write(fileName);
+	tsl::OrientationMap full(fileName);
+	const tsl::NeighborMisorientation fullMis = tsl::neighborMisorientation(full);
+
+	const size_t x0 = 3, y0 = 4;
+	tsl::OrientationMap region;
+	region.readRegion(fileName, x0, y0, 12, 9);
+	const tsl::NeighborMisorientation regionMis = tsl::neighborMisorientation(region);
+	for(size_t r = 0; r < region.nRows; r++) {
+		for(size_t c = 0; c < region.rowWidth(r); c++) {
+			const size_t i = region.index(r, c), j = full.index(y0 + r, x0 + c);
+			check(region.eu[3*i] == full.eu[3*j], "region pixel doesn't match the full scan");
+			for(size_t k = 0; k < region.forwardNeighbors(); k++) {
+				const size_t n = region.forwardNeighbor(r, c, k);
+				if(SIZE_MAX == n) continue;
+				const size_t m = full.forwardNeighbor(y0 + r, x0 + c, k);
+				check(SIZE_MAX != m && region.eu[3*n] == full.eu[3*m], "region neighbor isn't the full scan neighbor");
+				check(regionMis(i, k) == fullMis(j, k), "region neighbor misorientation doesn't match the full scan");
+			}
+		}
+	}
+
+	//regions starting on a shifted row would have the wrong row offsets
+	bool threw = false;
+	try {
+		region.readRegion(fileName, x0, y0 + 1, 12, 9);
+	} catch (std::runtime_error&) {
+		threw = true;
+	}
+	check(threw, "hexagonal region starting on an even row was accepted");
+}
+
+//@brief: check that a moved from map can be read into again (readMany and vector growth leave moved from maps behind)
+//@param dir: directory to write temporary files to
+void testMovedFromRead(const std::filesystem::path& dir) {
+	const std::string fileName = (dir / "moved.ang").string();
+	synthetic(16, 12, false).write(fileName);
+	tsl::OrientationMap om(fileName);
+	tsl::OrientationMap moved(std::move(om));
+	om.read(fileName);
+	check(om.numPoints() == moved.numPoints() && om.ci == moved.ci, "rereading a moved from map didn't reproduce the scan");
+}
+
+//@brief: check that the number parsers handle values without digits and integer overflow
+//@param dir: directory to write temporary files to (unused)
+void testParseSpecialValues(const std::filesystem::path&) {
+	const std::string line = " nan -inf 0.25 18446744073709551616 7";
+	char const * p = line.data(), * const end = line.data() + line.size();
+	float a, b, c;
+	size_t big, small;
+	p = tsl::detail::parseFloat(p, end, a);
+	p = tsl::detail::parseFloat(p, end, b);
+	p = tsl::detail::parseFloat(p, end, c);
+	p = tsl::detail::parseUInt (p, end, big);
+	p = tsl::detail::parseUInt (p, end, small);
+	check(std::isnan(a) && std::isinf(b) && b < 0 && 0.25f == c, "nan / inf tokens weren't parsed");
+	check(SIZE_MAX == big && 7 == small && end == p, "overflowing integer didn't saturate");
+
+	//a rejected phase token is still consumed so the following columns stay aligned
+	const std::string rejected = " -1 2.5";
+	size_t phase;
+	float sem;
+	p = tsl::detail::parseUInt (rejected.data(), rejected.data() + rejected.size(), phase);
+	p = tsl::detail::parseFloat(p              , rejected.data() + rejected.size(), sem  );
+	check(0 == phase && 2.5f == sem, "rejected integer token wasn't consumed");
+}
+
+//@brief: check that the read ahead reader matches the memory mapped reader
+//@param dir: directory to write temporary files to
+void testBufferedRead(const std::filesystem::path& dir) {
+	const std::string fileName = (dir / "buffered.ang").string();
+	synthetic(40, 30, true).write(fileName);
+	tsl::OrientationMap mapped(fileName), buffered;
+	buffered.readBuffered(fileName);
+	check(mapped.eu == buffered.eu && mapped.ci == buffered.ci && mapped.phase == buffered.phase, "buffered read doesn't match the mapped read");
+}
+
+//@brief: check that columns survive a round trip through the tiled layout
+//@param dir: directory to write temporary files to (unused)
+void testTiledRoundTrip(const std::filesystem::path&) {
+	const tsl::OrientationMap om = synthetic(37, 29, true);
+	const tsl::TiledLayout layout(om, 8);
+	check(layout.numPoints() == om.numPoints(), "tiled layout has the wrong number of points");
+	const tsl::ScanVector<float> tiled = layout.toTiled(om.eu, 3, 2);
+	for(size_t r = 0; r < om.nRows; r++) {
+		for(size_t c = 0; c < om.rowWidth(r); c++) check(tiled[3 * layout.index(r, c)] == om.eu[3 * om.index(r, c)], "tiled pixel is in the wrong slot");
+	}
+	check(om.eu == layout.toScan(tiled, 3, 2), "tiled round trip doesn't reproduce the column");
+}
+
+//@brief: check that neighbor CI correlation moves every column of a cleaned pixel together
+//@param dir: directory to write temporary files to (unused)
+void testCiCorrelation(const std::filesystem::path&) {
+	tsl::OrientationMap om = synthetic(30, 20, true);
+	om.computeQuats(true);
+	const tsl::CleanupResult result = tsl::neighborCiCorrelation(om, 0.5f, 2);
+	check(result.changed > 0, "no pixels were cleaned");
+	tsl::OrientationMap expected = om;
+	expected.computeQuats(true);
+	check(expected.qu == om.qu, "cleaned quaternions don't match the cleaned euler angles");
+}
+
+//@brief: check that load statistics report the memory of the scan read, not memory left in a reused arena
+//@param dir: directory to write temporary files to
+void testPeakBytes(const std::filesystem::path& dir) {
+	const std::string bigName = (dir / "big.ang").string(), smallName = (dir / "small.ang").string();
+	synthetic(80, 60, false).write(bigName);
+	synthetic(10,  8, false).write(smallName);
+	tsl::OrientationMap om;
+	tsl::LoadStats big, small;
+	om.read(bigName  , 1, tsl::Column::All, &big  );
+	om.read(smallName, 1, tsl::Column::All, &small);
+	check(small.peakBytes < big.peakBytes && small.peakBytes >= om.numPoints() * (7 * sizeof(float) + sizeof(size_t)), "peak bytes don't match the scan read");
+}
+
+//@brief: check that a corrupt phase ID is rejected instead of sizing the symmetry table
+//@param dir: directory to write temporary files to (unused)
+void testCorruptPhase(const std::filesystem::path&) {
+	tsl::OrientationMap om = synthetic(12, 10, false);
+	om.phase[5] = 65535;
+	bool threw = false;
+	try {
+		tsl::neighborMisorientation(om);
+	} catch (std::runtime_error&) {
+		threw = true;
+	}
+	check(threw, "phase ID outside of the phase list was accepted");
+}
+
+//@brief: check that sidecars are matched by size and modification time and only checksummed on request
+//@param dir: directory to write temporary files to
+void testSidecarReopen(const std::filesystem::path& dir) {
+	const std::string fileName = (dir / "sidecar.ang").string(), sidecar = tsl::OrientationMap::SidecarName(fileName);
+	const tsl::OrientationMap reference = synthetic(30, 20, false);
+	reference.write(fileName);
+	reference.writeSidecar(fileName);
+	tsl::OrientationMap om;
+	tsl::LoadStats stats;
+	om.read(fileName, 1, tsl::Column::All, &stats);
+	check(stats.cached && reference.ci == om.ci, "up to date sidecar wasn't read");
+
+	//damage the last data byte: the fast path doesn't checksum but a verified view does
+	{
+		std::fstream fs(sidecar.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+		fs.seekp(-1, std::ios::end);
+		fs.put('\x7f');
+	}
+	om.read(fileName, 1, tsl::Column::All, &stats);
+	check(stats.cached, "sidecar wasn't read without verification");
+	bool threw = false;
+	try {
+		tsl::OrientationMapView view(fileName, true);
+	} catch (std::runtime_error&) {
+		threw = true;
+	}
+	check(threw, "verified view accepted a damaged sidecar");
+
+	//a changed source invalidates the sidecar
+	synthetic(31, 20, false).write(fileName);
+	om.read(fileName, 1, tsl::Column::All, &stats);
+	check(!stats.cached && 31 == om.nColsOdd, "stale sidecar was read");
+}
+
+//@brief: check that unverified views still reject column tables that don't fit the file
+//@param dir: directory to write temporary files to
+void testViewBounds(const std::filesystem::path& dir) {
+	const std::string fileName = (dir / "bounds.angb").string();
+	const tsl::OrientationMap om = synthetic(20, 16, false);
+	om.writeAngb(fileName);
+	std::ifstream is(fileName.c_str(), std::ios::in | std::ios::binary);
+	const std::string original((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+	is.close();
+	auto rejected = [&](const std::string& bytes) {
+		std::ofstream(fileName.c_str(), std::ios::out | std::ios::binary).write(bytes.data(), bytes.size());
+		try {
+			tsl::OrientationMapView view(fileName, false);
+		} catch (std::runtime_error&) {
+			return true;
+		}
+		return false;
+	};
+
+	//truncated file
+	check(rejected(original.substr(0, original.size() - 64)), "view of a truncated file was accepted");
+
+	//iq column longer than the others
+	tsl::detail::AngbEntry entry = {tsl::detail::AngbColumn::Iq, tsl::detail::AngbType::Float32, 0, om.numPoints()};
+	size_t pos = 0;
+	for(; pos + sizeof(entry) <= original.size(); pos++) {
+		std::memcpy(&entry.offset, original.data() + pos + 8, sizeof(entry.offset));
+		if(0 == std::memcmp(original.data() + pos, &entry, sizeof(entry))) break;
+	}
+	check(pos + sizeof(entry) <= original.size(), "couldn't find the iq column entry");
+	std::string longer = original;
+	++entry.count;
+	std::memcpy(&longer[pos], &entry, sizeof(entry));
+	check(rejected(longer), "view with mismatched column lengths was accepted");
+	check(!rejected(original), "view of an intact file was rejected");
+}
+
+//@brief: check that a shared arena reuses freed columns while others are live, and that map copies get their own arena
+//@param dir: directory to write temporary files to (unused)
+void testArenaReuse(const std::filesystem::path&) {
+	//a pinned column keeps the arena from ever being empty
+	tsl::ScanArena arena;
+	const tsl::ScanAllocator<float> alloc(arena);
+	tsl::ScanVector<float> pinned(alloc);
+	pinned.resize(1000);
+	for(size_t i = 0; i < 50; i++) {
+		tsl::ScanVector<float> v(alloc);
+		v.resize(100000);
+		check(std::all_of(v.begin(), v.end(), [](const float f){return 0.0f == f;}), "resize didn't value initialize recycled memory");
+		std::fill(v.begin(), v.end(), 1.0f);
+	}
+	check(arena.capacity() < 2 * 100000 * sizeof(float) + 64 * 1024, "freed columns weren't reused");
+	check(arena.used() == tsl::detail::arenaBytes(1000 * sizeof(float)), "freed columns are still counted as used");
+
+	//copies carve from their own arena
+	tsl::OrientationMap om = synthetic(16, 12, true);
+	const tsl::OrientationMap copy(om);
+	check(copy.eu == om.eu && copy.phase == om.phase && copy.nColsEven == om.nColsEven, "copy doesn't match the source");
+	check(copy.eu.get_allocator() == tsl::ScanAllocator<float>(copy.arena) && copy.eu.get_allocator() != om.eu.get_allocator(), "copy shares the source arena");
+	const size_t before = om.arena.capacity();
+	tsl::OrientationMap assigned;
+	assigned = om;
+	check(om.arena.capacity() == before && assigned.eu.get_allocator() == tsl::ScanAllocator<float>(assigned.arena), "assignment carved from the source arena");
+}
+
+//@brief: check that quantized columns stay within their stated precision and that narrow phases reject large IDs
+//@param dir: directory to write temporary files to (unused)
+void testQuantizeBounds(const std::filesystem::path&) {
+	tsl::OrientationMap om = synthetic(40, 30, true);
+	std::fill(om.sem.begin(), om.sem.end(), 7.25f);//constant column (zero step)
+	const tsl::CompactOrientationMap<> compact(om);
+	auto within = [](const tsl::QuantizedColumn& q, const tsl::ScanVector<float>& v) {
+		const float bound = q.maxError() + 4 * FLT_EPSILON * std::max(std::fabs(q.offset), std::fabs(q.offset + 65535 * q.step));
+		for(size_t i = 0; i < v.size(); i++) {
+			if(!(std::fabs(q[i] - v[i]) <= bound)) return false;
+		}
+		return q.size() == v.size();
+	};
+	check(within(compact.iq, om.iq) && within(compact.ci, om.ci) && within(compact.fit, om.fit), "quantized value outside of maxError");
+	check(0.0f == compact.sem.maxError() && 7.25f == compact.sem[0], "constant column isn't exact");
+	check(1.0f / 131070 >= compact.ci.maxError(), "ci precision is worse than documented");
+	const tsl::OrientationMap expanded = compact.expand();
+	check(expanded.eu == om.eu && expanded.phase == om.phase && within(compact.ci, expanded.ci), "expanded map doesn't match");
+
+	//phases that don't fit the storage type
+	om.phase[3] = 300;
+	om.phaseList.resize(300);
+	bool threw = false;
+	try {
+		tsl::CompactOrientationMap<std::uint8_t> narrow(om);
+	} catch (std::runtime_error&) {
+		threw = true;
+	}
+	check(threw, "phase ID that doesn't fit in 8 bits was truncated");
+	check(300 == tsl::CompactOrientationMap<std::uint16_t>(om).phase[3], "phase ID that fits in 16 bits was changed");
+}
+
+//@brief: check that segmentation finds two halves of a hexagonal scan regardless of the thread count
+//@param dir: directory to write temporary files to (unused)
+void testSegmentation(const std::filesystem::path&) {
+	//left half and right half have orientations 30 degrees apart about z
+	tsl::OrientationMap om = synthetic(41, 33, true);
+	for(size_t r = 0; r < om.nRows; r++) {
+		for(size_t c = 0; c < om.rowWidth(r); c++) {
+			const size_t i = om.index(r, c);
+			om.eu[3*i  ] = c < 20 ? 0.2f : 0.2f + 0.5236f;
+			om.eu[3*i+1] = 0.3f;
+			om.eu[3*i+2] = 0.1f;
+			om.ci[i] = 0.8f;
+		}
+	}
+	const size_t lowCi = om.index(10, 5);
+	om.ci[lowCi] = 0.01f;
+
+	const tsl::GrainMap single = tsl::segmentGrains(om, 0.0873f, 0.1f, 1);
+	check(3 == single.grains.size(), "expected two grains and the unsegmented pixels");
+	check(0 == single.ids[lowCi] && 1 == single.grains[0].pixels, "low ci pixel was segmented");
+	check(single.ids[om.index(0, 0)] != single.ids[om.index(0, 40)] && single.ids[om.index(0, 0)] == single.ids[om.index(32, 19)], "halves weren't separated along the boundary");
+	check(single.grains[1].pixels + single.grains[2].pixels + 1 == om.numPoints(), "grain pixel counts don't cover the scan");
+	const tsl::GrainMap parallel = tsl::segmentGrains(om, 0.0873f, 0.1f, 4);
+	check(single.ids == parallel.ids, "grain IDs depend on the thread count");
+}
+
+//@brief: check that hex to square resampling picks the nearest source pixel and caches its index table
+//@param dir: directory to write temporary files to (unused)
+void testResampling(const std::filesystem::path&) {
+	const tsl::OrientationMap om = synthetic(21, 15, true);
+	const tsl::OrientationMap sq = tsl::resampleSquare(om, 0.25f);
+	check(tsl::GridType::Square == sq.gridType && sq.numPoints() == sq.ci.size() && 0.25f == sq.xStep, "resampled header is wrong");
+
+	//compare against a brute force nearest neighbor search (ties may go either way)
+	for(size_t r = 0; r < sq.nRows; r++) {
+		for(size_t c = 0; c < sq.nColsOdd; c++) {
+			const size_t i = sq.index(r, c);
+			const float px = c * sq.xStep, py = r * sq.yStep;
+			check(std::fabs(sq.x[i] - px) < 1e-4f && std::fabs(sq.y[i] - py) < 1e-4f, "resampled coordinates are wrong");
+			float best = std::numeric_limits<float>::infinity(), chosen = best;
+			for(size_t j = 0; j < om.numPoints(); j++) {
+				const float d = (om.x[j] - px) * (om.x[j] - px) + (om.y[j] - py) * (om.y[j] - py);
+				best = std::min(best, d);
+				if(om.ci[j] == sq.ci[i] && om.eu[3*j] == sq.eu[3*i] && om.phase[j] == sq.phase[i]) chosen = std::min(chosen, d);
+			}
+			check(chosen <= best + 1e-5f, "resampled pixel isn't the nearest source pixel");
+		}
+	}
+
+	//tables are cached per geometry and resampling doesn't depend on the thread count
+	check(tsl::SquareResampler::Get(om, 0.25f) == tsl::SquareResampler::Get(om, 0.25f), "index table wasn't cached");
+	const tsl::OrientationMap parallel = tsl::SquareResampler::Get(om, 0.25f)->resample(om, 4);
+	check(parallel.eu == sq.eu && parallel.ci == sq.ci && parallel.phase == sq.phase, "resampling depends on the thread count");
+}
+
+//@brief: check that the tailing reader parses a file written in pieces (including split lines) the same as a full read
+//@param dir: directory to write temporary files to
+void testTailReader(const std::filesystem::path& dir) {
+	const std::string fullName = (dir / "tail_full.ang").string(), fileName = (dir / "tail.ang").string();
+	synthetic(15, 12, true).write(fullName);
+	const tsl::OrientationMap reference(fullName);
+	std::ifstream is(fullName.c_str(), std::ios::in | std::ios::binary);
+	const std::string text((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+	const size_t dataStart = text.find("\n#\n", text.find("# SCANID")) + 3;
+
+	//write the file in pieces: part of the header, then data split mid line
+	std::ofstream os(fileName.c_str(), std::ios::out | std::ios::binary);
+	os.write(text.data(), dataStart / 2);
+	os.flush();
+	tsl::AngTailReader tail(fileName, 2);
+	check(0 == tail.refresh() && !tail.ready(), "partial header was parsed");
+	size_t written = dataStart / 2, lines = 0;
+	for(const size_t piece : {dataStart - dataStart / 2 + 500, size_t(1234), size_t(1), size_t(4000)}) {
+		os.write(text.data() + written, piece);
+		os.flush();
+		written += piece;
+		tail.refresh();
+		lines = (size_t)std::count(text.begin() + dataStart, text.begin() + written, '\n');
+		check(tail.ready() && lines == tail.pointsRead(), "refresh didn't parse exactly the complete lines");
+	}
+	for(size_t i = 0; i < tail.pointsRead(); i++) {//points are in file order, map them back to rows
+		size_t r = 0, n = i;
+		while(n >= reference.rowWidth(r)) n -= reference.rowWidth(r++);
+		const size_t j = reference.index(r, n);
+		check(tail.map().ci[j] == reference.ci[j] && tail.map().phase[j] == reference.phase[j], "partial scan doesn't match the full read");
+	}
+	os.write(text.data() + written, text.size() - written);
+	os.close();
+	tail.refresh(true);
+	check(tail.complete() && tail.map().eu == reference.eu && tail.map().ci == reference.ci, "tailed scan doesn't match the full read");
+}
+
+//@brief: check that pixel selection and compaction match a per pixel loop
+//@param dir: directory to write temporary files to (unused)
+void testFiltering(const std::filesystem::path&) {
+	tsl::OrientationMap om = synthetic(37, 29, true);
+	om.phaseList.push_back(om.phaseList.front());
+	om.phaseList.back().num = 2;
+	for(size_t i = 0; i < om.numPoints(); i += 3) om.phase[i] = 2;
+
+	const tsl::PixelFilter filter(0.3f, 500.0f, {1});
+	std::vector<size_t> expected;
+	for(size_t i = 0; i < om.numPoints(); i++) {
+		if(om.ci[i] >= 0.3f && om.iq[i] >= 500.0f && 1 == om.phase[i]) expected.push_back(i);
+	}
+	const tsl::PixelMask mask = om.select(filter, 1);
+	check(mask.points == om.numPoints() && mask.selected == expected.size() && mask.indices() == expected, "selected pixels don't match the filter");
+	check(0 == (mask.bits.back() >> (om.numPoints() % 64)), "unused mask bits are set");
+	check(mask.bits == om.select(filter, 4).bits && mask.indices(4) == expected, "selection depends on the thread count");
+
+	const tsl::ScanSelection sel = om.compact(mask, 4);
+	check(sel.size() == expected.size() && sel.index == expected, "compacted indices don't match the mask");
+	for(size_t k = 0; k < sel.size(); k++) {
+		const size_t i = expected[k];
+		check(sel.ci[k] == om.ci[i] && sel.phase[k] == om.phase[i] && sel.eu[3*k+2] == om.eu[3*i+2] && sel.x[k] == om.x[i], "compacted columns don't match the source pixels");
+	}
+}
+
+//@brief: check that a throwing progress callback is rethrown to the caller of a multi-threaded read
+//@param dir: directory to write temporary files to
+void testProgressThrow(const std::filesystem::path& dir) {
+	const std::string fileName = (dir / "progress.ang").string();
+	synthetic(300, 200, false).write(fileName);//large enough to be split between threads
+	tsl::OrientationMap om;
+	tsl::LoadStats stats;
+	stats.progressRows = 1;
+	std::atomic<size_t> calls(0);
+	stats.progress = [&calls](const size_t rowsRead, const size_t) {
+		++calls;
+		if(rowsRead >= 20) throw std::runtime_error("cancelled by callback");
+	};
+	bool threw = false;
+	try {
+		om.read(fileName, 4, tsl::Column::All, &stats);
+	} catch (std::runtime_error& e) {
+		threw = std::string("cancelled by callback") == e.what();
+	}
+	check(threw, "callback exception wasn't rethrown by read");
+	check(calls < 200, "parsing continued after the callback threw");
+
+	//the same statistics work once the callback stops throwing
+	size_t last = 0;
+	stats.progress = [&last](const size_t rowsRead, const size_t) {last = rowsRead;};
+	om.read(fileName, 4, tsl::Column::All, &stats);
+	check(200 == last, "progress didn't reach the final row");
+}
+
+//@brief: check that grain cleanups reject grain IDs outside of the grain list
+//@param dir: directory to write temporary files to (unused)
+void testGrainIdBounds(const std::filesystem::path&) {
+	tsl::OrientationMap om = synthetic(20, 16, false);
+	tsl::GrainMap grains = tsl::segmentGrains(om, 0.1f, 0.0f);
+	tsl::standardizeCi(om, grains);//valid map
+	grains.ids[7] = (std::uint32_t)grains.grains.size();
+	auto throws = [](const std::function<void()>& f) {
+		try {
+			f();
+		} catch (std::runtime_error&) {
+			return true;
+		}
+		return false;
+	};
+	check(throws([&](){tsl::standardizeCi(om, grains, 4);}), "standardizeCi accepted a grain ID outside of the grain list");
+	check(throws([&](){tsl::dilateGrains(om, grains, 2, 1, 1);}), "dilateGrains accepted a grain ID outside of the grain list");
+}
+
+//@brief: check that streamed montage tiles land on their grid positions and that overlapping tiles don't mix pixels
+//@param dir: directory to write temporary files to
+void testMontage(const std::filesystem::path& dir) {
+	//three tiles: b overlaps a, c sits below both
+	std::vector<tsl::OrientationMap> tiles = {synthetic(30, 20, false), synthetic(30, 20, false), synthetic(25, 10, false)};
+	const std::vector<tsl::MontageTile> at = {{0.0f, 0.0f}, {10.0f, 5.0f}, {0.0f, 15.0f}};
+	std::vector<std::string> fileNames;
+	std::vector<tsl::ScanHeader> headers;
+	for(size_t t = 0; t < tiles.size(); t++) {
+		std::fill(tiles[t].ci.begin(), tiles[t].ci.end(), 0.25f * (t + 1));
+		fileNames.push_back((dir / ("tile" + std::to_string(t) + ".ang")).string());
+		tiles[t].write(fileNames.back());
+		headers.push_back(tiles[t]);
+	}
+	const tsl::ScanHeader header = tsl::MontageBuilder::Layout(headers, at);
+	check(50 == header.nColsOdd && 40 == header.nRows, "montage layout has the wrong size");
+
+	for(const bool stream : {true, false}) {
+		tsl::MontageBuilder builder(header);
+		builder.placeFiles(fileNames, at, 3, stream);
+		const tsl::OrientationMap& om = builder.map();
+		for(size_t r = 0; r < om.nRows; r++) {
+			for(size_t c = 0; c < om.nColsOdd; c++) {
+				const size_t i = om.index(r, c);
+				bool matched = false, covered = false;
+				for(size_t t = 0; t < tiles.size(); t++) {//the pixel must be a complete copy of one tile covering it
+					const size_t col0 = (size_t)(at[t].x / 0.5f), row0 = (size_t)(at[t].y / 0.5f);
+					if(r < row0 || c < col0 || r >= row0 + tiles[t].nRows || c >= col0 + tiles[t].nColsOdd) continue;
+					covered = true;
+					const size_t j = tiles[t].index(r - row0, c - col0);
+					matched |= om.ci[i] == tiles[t].ci[j] && om.eu[3*i] == tiles[t].eu[3*j] && om.iq[i] == tiles[t].iq[j] && std::fabs(om.x[i] - 0.5f * c) < 1e-3f;
+				}
+				check(covered ? matched : 0.0f == om.ci[i] && 0 == om.phase[i], "montage pixel doesn't match a tile covering it");
+			}
+		}
+	}
+
+	//hexagonal tiles must start on an even row index
+	tsl::ScanHeader hex = synthetic(10, 6, true);
+	bool threw = false;
+	try {
+		tsl::MontageBuilder::Layout({hex}, {{0.0f, hex.yStep}});
+	} catch (std::runtime_error& e) {
+		threw = std::string(e.what()).find("even row index") != std::string::npos;
+	}
+	check(threw, "hexagonal tile on an odd row index was accepted");
+}
+
+//@brief: check that a validating read reports each kind of bad line at its offset, independent of the thread count
+//@param dir: directory to write temporary files to
+void testReadValidated(const std::filesystem::path& dir) {
+	//split a scan large enough for several chunks into header and data lines
+	const std::string fileName = (dir / "validate.ang").string();
+	synthetic(300, 200, false).write(fileName);
+	std::ifstream is(fileName.c_str(), std::ios::in | std::ios::binary);
+	const std::string text((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+	is.close();
+	const size_t dataStart = text.find("\n#\n", text.find("# SCANID")) + 3;
+	std::vector<std::string> lines;
+	for(size_t p = dataStart; p < text.size(); ) {
+		const size_t e = text.find('\n', p);
+		lines.push_back(text.substr(p, e - p));
+		p = e + 1;
+	}
+	auto setToken = [](std::string& line, const size_t k, const std::string& value, const size_t keep = SIZE_MAX) {//replace the k-th token of a line and drop tokens past keep
+		std::istringstream ss(line);
+		std::vector<std::string> tokens((std::istream_iterator<std::string>(ss)), std::istream_iterator<std::string>());
+		tokens[k] = value;
+		tokens.resize(std::min(keep, tokens.size()));
+		line.clear();
+		for(const std::string& t : tokens) line += ' ' + t;
+	};
+
+	//one line of each problem, spread over the file so different threads find them
+	const size_t shortLine = 150, phaseLine = 21000, eulerLine = 33333, positionLine = 47001;
+	setToken(lines[shortLine], 0, "1.0", 6);//missing ci and everything after
+	setToken(lines[phaseLine], 7, "5");
+	setToken(lines[eulerLine], 0, "7.5");
+	setToken(lines[positionLine], 3, std::to_string(0.5f * (positionLine % 300) + 0.3f));
+	lines.resize(lines.size() - 3);//drop the last 3 points and end the file part way through the new last line
+	setToken(lines.back(), 6, "0.3", 7);
+	std::string damaged = text.substr(0, dataStart);
+	std::vector<std::uint64_t> offsets;
+	for(size_t i = 0; i < lines.size(); i++) {
+		offsets.push_back(damaged.size());
+		damaged += lines[i];
+		if(i + 1 < lines.size()) damaged += '\n';//no trailing newline after the truncated line
+	}
+	std::ofstream(fileName.c_str(), std::ios::out | std::ios::binary).write(damaged.data(), damaged.size());
+
+	//check counts and line positions
+	tsl::OrientationMap single, parallel;
+	const tsl::ValidationReport report = single.readValidated(fileName, 1);
+	check(60000 == report.pointsExpected && lines.size() == report.pointsRead && report.truncated(), "validated point counts are wrong");
+	check(5 == report.badLines && 2 == report.tokenLines && 1 == report.phaseLines && 1 == report.eulerLines && 1 == report.positionLines && 0 == report.numberLines, "validated problem counts are wrong");
+	const std::vector<std::pair<size_t, tsl::LineProblem> > expected = {
+		{shortLine       , tsl::LineProblem::Tokens  },
+		{phaseLine       , tsl::LineProblem::Phase   },
+		{eulerLine       , tsl::LineProblem::Euler   },
+		{positionLine    , tsl::LineProblem::Position},
+		{lines.size() - 1, tsl::LineProblem::Tokens  },
+	};
+	check(expected.size() == report.lines.size(), "wrong number of bad lines recorded");
+	for(size_t i = 0; i < expected.size(); i++) {
+		const tsl::BadLine& bad = report.lines[i];
+		check(expected[i].first == bad.line && expected[i].second == bad.problems && offsets[bad.line] == bad.offset, "bad line has the wrong index, problem, or offset");
+	}
+
+	//threads only change how the work is split
+	const tsl::ValidationReport threaded = parallel.readValidated(fileName, 4);
+	bool same = report.pointsRead == threaded.pointsRead && report.badLines == threaded.badLines && report.lines.size() == threaded.lines.size();
+	for(size_t i = 0; same && i < report.lines.size(); i++) same = report.lines[i].line == threaded.lines[i].line && report.lines[i].offset == threaded.lines[i].offset && report.lines[i].problems == threaded.lines[i].problems;
+	check(same && single.eu == parallel.eu && single.phase == parallel.phase, "validation depends on the thread count");
+}
+
+#ifdef TSL_USE_ZSTD
+//@brief: compress a file into one or more zstd frames
+//@param src: file to compress
+//@param dst: file to write
+//@param frameBytes: uncompressed bytes per frame
+//@param sized: true to record the content size in each frame header
+void compressZstd(const std::string& src, const std::string& dst, const size_t frameBytes, const bool sized) {
+	std::ifstream is(src.c_str(), std::ios::in | std::ios::binary);
+	const std::string data((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+	std::unique_ptr<ZSTD_CCtx, size_t(*)(ZSTD_CCtx*)> ctx(ZSTD_createCCtx(), ZSTD_freeCCtx);
+	ZSTD_CCtx_setParameter(ctx.get(), ZSTD_c_contentSizeFlag, sized ? 1 : 0);
+	ZSTD_CCtx_setParameter(ctx.get(), ZSTD_c_checksumFlag, 1);
+	std::ofstream os(dst.c_str(), std::ios::out | std::ios::binary);
+	std::vector<char> frame;
+	for(size_t i = 0; i < data.size(); i += frameBytes) {
+		const size_t n = std::min(frameBytes, data.size() - i);
+		frame.resize(ZSTD_compressBound(n));
+		const size_t bytes = ZSTD_compress2(ctx.get(), frame.data(), frame.size(), data.data() + i, n);
+		check(!ZSTD_isError(bytes), "couldn't compress test file");
+		os.write(frame.data(), bytes);
+	}
+}
+
+//@brief: check that .ang.zst files decompress to the original bytes in bounded blocks and read the same as the .ang
+//@param dir: directory to write temporary files to
+void testZstdRoundTrip(const std::filesystem::path& dir) {
+	const std::string fileName = (dir / "zstd.ang").string(), zstName = fileName + ".zst";
+	synthetic(60, 50, true).write(fileName);
+	std::ifstream is(fileName.c_str(), std::ios::in | std::ios::binary);
+	const std::string original((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+	const tsl::OrientationMap reference(fileName);
+
+	struct Case {size_t frameBytes; bool sized;};
+	for(const Case& c : {Case{SIZE_MAX, true}, Case{SIZE_MAX, false}, Case{20000, true}, Case{20000, false}}) {
+		compressZstd(fileName, zstName, c.frameBytes, c.sized);
+
+		//decompress in small blocks (frames span several blocks)
+		const size_t blockBytes = 4096;
+		tsl::detail::Decompressor decompressor(zstName, 4, blockBytes);
+		std::string decompressed;
+		size_t bytes;
+		for(char const * block = decompressor.next(NULL, bytes); NULL != block; block = decompressor.next(NULL, bytes)) {
+			check(bytes <= blockBytes, "decompressed block is larger than the block size");
+			decompressed.append(block, bytes);
+		}
+		check(original == decompressed, "decompressed zstd file doesn't match the original");
+
+		//read through the parser
+		tsl::OrientationMap om;
+		om.read(zstName, 4);
+		check(reference.eu == om.eu && reference.ci == om.ci && reference.phase == om.phase, ".ang.zst read doesn't match the .ang read");
+	}
+}
+#endif
+
+int main() {
+	const std::filesystem::path dir = std::filesystem::temp_directory_path() / "tsl_test";
+	std::filesystem::create_directories(dir);
+
+	//run every test, reporting failures instead of stopping at the first
+	const std::vector<std::pair<std::string, void(*)(const std::filesystem::path&)> > tests = {
+		{"region neighbors"     , testRegionNeighbors   },
+		{"moved from read"      , testMovedFromRead     },
+		{"parse special values" , testParseSpecialValues},
+		{"buffered read"        , testBufferedRead      },
+		{"tiled round trip"     , testTiledRoundTrip    },
+		{"ci correlation"       , testCiCorrelation     },
+		{"peak bytes"           , testPeakBytes         },
+		{"corrupt phase"        , testCorruptPhase      },
+		{"sidecar reopen"       , testSidecarReopen     },
+		{"view bounds"          , testViewBounds        },
+		{"arena reuse"          , testArenaReuse        },
+		{"quantize bounds"      , testQuantizeBounds    },
+		{"segmentation"         , testSegmentation      },
+		{"resampling"           , testResampling        },
+		{"tail reader"          , testTailReader        },
+		{"filtering"            , testFiltering         },
+		{"progress throw"       , testProgressThrow     },
+		{"grain id bounds"      , testGrainIdBounds     },
+		{"montage"              , testMontage           },
+		{"read validated"       , testReadValidated     },
+	#ifdef TSL_USE_ZSTD
+		{"zstd round trip"      , testZstdRoundTrip     },
+	#endif
+	};
+	size_t failed = 0;
+	for(const auto& t : tests) {
+		try {
+			t.second(dir);
+			std::cout << "pass: " << t.first << '\n';
+		} catch (std::exception& e) {
+			std::cout << "FAIL: " << t.first << " (" << e.what() << ")\n";
+			++failed;
+		}
+	}
+	std::filesystem::remove_all(dir);
+	return 0 == failed ? 0 : 1;
+}
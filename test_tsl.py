@@ -0,0 +1,154 @@
+#smoke test for the python bindings (build them first with 'pip install .')
+#	python test_tsl.py
+
+import gc
+import os
+import sys
+import tempfile
+import threading
+import time
+import unittest
+
+import numpy as np
+import tsl
+
+#@brief: write a single phase ang file
+#@param fileName: file to write
+#@param cols: width of odd rows in pixels
+#@param rows: number of rows
+#@param hex: hexagonal grid (square otherwise)
+#@return: dict of expected values for each (row, col in file order): 'eu' triples and 'ci'
+def writeAng(fileName, cols, rows, hex = False):
+	nEven = cols - 1 if hex else cols
+	header = [
+		'# TEM_PIXperUM          1.000000',
+		'# x-star                0.512300',
+		'# y-star                0.471100',
+		'# z-star                0.680000',
+		'# WorkingDistance       15.000000',
+		'#',
+		'# Phase 1',
+		'# MaterialName  \tNickel',
+		'# Formula     \tNi',
+		'# Info \t\t',
+		'# Symmetry              43',
+		'# LatticeConstants      3.520 3.520 3.520  90.000  90.000  90.000',
+		'# NumberFamilies        1',
+		'# hklFamilies   \t 1  1  1 1 100.000000 1',
+	] + ['# ElasticConstants \t0.000000 0.000000 0.000000 0.000000 0.000000 0.000000'] * 6 + [
+		'# Categories0 0 0 0 0 ',
+		'#',
+		'# GRID: ' + ('HexGrid' if hex else 'SqrGrid'),
+		'# XSTEP: 0.5',
+		'# YSTEP: ' + ('0.433013' if hex else '0.5'),
+		'# NCOLS_ODD: %d' % cols,
+		'# NCOLS_EVEN: %d' % nEven,
+		'# NROWS: %d' % rows,
+		'#',
+		'# OPERATOR: \ttest',
+		'#',
+		'# SAMPLEID: \t',
+		'#',
+		'# SCANID: \t',
+		'#',
+	]
+	expected = {'eu': {}, 'ci': {}}
+	lines = []
+	for r in range(rows):
+		for c in range(nEven if 1 == r % 2 else cols):
+			n = r * cols + c
+			eu = ('%.4f' % (n * 0.001), '%.4f' % (1 + n * 0.0001), '%.4f' % (2 + n * 0.002))
+			ci = '%.3f' % ((n % 1000) * 0.001)
+			x = (c + (0.5 if hex and 1 == r % 2 else 0)) * 0.5
+			lines.append('%s %s %s %.5f %.5f 100.0 %s 1' % (eu + (x, r * 0.5, ci)))
+			expected['eu'][(r, c)] = np.array(eu, dtype = np.float32)
+			expected['ci'][(r, c)] = np.float32(ci)
+	with open(fileName, 'w') as f:
+		f.write('\n'.join(header + lines) + '\n')
+	return expected
+
+class TestBindings(unittest.TestCase):
+	@classmethod
+	def setUpClass(cls):
+		cls.dir = tempfile.TemporaryDirectory()
+		cls.square = os.path.join(cls.dir.name, 'square.ang')
+		cls.hex = os.path.join(cls.dir.name, 'hex.ang')
+		cls.big = os.path.join(cls.dir.name, 'big.ang')
+		cls.expected = writeAng(cls.square, 7, 5)
+		cls.expectedHex = writeAng(cls.hex, 6, 5, True)
+		writeAng(cls.big, 400, 300)
+
+	@classmethod
+	def tearDownClass(cls):
+		cls.dir.cleanup()
+
+	#columns have the scan shape and hold the parsed values at index(row, col)
+	def testColumns(self):
+		for name, expected in ((self.square, self.expected), (self.hex, self.expectedHex)):
+			om = tsl.read(name)
+			self.assertEqual(om.num_points, len(expected['ci']))
+			self.assertEqual(om.eu.shape, (om.num_points, 3))
+			self.assertEqual(om.ci.shape, (om.num_points,))
+			self.assertEqual(om.ci.dtype, np.float32)
+			self.assertEqual(om.phases[0].symmetry, 43)
+			for (r, c), ci in expected['ci'].items():
+				i = om.index(r, c)
+				self.assertEqual(om.ci[i], ci)
+				np.testing.assert_array_equal(om.eu[i], expected['eu'][(r, c)])
+
+	#columns that weren't requested are None
+	def testColumnSelection(self):
+		om = tsl.read(self.square, columns = tsl.Column.Eu | tsl.Column.Ci)
+		self.assertIsNone(om.iq)
+		self.assertIsNotNone(om.ci)
+
+	#images of square scans are oriented by (row, col in file order) despite the reversed row storage
+	def testImage(self):
+		om = tsl.read(self.square)
+		ci, eu = om.image('ci'), om.image('eu')
+		self.assertEqual(ci.shape, (5, 7))
+		self.assertEqual(eu.shape, (5, 7, 3))
+		for r in range(5):
+			for c in range(7):
+				self.assertEqual(ci[r, c], om.ci[om.index(r, c)])
+				np.testing.assert_array_equal(eu[r, c], om.eu[om.index(r, c)])
+		with self.assertRaises(RuntimeError):
+			tsl.read(self.hex).image('ci')
+
+	#arrays share the map's memory and keep it alive after the map is dropped
+	def testZeroCopyLifetime(self):
+		om = tsl.read(self.square)
+		ci = om.ci
+		self.assertFalse(ci.flags.owndata)
+		self.assertTrue(np.shares_memory(ci, om.ci))
+		image = om.image('ci')
+		del om
+		gc.collect()
+		for (r, c), value in self.expected['ci'].items():
+			self.assertEqual(image[r, c], value)
+		self.assertEqual(sorted(ci.tolist()), sorted(float(v) for v in self.expected['ci'].values()))
+
+	#other python threads run while a scan is parsed
+	def testGilReleased(self):
+		count = [0]
+		done = threading.Event()
+		def spin():
+			while not done.is_set():
+				count[0] += 1
+				time.sleep(0)
+		interval = sys.getswitchinterval()
+		sys.setswitchinterval(60)#python threads only switch when the GIL is released
+		try:
+			worker = threading.Thread(target = spin)
+			worker.start()
+			before = count[0]
+			tsl.read(self.big, threads = 1)
+			during = count[0] - before
+		finally:
+			done.set()
+			sys.setswitchinterval(interval)
+			worker.join()
+		self.assertGreater(during, 0)
+
+if __name__ == '__main__':
+	unittest.main()
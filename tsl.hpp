@@ -41,8 +41,62 @@
 #include <fstream>
 #include <cmath>
 #include <algorithm>
+#include <numeric>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+#include <cfloat>
+#include <filesystem>
+#include <memory>
+#include <functional>
+#include <charconv>
+#include <string_view>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <chrono>
+#include <map>
+
+//the fast number parser can use SSE2/AVX2 to skip whitespace, this block handles the includes / #defines to select instructions at compile time
+#define _TSL_SIMD_NONE_ 0
+#define _TSL_SIMD_SSE2_ 1
+#define _TSL_SIMD_AVX2_ 2
+#if defined(__AVX2__)
+	#define _TSL_SIMD_TYPE_ _TSL_SIMD_AVX2_
+	#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define _TSL_SIMD_TYPE_ _TSL_SIMD_SSE2_
+	#include <emmintrin.h>
+#else
+	#define _TSL_SIMD_TYPE_ _TSL_SIMD_NONE_
+#endif
+#ifdef _MSC_VER
+	#include <intrin.h>//_BitScanForward
+#endif
+
+//define TSL_USE_STRTOF before including this file to parse numbers with strtof/strtoul instead of the fast fixed format parser
+
+//define TSL_USE_HDF5 before including this file (and link against libhdf5) to read EDAX hdf5 (.h5/.hdf5) files
+#ifdef TSL_USE_HDF5
+	#include <hdf5.h>
+#endif
+
+//define TSL_USE_ZLIB and/or TSL_USE_ZSTD before including this file (and link against libz / libzstd) to read compressed (.ang.gz / .ang.zst) files directly
+#ifdef TSL_USE_ZLIB
+	#include <zlib.h>
+#endif
+#ifdef TSL_USE_ZSTD
+	#include <zstd.h>
+#endif
 
 #include "mmap.hpp"
+#if _MMAP_API_TYPE_ == _MMAP_NIX_
+	#include <sys/resource.h>//getrusage (page fault counts for load statistics)
+#endif
 
 namespace tsl {
 	struct HKLFamily {
@@ -79,204 +133,5257 @@ namespace tsl {
 	//@return: stream written to
 	std::ostream& operator<<(std::ostream& os, const GridType& grid);
 
+	//enumeration of laue groups (proper rotation subgroup in parenthesis)
+	enum class LaueGroup {
+		Triclinic     ,//-1     (1  ), tsl symmetry 1
+		Monoclinic    ,//2/m    (2  ), tsl symmetry 2 (2 fold about y)
+		Orthorhombic  ,//mmm    (222), tsl symmetry 22
+		TetragonalLow ,//4/m    (4  ), tsl symmetry 4
+		TetragonalHigh,//4/mmm  (422), tsl symmetry 42
+		TrigonalLow   ,//-3     (3  ), tsl symmetry 3
+		TrigonalHigh  ,//-3m    (32 ), tsl symmetry 32
+		HexagonalLow  ,//6/m    (6  ), tsl symmetry 6
+		HexagonalHigh ,//6/mmm  (622), tsl symmetry 62
+		CubicLow      ,//m-3    (23 ), tsl symmetry 23
+		CubicHigh      //m-3m   (432), tsl symmetry 43
+	};
+
+	//@brief: get the laue group of a tsl symmetry number
+	//@param sym: tsl symmetry number (Phase::sym)
+	//@return: laue group (throws for unknown symmetries)
+	LaueGroup laueGroup(const std::uint32_t sym);
+
 	//enumeration of file types
-	enum class FileType {Unknown, Ang, Osc, Hdf};
+	enum class FileType {Unknown, Ang, Osc, Hdf, Angb, AngGz, AngZst};
 
 	//@brief: get the type of a file
 	//@param fileName: name to parse extension from
 	//@return: parsed extension
 	FileType getFileType(std::string fileName);
 
-	class OrientationMap {
+	//bit flags for selecting scan data columns
+	enum class Column : std::uint32_t {
+		None  = 0x00,
+		Eu    = 0x01,//euler angles
+		X     = 0x02,//x coordinate
+		Y     = 0x04,//y coordinate
+		Iq    = 0x08,//image quality
+		Ci    = 0x10,//confidence index
+		Phase = 0x20,//phase ID
+		Sem   = 0x40,//secondary electron signal
+		Fit   = 0x80,//fit
+		All   = 0xFF,//all columns stored in files
+		Qu    = 0x100,//quaternions computed from the euler angles while parsing (interleaved wxyz per pixel, implies Eu)
+		QuSoA = 0x200 //quaternions computed from the euler angles while parsing (4 planes of w, x, y, and z, implies Eu)
+	};
+
+	//@brief: combine column flags
+	//@param a: first set of columns
+	//@param b: second set of columns
+	//@return: union of columns
+	inline Column operator|(const Column a, const Column b) {return Column(std::uint32_t(a) | std::uint32_t(b));}
+
+	//@brief: intersect column flags
+	//@param a: first set of columns
+	//@param b: second set of columns
+	//@return: intersection of columns
+	inline Column operator&(const Column a, const Column b) {return Column(std::uint32_t(a) & std::uint32_t(b));}
+
+	//@brief: check if a set of columns contains a column
+	//@param columns: set of columns
+	//@param c: column to check for
+	//@return: true if all columns in c are in columns
+	inline bool hasColumn(const Column columns, const Column c) {return c == (columns & c);}
+
+	//raw pointers to scan data column buffers (NULL columns are skipped while reading)
+	struct ScanBuffers {
+		float * eu   ;//euler angle triples for each pixel
+		float * x, *y;//x/y coordinate of pixel in microns
+		float * iq   ;//image quality
+		float * ci   ;//confidence index
+		float * sem  ;//secondary electron signal
+		float * fit  ;//fit
+		size_t* phase;//phase ID of each pixel (indexes into phaseList)
+		float * qu      = NULL;//quaternion for each pixel (computed from eu, NULL to skip)
+		size_t  quPlane = 0   ;//distance between planes of w, x, y, and z for planar quaternions (0 for interleaved wxyz)
+	};
+
+	//@brief: reusable block of 64 byte aligned memory that scan columns are carved from
+	//@note: copies of an arena share the same memory, the space of a freed column is reused by later columns (without returning to the system allocator)
+	class ScanArena {
+		public:
+			struct State;//shared bookkeeping (defined with the implementation)
+
+			//@brief: construct an empty arena (memory is allocated on first use)
+			ScanArena();
+
+			//@brief: copy an arena (the copy shares memory with the source)
+			//@param other: arena to share
+			ScanArena(const ScanArena& other) = default;
+			ScanArena& operator=(const ScanArena& other) = default;
+
+			//@brief: move an arena
+			//@param other: arena to move from (left holding a new empty arena so it can still be allocated from)
+			ScanArena(ScanArena&& other) noexcept;
+			ScanArena& operator=(ScanArena&& other) noexcept;
+
+			//@brief: make sure a single contiguous block with at least a given number of free bytes is available
+			//@param bytes: number of bytes to reserve
+			//@note: if nothing is currently carved from the arena existing blocks are coalesced into a single block
+			void reserve(const size_t bytes);
+
+			//@brief: get the total number of bytes held by the arena
+			//@return: bytes held
+			size_t capacity() const;
+
+			//@brief: get the number of bytes currently carved from the arena
+			//@return: bytes in use
+			size_t used() const;
+
+			//@brief: free all memory held by the arena (deferred until columns currently carved from the arena are freed)
+			void release();
+
+		private:
+			template <typename T> friend class ScanAllocator;
+			std::shared_ptr<State> state;//bookkeeping shared by all copies of the arena and allocators using it
+	};
+
+	//@brief: allocator for scan columns, memory is 64 byte aligned and value initialized by resize (see resizeUninitialized to skip initialization)
+	//@note: a default constructed allocator allocates each column separately, otherwise columns are carved from an arena
+	//@note: copies of a column use a default constructed allocator so they don't pin the source arena
+	template <typename T> class ScanAllocator {
 		public:
-			//header information
-			float  pixPerUm             ;
-			float  xStar, yStar, zStar  ;//pattern center calibration
-			float  workingDistance      ;//working distance in mm
-			float  xStep   , yStep      ;//pixel size in microns
-			size_t nColsOdd, nColsEven  ;//width in pixels (same for square grid, alternating rows for hex grid)
-			size_t nRows                ;//height in pixels
-			std::string operatorName    ;//operator name
-			std::string sampleId        ;//same ID string
-			std::string scanId          ;//scan ID string
-			GridType    gridType        ;//square/hex grid
-			std::vector<Phase> phaseList;//list of indexed phases (the 'phase' scan data indexes into this array)
+			typedef T              value_type                            ;
+			typedef std::true_type propagate_on_container_move_assignment;
+			typedef std::true_type propagate_on_container_swap           ;
+
+			//@brief: construct an allocator that allocates each column separately
+			ScanAllocator() {}
+
+			//@brief: construct an allocator that carves columns from an arena
+			//@param arena: arena to allocate from
+			ScanAllocator(const ScanArena& arena) : state(arena.state) {}
+
+			//@brief: rebind an allocator to another type
+			//@param other: allocator to copy arena from
+			template <typename U> ScanAllocator(const ScanAllocator<U>& other) : state(other.state) {}
+
+			//@brief: allocate uninitialized storage
+			//@param n: number of elements to allocate
+			//@return: pointer to storage (64 byte aligned)
+			T* allocate(const size_t n);
+
+			//@brief: free storage
+			//@param ptr: storage to free
+			//@param n: number of elements in storage
+			void deallocate(T* ptr, const size_t n);
+
+			//@brief: value initialize an element, or default initialize it (leaving arithmetic types uninitialized) inside resizeUninitialized
+			//@param ptr: element to initialize
+			template <typename U> void construct(U* ptr) {
+				if(SkipInit()) ::new((void*)ptr) U;
+				else ::new((void*)ptr) U();
+			}
+
+			//@brief: construct an element
+			//@param ptr: element to initialize
+			//@param args: constructor arguments
+			template <typename U, typename... Args> void construct(U* ptr, Args&&... args) {::new((void*)ptr) U(std::forward<Args>(args)...);}
+
+			//@brief: get the allocator to use for a copy of a column
+			//@return: default constructed allocator
+			ScanAllocator select_on_container_copy_construction() const {return ScanAllocator();}
+
+			//@brief: compare allocators
+			//@param other: allocator to compare against
+			//@return: true if memory allocated by one can be freed by the other
+			template <typename U> bool operator==(const ScanAllocator<U>& other) const {return state == other.state;}
+			template <typename U> bool operator!=(const ScanAllocator<U>& other) const {return state != other.state;}
+
+			//@brief: get the flag that makes construct skip initialization on this thread
+			//@return: true while a resizeUninitialized call is in progress
+			static bool& SkipInit() {
+				static thread_local bool skip = false;
+				return skip;
+			}
+
+		private:
+			template <typename U> friend class ScanAllocator;
+			std::shared_ptr<ScanArena::State> state;//arena to carve from (NULL to allocate separately)
+	};
+
+	//storage for a column of scan data
+	template <typename T> using ScanVector = std::vector<T, ScanAllocator<T> >;
+
+	//@brief: resize a column leaving new elements uninitialized (for columns that are about to be overwritten)
+	//@param v: column to resize
+	//@param count: new number of elements
+	template <typename T> void resizeUninitialized(ScanVector<T>& v, const size_t count) {
+		bool& skip = ScanAllocator<T>::SkipInit();
+		const bool prior = skip;
+		skip = true;
+		try {
+			v.resize(count);
+		} catch (...) {
+			skip = prior;
+			throw;
+		}
+		skip = prior;
+	}
+
+	//header information common to all scans
+	struct ScanHeader {
+		float  pixPerUm             ;
+		float  xStar, yStar, zStar  ;//pattern center calibration
+		float  workingDistance      ;//working distance in mm
+		float  xStep   , yStep      ;//pixel size in microns
+		size_t nColsOdd, nColsEven  ;//width in pixels (same for square grid, alternating rows for hex grid)
+		size_t nRows                ;//height in pixels
+		std::string operatorName    ;//operator name
+		std::string sampleId        ;//same ID string
+		std::string scanId          ;//scan ID string
+		GridType    gridType        ;//square/hex grid
+		std::vector<Phase> phaseList;//list of indexed phases (the 'phase' scan data indexes into this array)
+
+		//@brief: construct an empty header
+		ScanHeader() : gridType(GridType::Unknown) {}
+
+		//@brief: compute the number of pixels based on grid type and dimensions
+		//@return: number of pixels in the scan
+		size_t numPoints() const;
+
+		//@brief: get the width of a row
+		//@param row: index of row (0 is the first row, an odd row for hex grids)
+		//@return: number of pixels in the row
+		size_t rowWidth(const size_t row) const {return 0 == row % 2 ? nColsOdd : nColsEven;}
+
+		//@brief: get the index of the first pixel in a row
+		//@param row: index of row (0 is the first row, an odd row for hex grids)
+		//@return: number of pixels in all preceding rows
+		size_t rowStart(const size_t row) const {return (row / 2) * (nColsOdd + nColsEven) + (1 == row % 2 ? nColsOdd : 0);}
+
+		//@brief: get the index of a pixel in the scan arrays
+		//@param row: index of row
+		//@param col: index of column (in file order)
+		//@return: index of pixel (each row is stored from its last column to its first)
+		size_t index(const size_t row, const size_t col) const {return rowStart(row) + rowWidth(row) - 1 - col;}
+
+		//@brief: get the number of forward neighbors of each pixel (neighbors in +x / +y so each pair of neighbors is visited once)
+		//@return: 2 for square grids (+x, +y), 3 for hexagonal grids (+x, +y -x/2, +y +x/2)
+		size_t forwardNeighbors() const {return GridType::Hexagonal == gridType ? 3 : 2;}
+
+		//@brief: get a forward neighbor of a pixel
+		//@param row: index of row
+		//@param col: index of column (in file order)
+		//@param k: index of neighbor (< forwardNeighbors())
+		//@return: index of neighbor in the scan arrays, or SIZE_MAX if the neighbor is outside the scan
+		size_t forwardNeighbor(const size_t row, const size_t col, const size_t k) const;
+
+		//@brief: get the number of neighbors of each pixel
+		//@return: 4 for square grids, 6 for hexagonal grids (the forward neighbors followed by their mirror images)
+		size_t neighbors() const {return 2 * forwardNeighbors();}
+
+		//@brief: get a neighbor of a pixel
+		//@param row: index of row
+		//@param col: index of column (in file order)
+		//@param k: index of neighbor (< neighbors()), k < forwardNeighbors() is the same as forwardNeighbor, otherwise -x, -y (-y -x/2, -y +x/2 for hexagonal grids)
+		//@return: index of neighbor in the scan arrays, or SIZE_MAX if the neighbor is outside the scan
+		size_t neighbor(const size_t row, const size_t col, const size_t k) const;
+
+	protected:
+		//@brief: read an ang header and parse the values
+		//@param data: start of header (first character of the file)
+		//@param end: end of the buffer (this is never read past)
+		//@param offset: location to write offset to data start (in bytes)
+		//@return: number of tokens (number of data columns)
+		size_t readAngHeader(char const * const data, char const * const end, size_t& offset);
+	};
+
+	//moments and histogram of a scan column
+	struct ColumnStats {
+		float               lo       ;//lower bound of histogram
+		float               hi       ;//upper bound of histogram
+		std::vector<size_t> histogram;//number of values in equal width bins spanning [lo, hi] (values outside the range are counted in the first / last bin)
+		size_t              count    ;//number of values
+		double              sum      ;//sum of values
+		float               min      ;//smallest value (+inf if empty)
+		float               max      ;//largest value (-inf if empty)
+
+		//@brief: construct empty statistics
+		//@param lo: lower bound of histogram
+		//@param hi: upper bound of histogram
+		//@param bins: number of histogram bins
+		ColumnStats(const float lo = 0.0f, const float hi = 1.0f, const size_t bins = 256);
+
+		//@brief: get the mean value
+		//@return: mean (0 if empty)
+		double mean() const {return 0 == count ? 0.0 : sum / count;}
+
+		//@brief: accumulate values
+		//@param values: values to add
+		//@param n: number of values
+		void add(float const * const values, const size_t n);
+
+		//@brief: accumulate another set of statistics
+		//@param other: statistics to merge (must have the same histogram range and bins)
+		void merge(const ColumnStats& other);
+
+		//@brief: clear counts (keeping the histogram range and bins)
+		void clear();
+	};
 
+	//pixel count and mean values of a single phase
+	struct PhaseStats {
+		size_t pixels;//number of pixels with this phase ID
+		double iqSum ;//sum of image quality
+		double ciSum ;//sum of confidence index
+		double fitSum;//sum of fit
+
+		//@brief: construct empty statistics
+		PhaseStats() : pixels(0), iqSum(0), ciSum(0), fitSum(0) {}
+
+		//@brief: get mean values
+		//@return: mean value (0 if there are no pixels)
+		double iqMean () const {return 0 == pixels ? 0.0 : iqSum  / pixels;}
+		double ciMean () const {return 0 == pixels ? 0.0 : ciSum  / pixels;}
+		double fitMean() const {return 0 == pixels ? 0.0 : fitSum / pixels;}
+	};
+
+	//global and per phase statistics of a scan (accumulated while parsing with LoadStats::scanStats, or afterwards with OrientationMap::computeStats)
+	//@note: counts, min / max, and histograms are exact, sums (and means) are accumulated per chunk so their rounding varies slightly with the thread count
+	struct ScanStats {
+		ColumnStats                  iq    ;//image quality
+		ColumnStats                  ci    ;//confidence index
+		ColumnStats                  fit   ;//fit
+		std::map<size_t, PhaseStats> phases;//per phase statistics keyed on Phase::num (0 for unindexed pixels)
+
+		//@brief: construct empty statistics with default histogram ranges (iq: [0, 10000], ci: [-1, 1], fit: [0, 5])
+		//@param bins: number of bins in each histogram
+		ScanStats(const size_t bins = 256) : iq(0.0f, 10000.0f, bins), ci(-1.0f, 1.0f, bins), fit(0.0f, 5.0f, bins) {}
+
+		//@brief: accumulate a contiguous range of pixels
+		//@param iq: image quality of first pixel (or NULL to skip)
+		//@param ci: confidence index of first pixel (or NULL to skip)
+		//@param fit: fit of first pixel (or NULL to skip)
+		//@param phase: phase ID of first pixel (or NULL to skip per phase statistics)
+		//@param count: number of pixels
+		void add(float const * const iq, float const * const ci, float const * const fit, size_t const * const phase, const size_t count);
+
+		//@brief: accumulate another set of statistics
+		//@param other: statistics to merge (must have the same histogram ranges and bins)
+		void merge(const ScanStats& other);
+
+		//@brief: clear counts (keeping the histogram ranges and bins)
+		void clear();
+	};
+
+	//timing and counters collected while reading a scan (plus an optional progress hook)
+	struct LoadStats {
+		double        headerSeconds    ;//time spent parsing the header
+		double        allocateSeconds  ;//time spent allocating scan columns
+		double        parseSeconds     ;//time spent parsing scan data (for binary files everything after opening the file)
+		double        totalSeconds     ;//total time spent reading
+		std::uint64_t bytesScanned     ;//size of the file read (header + data)
+		size_t        linesParsed      ;//number of data lines (points) parsed
+		size_t        extraColumnPoints;//points read from a file whose header declares more than the 10 standard columns (all points or none, the extra tokens are skipped without conversion)
+		size_t        skippedTokens    ;//tokens skipped without conversion (unrequested columns and extra tokens, estimated from the header column count)
+		size_t        peakBytes        ;//bytes carved from the arena for this scan's columns (a reused arena may hold more, see ScanArena::capacity)
+		size_t        minorFaults      ;//page faults serviced without I/O during the read (process wide, 0 if unsupported)
+		size_t        majorFaults      ;//page faults that required I/O during the read (process wide, 0 if unsupported)
+		bool          cached           ;//true if the data was read from a binary file / sidecar instead of parsed
+
+		//progress reporting (set before reading)
+		size_t progressRows;//number of rows between progress callbacks (0 to disable)
+		std::function<void(const size_t rowsRead, const size_t rows)> progress;//called as rows are completed (calls are serialized and have increasing rowsRead, the final call has rowsRead == rows, an exception thrown by the callback stops the read and is rethrown to the caller)
+
+		//scan statistics (set before reading)
+		ScanStats * scanStats;//statistics to accumulate while parsing each row (cleared at the start of each read), or NULL to skip
+
+		//@brief: construct empty statistics with progress reporting and scan statistics disabled
+		LoadStats() : headerSeconds(0), allocateSeconds(0), parseSeconds(0), totalSeconds(0), bytesScanned(0), linesParsed(0), extraColumnPoints(0), skippedTokens(0), peakBytes(0), minorFaults(0), majorFaults(0), cached(false), progressRows(0), scanStats(NULL) {}
+
+		//@brief: clear statistics from a previous read but keep the progress hook and scan statistics target
+		void reset();
+	};
+
+	//problems a validating read checks each line of ang data for (bit flags)
+	enum class LineProblem : std::uint32_t {
+		None     = 0x00,
+		Tokens   = 0x01,//fewer tokens than the header's column count (e.g. a truncated line)
+		Number   = 0x02,//a token isn't a decimal number
+		Euler    = 0x04,//euler angles outside [0, 2pi] x [0, pi] x [0, 2pi] (other than the 4pi TSL writes for unindexed points)
+		Phase    = 0x08,//phase ID isn't 0 or the number of a phase in the header
+		Position = 0x10 //x/y more than a quarter step from the grid position (relative to the first point)
+	};
+
+	//@brief: combine line problem flags
+	//@param a: first set of problems
+	//@param b: second set of problems
+	//@return: union of problems
+	inline LineProblem operator|(const LineProblem a, const LineProblem b) {return LineProblem(std::uint32_t(a) | std::uint32_t(b));}
+
+	//@brief: intersect line problem flags
+	//@param a: first set of problems
+	//@param b: second set of problems
+	//@return: intersection of problems
+	inline LineProblem operator&(const LineProblem a, const LineProblem b) {return LineProblem(std::uint32_t(a) & std::uint32_t(b));}
+
+	//a line of ang data that failed validation
+	struct BadLine {
+		std::uint64_t offset  ;//byte offset of the start of the line in the file
+		size_t        line    ;//index of the data line (0 is the first line after the header)
+		LineProblem   problems;//problems found in the line
+	};
+
+	//problems found by a validating read
+	struct ValidationReport {
+		size_t               pointsExpected;//number of points described by the header
+		size_t               pointsRead    ;//number of data lines read (missing points are left as 0)
+		size_t               badLines      ;//number of lines with at least one problem
+		size_t               tokenLines    ;//number of lines with LineProblem::Tokens
+		size_t               numberLines   ;//number of lines with LineProblem::Number
+		size_t               eulerLines    ;//number of lines with LineProblem::Euler
+		size_t               phaseLines    ;//number of lines with LineProblem::Phase
+		size_t               positionLines ;//number of lines with LineProblem::Position
+		std::vector<BadLine> lines         ;//the first maxLines bad lines in file order
+		size_t               maxLines      ;//maximum number of bad lines to record (the counts include lines past the limit)
+
+		//@brief: construct an empty report
+		//@param maxLines: maximum number of bad lines to record
+		ValidationReport(const size_t maxLines = 1000) : maxLines(maxLines) {clear();}
+
+		//@brief: check if the file was complete and every line passed
+		//@return: true if no problems were found
+		bool ok() const {return 0 == badLines && !truncated();}
+
+		//@brief: check if the file ended before every point was read
+		//@return: true if points are missing
+		bool truncated() const {return pointsRead < pointsExpected;}
+
+		//@brief: record a bad line
+		//@param offset: byte offset of the start of the line in the file
+		//@param line: index of the data line
+		//@param problems: problems found in the line
+		void add(const std::uint64_t offset, const size_t line, const LineProblem problems);
+
+		//@brief: add problems found in a later part of the same file
+		//@param other: report to add (lines must follow the lines of this report)
+		void merge(const ValidationReport& other);
+
+		//@brief: clear counts and lines (the line limit is kept)
+		void clear();
+	};
+
+	//criteria for selecting pixels of a scan (a pixel is selected if it passes every test)
+	struct PixelFilter {
+		float               minCi ;//smallest confidence index to select (-inf to skip the test)
+		float               minIq ;//smallest image quality to select (-inf to skip the test)
+		std::vector<size_t> phases;//phase IDs (Phase::num) to select (empty to select every phase)
+
+		//@brief: construct a filter
+		//@param minCi: smallest confidence index to select
+		//@param minIq: smallest image quality to select
+		//@param phases: phase IDs to select (empty to select every phase)
+		PixelFilter(const float minCi = -std::numeric_limits<float>::infinity(), const float minIq = -std::numeric_limits<float>::infinity(), std::vector<size_t> phases = std::vector<size_t>()) : minCi(minCi), minIq(minIq), phases(phases) {}
+	};
+
+	//bitmask of selected pixels (bit i % 64 of word i / 64 is set if pixel i is selected)
+	struct PixelMask {
+		std::vector<std::uint64_t> bits    ;//packed selection bits (unused bits of the last word are 0)
+		size_t                     points  ;//number of pixels in the scan
+		size_t                     selected;//number of selected pixels
+
+		//@brief: check if a pixel is selected
+		//@param i: index of pixel
+		//@return: true if the pixel is selected
+		bool operator[](const size_t i) const {return 0 != (bits[i / 64] & (std::uint64_t(1) << (i % 64)));}
+
+		//@brief: list the selected pixels
+		//@param threads: number of threads to list with (0 to use all hardware threads)
+		//@return: indices of selected pixels in increasing order
+		std::vector<size_t> indices(const size_t threads = 1) const;
+	};
+
+	//structure of arrays copy of the selected pixels of a scan
+	struct ScanSelection {
+		std::vector<size_t> index   ;//index of each selected pixel in the source scan
+		std::vector<float > eu      ;//euler angle triples
+		std::vector<float > x, y    ;//x/y coordinates in microns
+		std::vector<float > iq      ;//image quality
+		std::vector<float > ci      ;//confidence index
+		std::vector<float > sem     ;//secondary electron signal
+		std::vector<float > fit     ;//fit
+		std::vector<size_t> phase   ;//phase ID
+		std::vector<float > qu      ;//quaternions (same layout as the source scan)
+		bool                quPlanar;//true if qu is stored as 4 planes, false for interleaved wxyz
+
+		//@brief: get the number of selected pixels
+		//@return: number of pixels
+		size_t size() const {return index.size();}
+	};
+
+	namespace detail {class RowProgress;}
+
+	class OrientationMap : public ScanHeader {
+		public:
 			//scan data (all in row major order)
-			std::vector<float > eu   ;//euler angle triples for each pixel
-			std::vector<float > x, y ;//x/y coordinate of pixel in microns
-			std::vector<float > iq   ;//image quality
-			std::vector<float > ci   ;//confidence index
-			std::vector<float > sem  ;//secondary electron signal
-			std::vector<float > fit  ;//fit
-			std::vector<size_t> phase;//phase ID of each pixel (indexes into phaseList)
+			ScanVector<float > eu   ;//euler angle triples for each pixel
+			ScanVector<float > x, y ;//x/y coordinate of pixel in microns
+			ScanVector<float > iq   ;//image quality
+			ScanVector<float > ci   ;//confidence index
+			ScanVector<float > sem  ;//secondary electron signal
+			ScanVector<float > fit  ;//fit
+			ScanVector<size_t> phase;//phase ID of each pixel (indexes into phaseList)
+			ScanVector<float > qu   ;//quaternion (w, x, y, z) of each pixel, only filled if Column::Qu or Column::QuSoA is requested
+			bool            quPlanar;//true if qu is stored as 4 planes (all w, then all x, ...), false for interleaved wxyz
+			ScanArena          arena;//memory columns are carved from (assign a shared arena to recycle memory across scans)
 
 			//@brief: construct an empty orientation map
-			OrientationMap() : gridType(GridType::Unknown) {}
+			OrientationMap() : quPlanar(false) {}
 
 			//@brief: construct an orientation map from a file
-			//@param fileName: file to read (currently only .ang is supported)
-			OrientationMap(std::string fileName) : gridType(GridType::Unknown) {read(fileName);}
+			//@param fileName: file to read (currently only .ang and .angb are supported)
+			OrientationMap(std::string fileName) : quPlanar(false) {read(fileName);}
+
+			//@brief: copy an orientation map
+			//@param other: map to copy (the copy carves its columns from a new arena instead of sharing the source's)
+			OrientationMap(const OrientationMap& other) : quPlanar(false) {*this = other;}
+			OrientationMap(OrientationMap&& other) = default;
+
+			//@brief: copy the header and columns of an orientation map
+			//@param other: map to copy (columns are carved from this map's arena, which isn't replaced by the source's)
+			//@return: this
+			OrientationMap& operator=(const OrientationMap& other);
+			OrientationMap& operator=(OrientationMap&& other) = default;
 
 			//@brief: check if a file can be ready by this class (based on file extension)
 			//@return: true/false if the file type can/cannot be read
-			static bool CanRead(std::string fileName) {return FileType::Ang == getFileType(fileName);}//currently only ang reading is implemented here
+			static bool CanRead(std::string fileName) {//currently ang, binary ang, and (if enabled) hdf5 / compressed ang reading is implemented here
+				const FileType type = getFileType(fileName);
+				#ifdef TSL_USE_HDF5
+					if(FileType::Hdf == type) return true;
+				#endif
+				#ifdef TSL_USE_ZLIB
+					if(FileType::AngGz == type) return true;
+				#endif
+				#ifdef TSL_USE_ZSTD
+					if(FileType::AngZst == type) return true;
+				#endif
+				return FileType::Ang == type || FileType::Angb == type;
+			}
+
+			//@brief: get the name of the binary sidecar cache for an ang file
+			//@param fileName: name of ang file
+			//@return: name of sidecar file
+			static std::string SidecarName(std::string fileName) {return fileName + "b";}
+
+			//@brief: get raw pointers to the scan data
+			//@return: pointers to each column (NULL for unallocated columns)
+			ScanBuffers buffers();
 
 			//@brief: allocate space to hold scan data based on grid type and dimensions
 			//@param tokenCount: number of arrays to use - eu, x, y, iq, ci and phase are always allocated, sem is only allocated for 9+ tokens and fit for 10+
-			void allocate(const size_t tokenCount);
+			//@param columns: columns to allocate (unrequested columns are emptied)
+			//@note: all columns are carved from a single block of the arena and are left uninitialized
+			void allocate(const size_t tokenCount, const Column columns = Column::All);
+
+			//@brief: free all scan columns (their memory is returned to the arena)
+			void release();
+
+			//@brief: compute global and per phase statistics of the iq, ci, fit, and phase columns
+			//@param stats: statistics to fill (cleared first, the histogram ranges and bins are kept)
+			//@param threads: number of threads to reduce with (0 to use all hardware threads)
+			//@note: set LoadStats::scanStats to accumulate the same statistics while parsing instead of in a second pass
+			void computeStats(ScanStats& stats, const size_t threads = 1) const;
+
+			//@brief: select the pixels that pass a filter
+			//@param filter: criteria to select pixels with (the ci / iq / phase columns must have been read for the tests that are used)
+			//@param threads: number of threads to filter with (0 to use all hardware threads)
+			//@return: bitmask of selected pixels
+			PixelMask select(const PixelFilter& filter, const size_t threads = 1) const;
+
+			//@brief: copy the selected pixels into contiguous arrays (so later stages don't need per pixel checks)
+			//@param mask: pixels to copy (from select)
+			//@param threads: number of threads to copy with (0 to use all hardware threads)
+			//@return: selected pixels of every column that was read, in scan order
+			ScanSelection compact(const PixelMask& mask, const size_t threads = 1) const;
+
+			//@brief: compute quaternions from the euler angles (this is done while parsing if Column::Qu or Column::QuSoA is requested)
+			//@param planar: true to store quaternions as 4 planes, false to interleave wxyz
+			//@param threads: number of threads to convert with (0 to use all hardware threads)
+			//@note: quaternions are passive with a non-negative scalar part, following Rowenhorst et al. (2015) with P = +1
+			void computeQuats(const bool planar = false, const size_t threads = 1);
 
 			//@brief: read scan data from a TSL orientation map file
-			//@param fileName: file to read (currently only .ang is supported)
-			void read(std::string fileName);
+			//@param fileName: file to read (currently only .ang and .angb are supported)
+			//@note: an up to date sidecar cache (SidecarName(fileName)) is read instead of an .ang file if it exists
+			void read(std::string fileName) {read(fileName, 1);}
+
+			//@brief: read scan data from a TSL orientation map file
+			//@param fileName: file to read (currently only .ang and .angb are supported)
+			//@param threads: number of threads to parse data with (0 to use all hardware threads)
+			//@param columns: columns to read (unrequested columns are left empty and skipped while parsing)
+			//@note: an up to date sidecar cache (SidecarName(fileName)) is read instead of an .ang file if it exists
+			void read(std::string fileName, const size_t threads, const Column columns = Column::All) {read(fileName, threads, columns, NULL);}
+
+			//@brief: read scan data from a TSL orientation map file and collect load statistics
+			//@param fileName: file to read (currently only .ang and .angb are supported)
+			//@param threads: number of threads to parse data with (0 to use all hardware threads)
+			//@param columns: columns to read (unrequested columns are left empty and skipped while parsing)
+			//@param stats: location to write load statistics (and progress callback to call), or NULL
+			//@note: an up to date sidecar cache (SidecarName(fileName)) is read instead of an .ang file if it exists
+			//@note: binary files are matched to their source by size and modification time only, the checksum is verified on request by OrientationMapView(fileName, true)
+			void read(std::string fileName, const size_t threads, const Column columns, LoadStats * const stats);
+
+			//@brief: read scan data from a '.ang' file and validate every line instead of throwing for bad data
+			//@param fileName: ang file to read (sidecar caches are ignored since the text is validated)
+			//@param threads: number of threads to parse and validate data with (0 to use all hardware threads)
+			//@param columns: columns to read
+			//@param maxLines: maximum number of bad lines to record in the report
+			//@return: problems found (a truncated file or bad lines are reported instead of thrown, missing points are 0)
+			//@note: each line is bounded to its own text so a short line never takes values from the next line
+			ValidationReport readValidated(std::string fileName, const size_t threads = 1, const Column columns = Column::All, const size_t maxLines = 1000);
 
-			// //@brief: write scan data to a 
-			// //@param fileName: file to read (currently only .ang is supported)
-			// void read(std::string fileName);
+			//@brief: read scan data from a '.ang' file with the std::istream based parser instead of the memory mapped parser
+			//@param fileName: ang file to read (sidecar caches are ignored)
+			//@param columns: columns to read
+			//@note: this is single threaded and much slower than read(), it is mainly useful to benchmark / cross check the memory mapped parser
+			void readStream(std::string fileName, const Column columns = Column::All);
+
+			//@brief: read scan data from a '.ang' file with large background reads instead of a memory map
+			//@param fileName: ang file to read (sidecar caches are ignored)
+			//@param threads: number of threads to parse data with (0 to use all hardware threads)
+			//@param columns: columns to read
+			//@param stats: location to write load statistics (and progress callback to call), or NULL
+			//@note: parsing each buffer overlaps with reading the next (see memorymap::ReadAheadFile), which is much faster than page faults on network file systems
+			void readBuffered(std::string fileName, const size_t threads = 1, const Column columns = Column::All, LoadStats * const stats = NULL);
+
+			//@brief: read a block of rows from a TSL orientation map file
+			//@param fileName: file to read (.ang files are accessed through a row index, .angb files and up to date sidecars are copied from directly)
+			//@param first: index of first row to read
+			//@param count: number of rows to read
+			//@param columns: columns to read
+			//@note: the header is updated to describe only the rows read (hexagonal reads must start on an even row index so the row offsets line up)
+			void readRows(std::string fileName, const size_t first, const size_t count, const Column columns = Column::All) {readRegion(fileName, 0, first, SIZE_MAX, count, columns);}
+
+			//@brief: read a rectangular region from a TSL orientation map file
+			//@param fileName: file to read (.ang files are accessed through a row index, .angb files and up to date sidecars are copied from directly)
+			//@param x0: index of first column to read (in file order)
+			//@param y0: index of first row to read
+			//@param w: number of columns to read (clipped to the width of each row)
+			//@param h: number of rows to read
+			//@param columns: columns to read
+			//@note: the header is updated to describe only the region read (hexagonal reads must start on an even row index so the row offsets line up)
+			void readRegion(std::string fileName, const size_t x0, const size_t y0, const size_t w, const size_t h, const Column columns = Column::All);
+
+			//@brief: write scan data to a binary .angb file
+			//@param fileName: file to write
+			//@param source: file to record the size and modification time of for cache validation (or empty for none)
+			void writeAngb(std::string fileName, std::string source = std::string()) const;
+
+			//@brief: write scan data to the binary sidecar cache of an ang file so future reads of the ang file can skip parsing
+			//@param fileName: name of ang file the scan data was read from
+			void writeSidecar(std::string fileName) const {writeAngb(SidecarName(fileName), fileName);}
+
+			//@brief: write scan data to a file
+			//@param fileName: file to write (currently only .ang and .angb are supported)
+			//@param threads: number of threads to format data with (0 to use all hardware threads)
+			void write(std::string fileName, const size_t threads = 1) const;
 
 		private:
+			//@brief: get the number of arena bytes carved for the scan columns
+			//@return: bytes held by the allocated columns (including alignment padding)
+			size_t columnBytes() const;
+
+			//@brief: write scan data to a '.ang' file
+			//@param fileName: name of ang file to write
+			//@param threads: number of threads to format data with (0 to use all hardware threads)
+			void writeAng(std::string fileName, const size_t threads) const;
+
+			//@brief: format rows of scan data as ang data lines
+			//@param first: index of first row to format
+			//@param last: index of row after the last row to format
+			//@param tokens: number of tokens per point
+			//@param text: location to append formatted lines to
+			//@note: columns that aren't allocated are written as 0 (x and y are computed from the grid instead)
+			void formatAngRows(const size_t first, const size_t last, const size_t tokens, std::string& text) const;
+
+			//@brief: read data from a binary '.angb' file
+			//@param fileName: name of angb file to read
+			//@param source: file the angb must have been written from (or empty to skip validation)
+			//@param columns: columns to read
+			//@param verify: true to verify the checksum (touches every page of the file), false to only check the source stamp and column table
+			//@return: number of scan points read from file
+			//@note: throws if the file is corrupt or doesn't match the source
+			size_t readAngb(std::string fileName, std::string source, const Column columns, const bool verify = false);
+
+		#ifdef TSL_USE_HDF5
+			//@brief: read data from an EDAX hdf5 file
+			//@param fileName: name of hdf5 file to read
+			//@param columns: columns to read
+			//@return: number of scan points read from file
+			//@note: the first scan (top level group with an 'EBSD' group) in the file is read
+			size_t readHdf(std::string fileName, const Column columns);
+		#endif
+
+			//how the data section of an ang file is accessed
+			enum class AngSource {
+				MemMap    ,//parse directly from a memory map
+				Stream    ,//parse with an input stream
+				ReadAhead ,//parse buffers filled by background reads
+				Compressed //parse buffers filled by background decompression (.ang.gz / .ang.zst)
+			};
+
+			//@brief: check that a complete scan was read
+			//@param pointsRead: number of points read
+			//@note: throws if fewer than numPoints() points were read
+			void requirePoints(const size_t pointsRead) const;
+
 			//@brief: read data from a '.ang' file
 			//@param fileName: name of ang file to read
+			//@param threads: number of threads to parse data with (0 to use all hardware threads)
+			//@param columns: columns to read
+			//@param source: how to access the data
+			//@param stats: location to write load statistics, or NULL
 			//@return: number of scan points read from file
-			size_t readAng(std::string fileName);
+			size_t readAng(std::string fileName, const size_t threads, const Column columns, const AngSource source = AngSource::MemMap, LoadStats * const stats = NULL);
 
-			//@brief: read an ang header and parse the values
-			//@param is: input stream to read the header from
-			//@return: number of tokens (number of data columns)
-			size_t readAngHeader(std::istream& is);
+			//@brief: read ang data from buffers filled by background reads or decompression
+			//@param file: source to read buffers from (memorymap::ReadAheadFile or detail::Decompressor)
+			//@param data: start of data in the current buffer (first character after the header)
+			//@param end: end of the current buffer
+			//@param tokens: number of tokens per point
+			//@param threads: number of threads to parse each buffer with (0 to use all hardware threads)
+			//@param progress: progress to update as rows are completed (or NULL)
+			//@param scanStats: statistics to accumulate as rows are completed (or NULL)
+			//@return: number of points (rows) parsed
+			template <typename Source> size_t readAngDataBuffered(Source& file, char const * data, char const * end, size_t tokens, const size_t threads, detail::RowProgress * const progress = NULL, ScanStats * const scanStats = NULL);
 
 			//@brief: read ang data using an input stream
 			//@param is: input stream set data start
 			//@param tokens: number of tokens per point
+			//@param progress: progress to update as rows are completed (or NULL)
 			//@return: number of points (rows) parsed
-			size_t readAngData(std::istream& is, size_t tokens);
+			size_t readAngData(std::istream& is, size_t tokens, detail::RowProgress * const progress = NULL);
 
 			//@brief: read ang data using a memory map
-			//@param fileName: name of file to read
-			//@param offset: offset to data start (in bytes)
+			//@param data: start of data (first character after the header)
+			//@param end: end of the memory map (this is never read past)
+			//@param tokens: number of tokens per point
+			//@param threads: number of threads to parse data with (0 to use all hardware threads)
+			//@param progress: progress to update as rows are completed (or NULL)
+			//@param firstLine: index of the line at data (relative to the data start)
+			//@param scanStats: statistics to accumulate as rows are completed (or NULL)
+			//@return: number of points (rows) parsed
+			size_t readAngDataMemMap(char const * const data, char const * const end, size_t tokens, const size_t threads, detail::RowProgress * const progress = NULL, const size_t firstLine = 0, ScanStats * const scanStats = NULL);
+
+			//@brief: parse a block of complete ang data lines
+			//@param data: start of first line to parse
+			//@param end: end of block (one past the last '\n')
+			//@param line: index of first line in block (relative to the data start)
+			//@param tokens: number of tokens per point
+			//@param progress: progress to update as rows are completed (or NULL)
+			//@param scanStats: statistics to accumulate as rows are completed (or NULL)
+			//@return: number of points (rows) parsed
+			size_t readAngChunk(char const * data, char const * const end, size_t line, size_t tokens, detail::RowProgress * const progress = NULL, ScanStats * const scanStats = NULL);
+
+			//@brief: parse and validate a block of complete ang data lines
+			//@param data: start of first line to parse
+			//@param end: end of block (one past the last '\n')
+			//@param line: index of first line in block (relative to the data start)
 			//@param tokens: number of tokens per point
+			//@param file: start of the file (for line offsets)
+			//@param origin: x/y coordinates of the first point (for position checks)
+			//@param report: report to add bad lines to
 			//@return: number of points (rows) parsed
-			size_t readAngDataMemMap(std::string fileName, std::streamoff offset, size_t tokens);
+			size_t validateAngChunk(char const * data, char const * const end, size_t line, const size_t tokens, char const * const file, const float origin[2], ValidationReport& report);
+
+			//@brief: compute the position of a line of ang data in the scan arrays
+			//@param line: index of line (relative to the data start)
+			//@param completeRowPoints: location to write number of points in rows before the line
+			//@param currentCol: location to write index of the line's point within its row
+			//@param evenRow: location to write true/false if the line is in an even/odd row
+			void lineToPoint(const size_t line, size_t& completeRowPoints, size_t& currentCol, bool& evenRow) const;
+
+			//the batch loader schedules header and chunk parsing of many files on a shared pool
+			friend void readMany(const std::vector<std::string>& fileNames, std::function<void(size_t, OrientationMap&)> callback, const size_t threads, const Column columns);
+
+			//the tailing reader parses appended lines directly into the scan arrays
+			friend class AngTailReader;
 	};
 
-	////////////////////////////////////////////////////////////////////////////////
-	//                           Implementation Details                           //
-	////////////////////////////////////////////////////////////////////////////////
+	//@brief: read many scans in parallel using a shared pool of threads
+	//@param fileNames: files to read (currently only .ang and .angb are supported)
+	//@param callback: function to call with the index (into fileNames) and data of each scan as it is completed (calls are serialized and in completion order, the scan may be moved from)
+	//@param threads: number of threads in the pool (0 to use all hardware threads)
+	//@param columns: columns to read
+	//@note: small files are parsed by a single thread while large files are split into chunks that are parsed by any idle thread
+	//@note: if a file can't be read the remaining files are still read, and the first exception is rethrown once all files are finished
+	void readMany(const std::vector<std::string>& fileNames, std::function<void(size_t, OrientationMap&)> callback, const size_t threads = 0, const Column columns = Column::All);
 
-	//@brief: read a GridType from an input stream
-	//@param is: input stream to read from
-	//@param grid: location to write parsed grid type
-	//@return: input stream read from
-	std::istream& operator>>(std::istream& is, GridType& grid) {
-		std::string name;
-		is >> name;
-		if     (0 == name.compare("SqrGrid")) grid = GridType::Square;
-		else if(0 == name.compare("HexGrid")) grid = GridType::Hexagonal;
-		else grid = GridType::Unknown;
-		return is;
-	}
+	//@brief: read many scans in parallel using a shared pool of threads
+	//@param fileNames: files to read (currently only .ang and .angb are supported)
+	//@param threads: number of threads in the pool (0 to use all hardware threads)
+	//@param columns: columns to read
+	//@return: scans in the same order as fileNames
+	std::vector<OrientationMap> readMany(const std::vector<std::string>& fileNames, const size_t threads = 0, const Column columns = Column::All);
 
-	//@brief: read a GridType from an output stream
-	//@param os: output stream to write to
-	//@param grid: grid type to write
-	//@return: output stream written to
-	std::ostream& operator<<(std::ostream& os, const GridType& grid) {
-		switch(grid) {
-			case GridType::Square   : return os << "SqrGrid";
-			case GridType::Hexagonal: return os << "HexGrid";
-			default: throw std::runtime_error("unknown grid type");
-		}
-	}
+	//@brief: column of floats stored as 16 bit fixed point codes spanning the range of the column
+	//@note: each decoded value is within maxError() = (max - min) / 131070 of the original (plus float rounding), e.g. 1.6e-5 for a CI in [-1, 1] or 1.4e-3 for a fit in [0, 180]
+	class QuantizedColumn {
+		public:
+			ScanVector<std::uint16_t> codes ;//quantized values
+			float                     offset;//value of code 0 (column minimum)
+			float                     step  ;//value difference between consecutive codes
 
-	//@brief: get the type of a file
-	//@param fileName: name to parse extension from
-	//@return: parsed extension
-	FileType getFileType(std::string fileName) {
-		size_t pos = fileName.find_last_of(".");//find the last '.' in the name
-		if(std::string::npos == pos) return FileType::Unknown;//handle files with no extension
-		std::string ext = fileName.substr(pos+1);//extract the file extension
-		std::transform(ext.begin(), ext.end(), ext.begin(), [](char c){return std::tolower(c);});//convert to lowercase
+			//@brief: construct an empty column
+			QuantizedColumn() : offset(0), step(0) {}
 
-		if     (0 == ext.compare("ang" )) return FileType::Ang;
-		else if(0 == ext.compare("osc" )) return FileType::Osc;
-		else if(0 == ext.compare("hdf" )) return FileType::Hdf;
-		else if(0 == ext.compare("hdf5")) return FileType::Hdf;
-		else if(0 == ext.compare("h5"  )) return FileType::Hdf;
-		else return FileType::Unknown;
-	}
+			//@brief: quantize values (the range is taken from the values)
+			//@param values: values to quantize (must be finite)
+			//@param count: number of values
+			//@param arena: arena to carve codes from
+			void assign(float const * const values, const size_t count, const ScanArena& arena = ScanArena());
 
-	//@brief: allocate space to hold scan data based on grid type and dimensions
-	//@param tokenCount: number of arrays to use - eu, x, y, iq, ci and phase are always allocated, sem is only allocated for 9+ tokens and fit for 10+
-	void OrientationMap::allocate(const size_t tokenCount) {
-		//compute number of pixels based on dimensions and grid type
-		size_t totalPoints = 0;
-		switch(gridType) {
-			case GridType::Square: {
-				totalPoints = std::max(nColsOdd, nColsEven) * nRows;
-			} break;
+			//@brief: decode a value
+			//@param i: index of value to decode
+			//@return: decoded value
+			float operator[](const size_t i) const {return offset + step * float(codes[i]);}
 
-			case GridType::Hexagonal: {
-				totalPoints = size_t(nRows / 2) * (nColsOdd + nColsEven);
-				if(1 == nRows % 2) totalPoints += nColsOdd;
-			} break;
+			//@brief: decode all values
+			//@param values: location to write decoded values (must hold at least size() values)
+			void decode(float * const values) const;
+
+			//@brief: get the number of values
+			//@return: number of values
+			size_t size() const {return codes.size();}
+
+			//@brief: check if the column is empty
+			//@return: true if there are no values
+			bool empty() const {return codes.empty();}
+
+			//@brief: get the maximum difference between a decoded value and the original value (excluding float rounding)
+			//@return: precision guarantee
+			float maxError() const {return step / 2;}
+	};
+
+	//@brief: reduced footprint copy of an orientation map for holding many scans in memory
+	//@param PhaseT: storage type for phase IDs (e.g. uint8_t, conversion throws if a phase doesn't fit)
+	//@param ScalarT: storage type for iq, ci, sem, and fit (QuantizedColumn for 2 bytes / pixel or ScanVector<float> for full precision)
+	//@note: euler angles and coordinates are always kept at full precision, uint8_t phases with quantized scalars use ~1/3 less memory than an OrientationMap (~1/2 if x/y are dropped)
+	template <typename PhaseT = std::uint8_t, typename ScalarT = QuantizedColumn>
+	class CompactOrientationMap : public ScanHeader {
+		public:
+			//scan data (all in row major order, same layout as OrientationMap)
+			ScanVector<float > eu   ;//euler angle triples for each pixel
+			ScanVector<float > x, y ;//x/y coordinate of pixel in microns
+			ScalarT            iq   ;//image quality
+			ScalarT            ci   ;//confidence index
+			ScalarT            sem  ;//secondary electron signal
+			ScalarT            fit  ;//fit
+			ScanVector<PhaseT> phase;//phase ID of each pixel (indexes into phaseList)
+			ScanArena          arena;//memory columns are carved from
+
+			//@brief: construct an empty map
+			CompactOrientationMap() {}
+
+			//@brief: construct a compact copy of an orientation map
+			//@param om: orientation map to copy
+			CompactOrientationMap(const OrientationMap& om) {assign(om);}
+
+			//@brief: read a scan and compact it
+			//@param fileName: file to read (currently only .ang and .angb are supported)
+			//@param threads: number of threads to parse data with (0 to use all hardware threads)
+			//@param columns: columns to keep
+			//@note: the full precision scan is read into a temporary arena which is freed before returning
+			CompactOrientationMap(std::string fileName, const size_t threads = 1, const Column columns = Column::All);
+
+			//@brief: replace the contents with a compact copy of an orientation map
+			//@param om: orientation map to copy
+			void assign(const OrientationMap& om);
+
+			//@brief: convert back to a full precision orientation map
+			//@return: orientation map (quantized columns are decoded)
+			OrientationMap expand() const;
+
+			//@brief: get the memory used by the scan columns
+			//@return: number of bytes
+			size_t bytes() const;
+
+		private:
+			//@brief: copy a float column into scalar storage
+			//@param src: column to copy
+			//@param dst: column to copy into
+			void compact(const ScanVector<float>& src, QuantizedColumn  & dst) const {dst.assign(src.data(), src.size(), arena);}
+			void compact(const ScanVector<float>& src, ScanVector<float>& dst) const {dst = ScanVector<float>(src.begin(), src.end(), ScanAllocator<float>(arena));}
+
+			//@brief: copy scalar storage into a float column
+			//@param src: column to copy
+			//@param dst: column to copy into
+			static void expand(const QuantizedColumn  & src, ScanVector<float>& dst) {resizeUninitialized(dst, src.size()); src.decode(dst.data());}
+			static void expand(const ScanVector<float>& src, ScanVector<float>& dst) {dst.assign(src.begin(), src.end());}
+
+			//@brief: get the memory used by scalar storage
+			//@param c: column
+			//@return: number of bytes
+			static size_t bytes(const QuantizedColumn  & c) {return c.size() * sizeof(std::uint16_t);}
+			static size_t bytes(const ScanVector<float>& c) {return c.size() * sizeof(float        );}
+	};
+
+	//misorientation between each pixel and its forward neighbors (see ScanHeader::forwardNeighbor)
+	struct NeighborMisorientation {
+		size_t            neighbors;//number of forward neighbors per pixel (2 for square grids, 3 for hexagonal grids)
+		ScanVector<float> angles   ;//disorientation angle in radians for each pixel / neighbor pair (angles[i * neighbors + k])
+		                            //NaN if the neighbor is outside the scan, +infinity if either pixel is unindexed or the phases differ
+
+		//@brief: get the angle between a pixel and a neighbor
+		//@param i: index of pixel
+		//@param k: index of neighbor
+		//@return: disorientation angle
+		float operator()(const size_t i, const size_t k) const {return angles[i * neighbors + k];}
+	};
+
+	//@brief: compute disorientation angles between neighboring pixels using the crystal symmetry of each phase
+	//@param om: orientation map (quaternions are used if they were computed, otherwise they are computed from the euler angles)
+	//@param threads: number of threads to compute with (0 to use all hardware threads), rows are split between threads
+	//@return: angle between each pixel and its forward neighbors
+	//@note: phase IDs are matched against Phase::num (phase 0 is the only phase of single phase scans and unindexed otherwise)
+	NeighborMisorientation neighborMisorientation(const OrientationMap& om, const size_t threads = 1);
+
+	//statistics of a single grain
+	struct Grain {
+		size_t pixels      ;//number of pixels in the grain
+		size_t phase       ;//phase ID of the grain
+		float  x, y        ;//centroid in microns
+		float  ci, iq      ;//mean confidence index and image quality (0 if the column wasn't read)
+		size_t firstRow    ;//first row containing the grain
+		size_t lastRow     ;//last row containing the grain
+		size_t seed        ;//index of the first pixel of the grain (in scan array order)
+	};
+
+	//grains of a segmented scan
+	struct GrainMap {
+		ScanVector<std::uint32_t> ids   ;//grain ID of each pixel (0 for pixels that weren't segmented)
+		std::vector<Grain>        grains;//statistics for each grain ID (grains[0] describes the pixels that weren't segmented)
+	};
+
+	//@brief: segment a scan into grains (connected pixels with neighbor disorientations within a tolerance)
+	//@param om: orientation map to segment (see neighborMisorientation for requirements)
+	//@param tolerance: maximum disorientation angle between neighboring pixels in the same grain (radians)
+	//@param minCI: pixels with a confidence index below this value aren't segmented (ignored if the ci column wasn't read)
+	//@param threads: number of threads to segment with (0 to use all hardware threads)
+	//@return: grain ID of each pixel and statistics for each grain (IDs are numbered in order of each grain's first pixel so they don't depend on the thread count)
+	GrainMap segmentGrains(const OrientationMap& om, const float tolerance, const float minCI, const size_t threads = 1);
+
+	//counts from an iterative cleanup
+	struct CleanupResult {
+		size_t iterations;//number of iterations run
+		size_t changed   ;//number of pixel updates (a pixel can be updated in more than one iteration)
+		size_t visited   ;//number of pixel evaluations (only pixels next to a change are revisited after the first iteration)
+	};
+
+	//@brief: neighbor confidence index correlation: pixels with a confidence index below a threshold take the orientation, phase, and confidence index of their highest CI neighbor (if it is higher than their own)
+	//@param om: orientation map to clean (the ci column is required, the eu, qu, and phase columns are updated if they were read)
+	//@param minCI: pixels with a confidence index below this value are cleaned
+	//@param threads: number of threads to clean with (0 to use all hardware threads)
+	//@param iterations: maximum number of iterations (1 for the usual single pass, 0 to repeat until no pixel changes)
+	//@return: iteration counts
+	//@note: every iteration only reads the result of the previous iteration so results don't depend on the thread count
+	CleanupResult neighborCiCorrelation(OrientationMap& om, const float minCI, const size_t threads = 1, const size_t iterations = 1);
+
+	//@brief: grain dilation: pixels that don't belong to a grain are added to the grain most of their neighbors belong to (repeated until every pixel connected to a grain is assigned)
+	//@param om: orientation map to clean (dilated pixels take the eu, qu, and phase of their highest CI neighbor in the grain they join)
+	//@param grains: segmentation of om (see segmentGrains), ids are updated and pixel counts are recomputed (the other grain statistics still describe the original segmentation)
+	//@param minPixels: grains with fewer pixels than this are dissolved before dilating
+	//@param threads: number of threads to clean with (0 to use all hardware threads)
+	//@param iterations: maximum number of iterations (0 to repeat until no pixel changes)
+	//@return: iteration counts
+	//@note: ties are broken by the highest neighbor CI and then the lowest grain ID so results don't depend on the thread count
+	CleanupResult dilateGrains(OrientationMap& om, GrainMap& grains, const size_t minPixels, const size_t threads = 1, const size_t iterations = 0);
+
+	//@brief: grain CI standardization: set the confidence index of every pixel in a grain to the highest confidence index in the grain
+	//@param om: orientation map to clean (the ci column is required)
+	//@param grains: segmentation of om (see segmentGrains), pixels with grain ID 0 aren't changed
+	//@param threads: number of threads to clean with (0 to use all hardware threads)
+	void standardizeCi(OrientationMap& om, const GrainMap& grains, const size_t threads = 1);
+
+	//nearest neighbor resampling from a (hexagonal) scan grid onto a square grid
+	class SquareResampler {
+		public:
+			size_t width, height;//dimensions of square grid in pixels
+			float  step         ;//pixel size of square grid in microns
+			ScanVector<std::uint32_t> source;//index of nearest source pixel for each square pixel (in scan array order)
+
+			//@brief: build the index table for a scan geometry
+			//@param header: geometry of scans to resample (grid type, dimensions, and step sizes)
+			//@param step: pixel size of square grid (0 to use the x step of the source grid)
+			SquareResampler(const ScanHeader& header, const float step = 0);
+
+			//@brief: get a cached index table for a scan geometry (tables are built the first time a geometry is requested)
+			//@param header: geometry of scans to resample
+			//@param step: pixel size of square grid (0 to use the x step of the source grid)
+			//@return: resampler for the geometry
+			//@note: the most recently used geometries are kept alive by the cache
+			static std::shared_ptr<const SquareResampler> Get(const ScanHeader& header, const float step = 0);
+
+			//@brief: check if a scan has the geometry this table was built for
+			//@param header: scan to check
+			//@return: true if the scan can be resampled with this table
+			bool matches(const ScanHeader& header) const;
+
+			//@brief: resample all columns of a scan onto the square grid
+			//@param om: scan to resample (must match the geometry the table was built for)
+			//@param threads: number of threads to resample with (0 to use all hardware threads)
+			//@return: square grid scan with the same columns as om (x and y are recomputed for the new grid)
+			OrientationMap resample(const OrientationMap& om, const size_t threads = 1) const;
+
+		private:
+			size_t srcOdd, srcEven, srcRows;//source dimensions
+			float  srcX, srcY              ;//source step sizes
+			GridType srcGrid               ;//source grid type
+	};
+
+	//@brief: resample a scan onto a square grid with nearest neighbor interpolation
+	//@param om: scan to resample (typically a hexagonal grid scan)
+	//@param step: pixel size of square grid (0 to use the x step of the source grid)
+	//@param threads: number of threads to resample with (0 to use all hardware threads)
+	//@return: square grid scan
+	//@note: index tables are cached per geometry (see SquareResampler::Get) so resampling many scans of the same size only builds the table once
+	inline OrientationMap resampleSquare(const OrientationMap& om, const float step = 0, const size_t threads = 1) {return SquareResampler::Get(om, step)->resample(om, threads);}
+
+	//mapping between scan array order and a tiled layout for neighborhood kernels (square tiles of pixels are stored contiguously so a stencil touches a few nearby tiles instead of rows far apart)
+	//@note: tiles are in row major order and pixels within a tile are in row major order by (row, column in file order), partial tiles on the edges (and the missing pixel of even hex rows) are padded
+	//@note: a 64 x 64 tile of 4 byte values is 16 KB, so each tile of a page aligned column covers whole pages
+	//@note: the kernels in this file work in scan array order, tiling is meant for callers with wider stencils that reuse a tiled column across several passes
+	class TiledLayout {
+		public:
+			//@brief: build the mapping for a scan geometry
+			//@param header: scan geometry
+			//@param tileSize: width and height of each tile in pixels (rounded up to a power of 2)
+			TiledLayout(const ScanHeader& header, const size_t tileSize = 64);
+
+			//@brief: get the width and height of each tile
+			//@return: tile size in pixels
+			size_t tileSize() const {return size_t(1) << shift;}
+
+			//@brief: get the number of pixels in the scan
+			//@return: number of values per component in a column in scan array order
+			size_t numPoints() const {return points;}
+
+			//@brief: get the number of tiles in each direction
+			//@return: number of tiles
+			size_t tilesX() const {return tilesWide;}
+			size_t tilesY() const {return tilesHigh;}
+
+			//@brief: get the number of values per component in a tiled column (including padding)
+			//@return: number of slots
+			size_t slots() const {return (tilesWide * tilesHigh) << (2 * shift);}
+
+			//@brief: get the slot of a pixel in a tiled column
+			//@param row: index of row
+			//@param col: index of column (in file order)
+			//@return: slot of pixel
+			size_t index(const size_t row, const size_t col) const {return (((row >> shift) * tilesWide + (col >> shift)) << (2 * shift)) + ((row & mask) << shift) + (col & mask);}
+
+			//@brief: get the scan array index of a slot in a tiled column
+			//@param slot: slot in tiled column
+			//@return: index of pixel in the scan arrays, or SIZE_MAX for padding
+			size_t scanIndex(const size_t slot) const;
+
+			//@brief: convert a column from scan array order to the tiled layout
+			//@param scan: column in scan array order
+			//@param tiled: location to write tiled column (must hold k * slots() values), padding is value initialized
+			//@param k: number of components per value (e.g. 3 for euler angles)
+			//@param threads: number of threads to convert with (0 to use all hardware threads), rows of tiles are split between threads
+			template <typename T> void toTiled(T const * const scan, T * const tiled, const size_t k = 1, const size_t threads = 1) const;
+
+			//@brief: convert a column from the tiled layout to scan array order
+			//@param tiled: tiled column
+			//@param scan: location to write column in scan array order (must hold k * numPoints() values)
+			//@param k: number of components per value (e.g. 3 for euler angles)
+			//@param threads: number of threads to convert with (0 to use all hardware threads), rows of tiles are split between threads
+			template <typename T> void toScan(T const * const tiled, T * const scan, const size_t k = 1, const size_t threads = 1) const;
+
+			//@brief: convert a column from scan array order to the tiled layout
+			//@param scan: column in scan array order (interleaved components, e.g. OrientationMap::eu, convert planar quaternions one plane at a time with the pointer overload)
+			//@param k: number of components per value (e.g. 3 for euler angles), the column must hold k * numPoints() values
+			//@param threads: number of threads to convert with (0 to use all hardware threads)
+			//@return: tiled column (empty if scan is empty)
+			template <typename T> ScanVector<T> toTiled(const ScanVector<T>& scan, const size_t k, const size_t threads = 1) const;
+
+			//@brief: convert a column from the tiled layout to scan array order
+			//@param tiled: tiled column (interleaved components)
+			//@param k: number of components per value (e.g. 3 for euler angles), the column must hold k * slots() values
+			//@param threads: number of threads to convert with (0 to use all hardware threads)
+			//@return: column in scan array order (empty if tiled is empty)
+			template <typename T> ScanVector<T> toScan(const ScanVector<T>& tiled, const size_t k, const size_t threads = 1) const;
+
+		private:
+			//@brief: copy between scan array order and the tiled layout
+			//@param src: column to copy from (in scan array order if Forward, tiled otherwise)
+			//@param dst: column to copy to (tiled if Forward, in scan array order otherwise)
+			//@param k: number of components per value
+			//@param threads: number of threads to convert with
+			template <bool Forward, typename T> void convert(T const * const src, T * const dst, const size_t k, const size_t threads) const;
+
+			size_t nColsOdd, nColsEven, nRows;//scan dimensions
+			size_t points                    ;//number of pixels in the scan
+			size_t shift, mask               ;//log2 of tile size and tile size - 1
+			size_t tilesWide, tilesHigh      ;//number of tiles in each direction
+	};
+
+	//@brief: byte offsets of the start of each row of ang data (for random access to a region of a scan)
+	//@note: files with fixed width lines (as written by TSL) don't need to store offsets since they can be computed
+	class AngRowIndex {
+		public:
+			//@brief: build the row index of ang data, or load it from IndexName(fileName) if a saved index is up to date
+			//@param header: parsed header of the ang file
+			//@param data: start of the scan data in memory
+			//@param end: end of the scan data in memory
+			//@param fileName: name of the ang file (empty to skip loading a saved index)
+			AngRowIndex(const ScanHeader& header, char const * data, char const * end, std::string fileName = std::string());
+
+			//@brief: get the name of the saved row index file for an ang file
+			//@param fileName: name of ang file
+			//@return: name of index file
+			static std::string IndexName(std::string fileName) {return fileName + "i";}
+
+			//@brief: check if the lines of the file have a fixed width (no offsets stored)
+			//@return: true if offsets are computed from the line width
+			bool fixedWidth() const {return 0 != lineBytes;}
+
+			//@brief: get the number of rows indexed
+			//@return: number of rows
+			size_t rows() const {return numRows;}
+
+			//@brief: get the offset to the start of a row
+			//@param row: index of row
+			//@return: offset from the start of the scan data in bytes
+			std::uint64_t rowOffset(const size_t row) const {return fixedWidth() ? lineBytes * rowStarts(row) : offsets[row];}
+
+			//@brief: get the length of each line for fixed width files
+			//@return: bytes per line (0 for variable width files)
+			std::uint64_t lineWidth() const {return lineBytes;}
+
+			//@brief: save the row index so future random access to the file can skip building it
+			//@param fileName: name of the ang file the index was built from (the index is written to IndexName(fileName))
+			void write(std::string fileName) const;
+
+		private:
+			std::uint64_t              lineBytes;//bytes per line for fixed width files (0 for variable width files)
+			std::vector<std::uint64_t> offsets  ;//offset of each row start for variable width files
+			size_t                     numRows  ;//number of rows
+			size_t                     nOdd     ;//width of odd rows
+			size_t                     nEven    ;//width of even rows
+
+			//@brief: get the number of points before a row
+			//@param row: index of row
+			//@return: number of points in preceding rows
+			size_t rowStarts(const size_t row) const {return (row / 2) * (nOdd + nEven) + (1 == row % 2 ? nOdd : 0);}
+
+			//@brief: try to load a saved index
+			//@param fileName: name of the ang file
+			//@return: true if an up to date index was loaded
+			bool load(std::string fileName);
+	};
+
+	//@brief: sequential reader for ang files too large to hold in memory, scan data is read a block of rows at a time
+	class AngStreamReader : public ScanHeader {
+		public:
+			//@brief: open an ang file and parse the header
+			//@param fileName: name of ang file to read
+			//@param hint: access pattern hint for the memory map (Random for region reads)
+			AngStreamReader(std::string fileName, const memorymap::Hint hint = memorymap::Hint::Sequential);
+
+			//@brief: get the number of tokens (data columns) per point
+			//@return: tokens per point
+			size_t tokens() const {return tokenCount;}
+
+			//@brief: get the number of rows read so far
+			//@return: number of rows
+			size_t rowsRead() const {return currentRow;}
+
+			//@brief: get the number of points read so far
+			//@return: number of points
+			size_t pointsRead() const {return currentPoint;}
+
+			//@brief: get the buffer size required to hold a block of rows
+			//@param rows: number of rows in block
+			//@return: number of points needed in each column buffer (3x for euler angles)
+			size_t blockPoints(const size_t rows) const {return rows * std::max(nColsOdd, nColsEven);}
+
+			//@brief: read the next block of rows into caller provided buffers
+			//@param rows: maximum number of rows to read
+			//@param buffers: buffers to read into (each non NULL buffer must hold at least blockPoints(rows) points), NULL columns are skipped
+			//@return: number of points read (0 once all rows have been read)
+			//@note: points are laid out the same way as in an OrientationMap (relative to the first point of the block)
+			//@note: if the file ends partway through a row the points read from that row are moved to the start of the row (still in reversed column order) so the first 'return value' points are always valid
+			size_t readRows(const size_t rows, const ScanBuffers& buffers);
+
+			//@brief: read all remaining rows a block at a time into internal buffers
+			//@param rows: number of rows per block
+			//@param columns: columns to read
+			//@param callback: function to call for each block with buffers (NULL for unrequested columns), index of the first point in the block, and number of points in the block
+			void readBlocks(const size_t rows, const Column columns, std::function<void(const ScanBuffers&, const size_t, const size_t)> callback);
+
+			//@brief: move to the start of a row (building or loading a row index if needed)
+			//@param row: index of row to move to
+			void seekRow(const size_t row);
+
+			//@brief: read part of the current row and move to the start of the next row
+			//@param col: index of first column to read (in file order)
+			//@param count: number of columns to read
+			//@param buffers: buffers to read into (each non NULL buffer must hold at least count points), NULL columns are skipped
+			//@return: number of points read
+			//@note: points are laid out the same way as in an OrientationMap (the last column read is the first point)
+			size_t readRowSpan(const size_t col, const size_t count, const ScanBuffers& buffers);
+
+			//@brief: get the row index of the file (building or loading it if needed)
+			//@return: row index
+			const AngRowIndex& index();
+
+			//@brief: limit how much of the file stays resident in this process while reading rows
+			//@param bytes: size of the window (0 to disable)
+			//@note: the next window of the file is prefetched as rows are read and data more than a window behind the current row is released
+			void residentWindow(const size_t bytes) {window = bytes;}
+
+		private:
+			//@brief: prefetch ahead of / release behind the current position when a resident window is set
+			void advanceWindow();
+
+			std::string                      name        ;//name of ang file
+			std::unique_ptr<memorymap::File> file        ;//memory mapped ang file
+			std::unique_ptr<AngRowIndex>     rowIndex    ;//row index (built on first seek)
+			char const *                     start       ;//start of scan data
+			char const *                     data        ;//start of next line to parse
+			char const *                     end         ;//end of memory map
+			size_t                           tokenCount  ;//tokens per point
+			size_t                           currentRow  ;//number of rows read
+			size_t                           currentPoint;//number of points read
+			size_t                           window      ;//size of resident window in bytes (0 to leave paging to the os)
+			size_t                           released    ;//file offset of the end of data released from the resident window
+			size_t                           prefetched  ;//file offset of the end of data prefetched for the resident window
+	};
+
+	//incremental reader for ang files that are still being written (e.g. during acquisition), each refresh remaps the file and parses only complete lines appended since the previous refresh
+	class AngTailReader {
+		public:
+			//@brief: start tailing an ang file (the header is parsed once it has been completely written)
+			//@param fileName: name of ang file to tail
+			//@param threads: number of threads to parse new lines with (0 to use all hardware threads)
+			//@param columns: columns to read
+			AngTailReader(std::string fileName, const size_t threads = 1, const Column columns = Column::All);
+
+			//@brief: parse lines appended to the file since the previous refresh
+			//@param final: true if the file won't be written anymore (a trailing line without a newline is parsed instead of waiting for the rest of it)
+			//@return: number of new points parsed
+			//@note: throws if the file shrinks (e.g. it is being overwritten by a new scan)
+			size_t refresh(const bool final = false);
+
+			//@brief: get the partially read scan
+			//@return: scan (points that haven't been read yet are 0)
+			//@note: the scan is empty until the header has been parsed
+			const OrientationMap& map() const {return om;}
+
+			//@brief: check if the header has been parsed
+			//@return: true if the scan dimensions are known
+			bool ready() const {return tokenCount > 0;}
+
+			//@brief: check if every point of the scan has been read
+			//@return: true if the scan is complete
+			bool complete() const {return ready() && points == om.numPoints();}
+
+			//@brief: get the number of points read so far
+			//@return: number of points (in file order)
+			size_t pointsRead() const {return points;}
+
+			//@brief: get the number of complete rows read so far
+			//@return: number of rows
+			size_t rowsRead() const;
+
+			//@brief: get the file offset of the next line to parse
+			//@return: offset in bytes
+			std::uint64_t bytesParsed() const {return offset;}
+
+		private:
+			std::string    name      ;//name of ang file
+			size_t         threads   ;//threads to parse with
+			Column         columns   ;//columns to read
+			OrientationMap om        ;//scan being filled
+			size_t         tokenCount;//tokens per point (0 until the header is parsed)
+			std::uint64_t  offset    ;//file offset of the first unparsed line
+			size_t         points    ;//number of lines parsed (the position of the next line in the scan arrays follows from OrientationMap::lineToPoint)
+	};
+
+	//position of a tile in a montage
+	struct MontageTile {
+		float x, y;//position of the tile's first pixel (first column of the first row) in the montage in microns (rounded to the nearest grid point)
+	};
+
+	//assembles scans of neighboring areas (e.g. a grid of stage positions) into a single preallocated orientation map
+	class MontageBuilder {
+		public:
+			//@brief: compute the header of a montage that covers a set of tiles
+			//@param tiles: headers of the tiles (e.g. from an AngStreamReader, which only parses the header until rows are read)
+			//@param at: position of each tile
+			//@return: header of the smallest montage containing every tile (calibration, names, and phases are copied from the first tile)
+			//@note: all tiles must have the same grid type and step sizes
+			static ScanHeader Layout(const std::vector<ScanHeader>& tiles, const std::vector<MontageTile>& at);
+
+			//@brief: allocate an empty montage
+			//@param header: geometry of the montage (see Layout)
+			//@param columns: columns to assemble
+			//@param threads: number of threads to initialize the columns with (0 to use all hardware threads)
+			//@note: pixels that no tile covers are 0 (phase 0 is unindexed) with x/y computed from the grid
+			MontageBuilder(const ScanHeader& header, const Column columns = Column::All, const size_t threads = 1);
+
+			//@brief: copy a tile into the montage
+			//@param tile: scan to copy (must have the grid type and step sizes of the montage), columns the tile doesn't have are left as is
+			//@param at: position of the tile
+			//@param threads: number of threads to copy with (0 to use all hardware threads), rows are split between threads
+			//@note: x/y are translated so the tile's first pixel lands on its grid position and phase IDs are copied as is (tiles should share a phase list)
+			//@note: pixels covered by more than one tile take the values of the last tile placed
+			void place(const OrientationMap& tile, const MontageTile& at, const size_t threads = 1);
+
+			//@brief: stream an ang file into the montage (each row is parsed directly into its final position)
+			//@param fileName: ang file to read
+			//@param at: position of the tile
+			//@note: only a window of the file is kept resident while reading (see AngStreamReader::residentWindow)
+			void place(std::string fileName, const MontageTile& at);
+
+			//@brief: place tiles from many files
+			//@param fileNames: files to read
+			//@param at: position of each tile
+			//@param threads: number of threads to read with (0 to use all hardware threads)
+			//@param stream: true to stream tiles with one file per thread (non .ang tiles are read whole and then copied), false to read whole tiles with readMany and copy each as it is completed
+			//@note: tiles are placed concurrently, overlapping tiles are placed one at a time but in no particular order so shared pixels take the values of whichever tile is placed last (use place() in order to control overlaps)
+			void placeFiles(const std::vector<std::string>& fileNames, const std::vector<MontageTile>& at, const size_t threads = 0, const bool stream = true);
+
+			//@brief: get the montage
+			//@return: montage
+			OrientationMap& map() {return om;}
+			const OrientationMap& map() const {return om;}
+
+		private:
+			//@brief: find the grid position of a tile
+			//@param montage: montage geometry
+			//@param tile: tile geometry
+			//@param at: position of the tile
+			//@param col: location to write index of the montage column that the first column of the tile lands on
+			//@param row: location to write index of the montage row that the first row of the tile lands on
+			static void Locate(const ScanHeader& montage, const ScanHeader& tile, const MontageTile& at, size_t& col, size_t& row);
+
+			//@brief: find the grid position of a tile and check that it fits in the montage
+			//@param tile: tile geometry
+			//@param at: position of the tile
+			//@param col: location to write index of the montage column that the first column of the tile lands on
+			//@param row: location to write index of the montage row that the first row of the tile lands on
+			void position(const ScanHeader& tile, const MontageTile& at, size_t& col, size_t& row) const;
+
+			//@brief: parse the rows of an opened ang file into the montage
+			//@param reader: reader positioned at the first row of the tile
+			//@param fileName: name of the tile file (for error messages)
+			//@param col0: index of the montage column that the first column of the tile lands on
+			//@param row0: index of the montage row that the first row of the tile lands on
+			void streamRows(AngStreamReader& reader, const std::string& fileName, const size_t col0, const size_t row0);
+
+			//@brief: get pointers into the montage columns
+			//@param i: index of first pixel
+			//@return: buffers starting at pixel i (NULL for unallocated columns)
+			ScanBuffers buffers(const size_t i);
+
+			OrientationMap om     ;//montage being assembled
+			Column         columns;//columns being assembled
+	};
+
+	//@brief: read only orientation map whose scan data points directly into a memory mapped binary (.angb) file
+	//@note: copies of a view share the same mapping, and processes viewing the same file share the same page cache pages
+	class OrientationMapView : public ScanHeader {
+		public:
+			//scan data (all in row major order, NULL for columns that aren't in the file)
+			float         const * eu    ;//euler angle triples for each pixel
+			float         const * x, * y;//x/y coordinate of pixel in microns
+			float         const * iq    ;//image quality
+			float         const * ci    ;//confidence index
+			float         const * sem   ;//secondary electron signal
+			float         const * fit   ;//fit
+			std::uint64_t const * phase ;//phase ID of each pixel (indexes into phaseList)
+
+			//@brief: construct a view of a binary file
+			//@param fileName: .angb file to view, or .ang file to view the up to date sidecar of
+			//@param verify: true to verify the checksum (touches every page of the file), false to skip verification (column bounds and lengths are always checked)
+			OrientationMapView(std::string fileName, const bool verify = true);
+
+			//@brief: get the number of pixels in the scan
+			//@return: number of pixels
+			size_t size() const {return points;}
+
+		private:
+			std::shared_ptr<const memorymap::File> file  ;//keep the mapping alive for the lifetime of the view
+			size_t                                 points;//number of pixels
+	};
+
+	////////////////////////////////////////////////////////////////////////////////
+	//                           Implementation Details                           //
+	////////////////////////////////////////////////////////////////////////////////
+
+	namespace detail {
+		//alignment of scan columns (cache line), and of large arena blocks (huge page)
+		static const size_t ColumnAlignment = 64;
+		static const size_t HugePageBytes   = 2 * 1024 * 1024;
+
+		//@brief: round a number of bytes up to the column alignment
+		//@param bytes: number of bytes
+		//@return: rounded number of bytes
+		inline size_t arenaBytes(const size_t bytes) {return (bytes + ColumnAlignment - 1) / ColumnAlignment * ColumnAlignment;}
+
+		//@brief: allocate aligned memory (blocks of at least a huge page are huge page aligned and flagged as huge page candidates)
+		//@param bytes: number of bytes to allocate (must be a multiple of ColumnAlignment)
+		//@return: allocated memory (throws std::bad_alloc on failure)
+		inline void* alignedAlloc(const size_t bytes) {
+			const size_t alignment = bytes >= HugePageBytes ? HugePageBytes : ColumnAlignment;
+			const size_t padded = (bytes + alignment - 1) / alignment * alignment;
+			#if _MMAP_API_TYPE_ == _MMAP_WIN_
+				void* ptr = _aligned_malloc(padded, alignment);
+			#else
+				void* ptr = std::aligned_alloc(alignment, padded);
+			#endif
+			if(NULL == ptr) throw std::bad_alloc();
+			#if _MMAP_API_TYPE_ == _MMAP_NIX_ && defined(MADV_HUGEPAGE)
+				if(alignment == HugePageBytes) madvise(ptr, padded, MADV_HUGEPAGE);//transparent huge pages cut page faults / TLB misses for large scans
+			#endif
+			return ptr;
+		}
+
+		//@brief: free memory allocated with alignedAlloc
+		//@param ptr: memory to free
+		inline void alignedFree(void* ptr) {
+			#if _MMAP_API_TYPE_ == _MMAP_WIN_
+				_aligned_free(ptr);
+			#else
+				std::free(ptr);
+			#endif
+		}
+
+		//@brief: get the index of the lowest set bit
+		//@param mask: bits to search (must be non zero)
+		//@return: number of trailing zeros
+		inline int countTrailingZeros(const std::uint64_t mask) {
+			#ifdef _MSC_VER
+				unsigned long index;
+				_BitScanForward64(&index, mask);
+				return (int)index;
+			#else
+				return __builtin_ctzll(mask);
+			#endif
+		}
+
+		//@brief: count the set bits of a word
+		//@param mask: bits to count
+		//@return: number of set bits
+		inline int countBits(const std::uint64_t mask) {
+			#ifdef _MSC_VER
+				return (int)__popcnt64(mask);
+			#else
+				return __builtin_popcountll(mask);
+			#endif
+		}
+
+		//@brief: split a bitmask into word aligned chunks and compute where each chunk's selected items start
+		//@param bits: bitmask to split
+		//@param threads: requested number of chunks (0 to use all hardware threads)
+		//@param minWords: minimum number of words per chunk
+		//@param words: location to write the first word of each chunk (plus the end)
+		//@param offsets: location to write the number of selected items before each chunk (plus the total)
+		inline void splitMask(const std::vector<std::uint64_t>& bits, const size_t threads, const size_t minWords, std::vector<size_t>& words, std::vector<size_t>& offsets) {
+			size_t chunks = 0 == threads ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads;
+			chunks = std::max<size_t>(1, std::min<size_t>(chunks, bits.size() / minWords));
+			words.resize(chunks + 1);
+			offsets.assign(chunks + 1, 0);
+			for(size_t i = 0; i <= chunks; i++) words[i] = bits.size() * i / chunks;
+			for(size_t i = 0; i < chunks; i++) {//a popcount pass is much cheaper than a second parallel pass, so the prefix sum is serial
+				for(size_t w = words[i]; w < words[i+1]; w++) offsets[i+1] += countBits(bits[w]);
+				offsets[i+1] += offsets[i];
+			}
+		}
+
+		//@brief: copy the selected items of a column into a contiguous array
+		//@param src: column to copy from
+		//@param k: number of values per item (e.g. 3 for euler angles)
+		//@param dst: location to write selected items (offset for the first word)
+		//@param bits: selection bitmask
+		//@param first: first word of bitmask to copy
+		//@param last: one past the last word of bitmask to copy
+		template <typename T> void compactColumn(T const * const src, const size_t k, T * dst, const std::uint64_t * const bits, const size_t first, const size_t last) {
+			for(size_t w = first; w < last; w++) {
+				for(std::uint64_t word = bits[w]; 0 != word; word &= word - 1) {//visit set bits from lowest to highest
+					T const * const item = src + k * (64 * w + countTrailingZeros(word));
+					for(size_t j = 0; j < k; j++) *dst++ = item[j];
+				}
+			}
+		}
+
+		//@brief: test up to 64 pixels against a filter
+		//@param ci: confidence index of first pixel (or NULL to skip the test)
+		//@param iq: image quality of first pixel (or NULL to skip the test)
+		//@param phase: phase ID of first pixel (or NULL to skip the test)
+		//@param n: number of pixels to test (at most 64)
+		//@param minCi: smallest confidence index to select
+		//@param minIq: smallest image quality to select
+		//@param keep: phase IDs to select
+		//@param keepCount: number of phase IDs to select
+		//@return: selection bits (bit i is set if pixel i passes)
+		inline std::uint64_t filterWord(float const * const ci, float const * const iq, size_t const * const phase, const size_t n, const float minCi, const float minIq, size_t const * const keep, const size_t keepCount) {
+			std::uint64_t word = 0;
+			size_t i = 0;
+		#if _TSL_SIMD_TYPE_ == _TSL_SIMD_AVX2_
+			const __m256 vCi = _mm256_set1_ps(minCi), vIq = _mm256_set1_ps(minIq);
+			for(; i + 8 <= n; i += 8) {
+				int pass = 0xFF;
+				if(NULL != ci) pass &= _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(ci + i), vCi, _CMP_GE_OQ));
+				if(NULL != iq) pass &= _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(iq + i), vIq, _CMP_GE_OQ));
+				if(NULL != phase && 8 == sizeof(size_t)) {//compare 4 64 bit phase IDs at a time with each phase to keep
+					int match = 0;
+					for(size_t h = 0; h < 2; h++) {
+						const __m256i v = _mm256_loadu_si256((__m256i const *)(phase + i + 4 * h));
+						__m256i eq = _mm256_setzero_si256();
+						for(size_t j = 0; j < keepCount; j++) eq = _mm256_or_si256(eq, _mm256_cmpeq_epi64(v, _mm256_set1_epi64x((long long)keep[j])));
+						match |= _mm256_movemask_pd(_mm256_castsi256_pd(eq)) << (4 * h);
+					}
+					pass &= match;
+				} else if(NULL != phase) {
+					for(size_t j = 0; j < 8; j++) if(keep + keepCount == std::find(keep, keep + keepCount, phase[i + j])) pass &= ~(1 << j);
+				}
+				word |= std::uint64_t(pass) << i;
+			}
+		#elif _TSL_SIMD_TYPE_ == _TSL_SIMD_SSE2_
+			const __m128 vCi = _mm_set1_ps(minCi), vIq = _mm_set1_ps(minIq);
+			for(; i + 4 <= n; i += 4) {
+				int pass = 0xF;
+				if(NULL != ci) pass &= _mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(ci + i), vCi));
+				if(NULL != iq) pass &= _mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(iq + i), vIq));
+				if(NULL != phase) {//SSE2 has no 64 bit compare
+					for(size_t j = 0; j < 4; j++) if(keep + keepCount == std::find(keep, keep + keepCount, phase[i + j])) pass &= ~(1 << j);
+				}
+				word |= std::uint64_t(pass) << i;
+			}
+		#endif
+			for(; i < n; i++) {//remainder (or everything without SIMD)
+				bool pass = true;
+				if(NULL != ci   ) pass = pass && ci[i] >= minCi;
+				if(NULL != iq   ) pass = pass && iq[i] >= minIq;
+				if(NULL != phase) pass = pass && keep + keepCount != std::find(keep, keep + keepCount, phase[i]);
+				if(pass) word |= std::uint64_t(1) << i;
+			}
+			return word;
+		}
+
+		//@brief: skip spaces and tabs (but not newlines)
+		//@param data: pointer to first character to check
+		//@param end: end of the buffer (this is never read past)
+		//@return: pointer to first non blank character (or end)
+		inline char const * skipBlanks(char const * data, char const * const end) {
+			if(data < end && ' ' != *data && '\t' != *data) return data;//most tokens are preceded by a single space or none
+			#if _TSL_SIMD_TYPE_ == _TSL_SIMD_AVX2_
+				const __m256i space = _mm256_set1_epi8(' ' );
+				const __m256i tab   = _mm256_set1_epi8('\t');
+				while(end - data >= 32) {//check 32 characters at a time
+					const __m256i chars = _mm256_loadu_si256((__m256i const *)data);
+					const __m256i blank = _mm256_or_si256(_mm256_cmpeq_epi8(chars, space), _mm256_cmpeq_epi8(chars, tab));
+					const std::uint32_t mask = ~(std::uint32_t)_mm256_movemask_epi8(blank);//bits are set for non blank characters
+					if(0 != mask) return data + countTrailingZeros(mask);
+					data += 32;
+				}
+			#elif _TSL_SIMD_TYPE_ == _TSL_SIMD_SSE2_
+				const __m128i space = _mm_set1_epi8(' ' );
+				const __m128i tab   = _mm_set1_epi8('\t');
+				while(end - data >= 16) {//check 16 characters at a time
+					const __m128i chars = _mm_loadu_si128((__m128i const *)data);
+					const __m128i blank = _mm_or_si128(_mm_cmpeq_epi8(chars, space), _mm_cmpeq_epi8(chars, tab));
+					const std::uint32_t mask = ~(std::uint32_t)_mm_movemask_epi8(blank) & 0xFFFF;//bits are set for non blank characters
+					if(0 != mask) return data + countTrailingZeros(mask);
+					data += 16;
+				}
+			#endif
+			while(data < end && (' ' == *data || '\t' == *data)) ++data;//finish remaining characters
+			return data;
+		}
+
+		//@brief: parse a run of decimal digits
+		//@param data: pointer to first character to parse
+		//@param end: end of the buffer (this is never read past)
+		//@param value: value to accumulate digits into (value = value * 10^digits + parsed)
+		//@param count: location to increment by number of digits parsed
+		//@return: pointer to first non digit character
+		//@note: values with more than 19 digits overflow
+		inline char const * parseDigits(char const * data, char const * const end, std::uint64_t& value, size_t& count) {
+			static const std::uint64_t Pow10[9] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+			#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__//swar conversion assumes little endian byte order
+				while(end - data >= 8) {//convert 8 characters at a time
+					std::uint64_t chars;
+					std::memcpy(&chars, data, 8);
+					const std::uint64_t digits = chars - 0x3030303030303030ull;//convert '0'-'9' to 0-9
+					const std::uint64_t nonDigit = ((chars + 0x4646464646464646ull) | digits) & 0x8080808080808080ull;//high bit is set for the first non digit character (bytes after it may be corrupted by carries)
+					const int n = 0 == nonDigit ? 8 : countTrailingZeros(nonDigit) / 8;//number of leading digits
+					std::uint64_t val = 0 == n ? 0 : digits << (64 - 8 * n);//shift digits to the end (low bytes become leading zeros)
+					val = (val * 10) + (val >> 8);//combine pairs of digits
+					val = (((val & 0x000000FF000000FFull) * 0x000F424000000064ull) + (((val >> 16) & 0x000000FF000000FFull) * 0x0000271000000001ull)) >> 32;//combine quads
+					value = value * Pow10[n] + val;
+					count += n;
+					data += n;
+					if(n < 8) return data;//reached the end of the run
+				}
+			#endif
+			while(data < end && *data >= '0' && *data <= '9') {//finish remaining characters
+				value = value * 10 + (*data++ - '0');
+				++count;
+			}
+			return data;
+		}
+
+		//@brief: run a C string conversion (strtof / strtoul) on a token without reading past the end of the buffer
+		//@param data: pointer to first character of the token
+		//@param end: end of the buffer (this is never read past)
+		//@param convert: conversion to run, called as convert(str, &strEnd) on a null terminated copy of the token
+		//@return: pointer to first character after the converted characters (data if nothing was converted)
+		template <typename F> char const * convertToken(char const * const data, char const * const end, F convert) {
+			char const * tokenEnd = data;
+			while(tokenEnd < end && ' ' != *tokenEnd && '\t' != *tokenEnd && '\r' != *tokenEnd && '\n' != *tokenEnd) ++tokenEnd;
+			const size_t len = tokenEnd - data;
+			char small[64];
+			std::string big;//only needed for absurdly long tokens
+			char * str = small;
+			if(len < sizeof(small)) {
+				std::memcpy(small, data, len);
+				small[len] = 0;
+			} else {
+				big.assign(data, len);
+				str = &big[0];
+			}
+			char* strEnd;
+			convert(str, &strEnd);
+			return data + (strEnd - str);
+		}
+
+		//@brief: parse a decimal floating point number ([+-]digits[.digits][(e|E)[+-]digits]), leading blanks are skipped
+		//@param data: pointer to first character to parse
+		//@param end: end of the buffer (this is never read past)
+		//@param value: location to write parsed value (0 if no number was parsed)
+		//@return: pointer to first character after the number (data if no number was parsed)
+		//@note: this is locale independent and correctly rounded (unrepresentable cases fall back to strtof)
+		inline char const * parseFloat(char const * data, char const * const end, float& value) {
+			#ifdef TSL_USE_STRTOF
+				char const * const numStart = skipBlanks(data, end);
+				char const * const numEnd = convertToken(numStart, end, [&value](char const * str, char** strEnd){value = std::strtof(str, strEnd);});
+				return numStart == numEnd ? data : numEnd;
+			#else
+				//parse sign
+				char const * p = skipBlanks(data, end);
+				char const * const numStart = p;//save start of number for fallback
+				const bool negative = p < end && '-' == *p;
+				if(p < end && ('-' == *p || '+' == *p)) ++p;
+
+				//parse significand
+				std::uint64_t mant = 0;
+				size_t digits = 0;
+				int exp10 = 0;
+				p = parseDigits(p, end, mant, digits);
+				if(p < end && '.' == *p) {
+					const size_t intDigits = digits;
+					p = parseDigits(p + 1, end, mant, digits);
+					exp10 = -(int)(digits - intDigits);
+				}
+				if(0 == digits) {//no digits, let strtof handle nan / inf
+					value = 0;
+					char const * const numEnd = convertToken(numStart, end, [&value](char const * str, char** strEnd){value = std::strtof(str, strEnd);});
+					return numStart == numEnd ? data : numEnd;
+				}
+
+				//parse exponent (only if there are digits after the 'e')
+				if(p < end && ('e' == *p || 'E' == *p)) {
+					char const * e = p + 1;
+					const bool negExp = e < end && '-' == *e;
+					if(e < end && ('-' == *e || '+' == *e)) ++e;
+					std::uint64_t expVal = 0;
+					size_t expDigits = 0;
+					e = parseDigits(e, end, expVal, expDigits);
+					if(expDigits > 0) {
+						if(expDigits > 4) expVal = 9999;//huge exponent (overflow or underflow)
+						exp10 += negExp ? -(int)expVal : (int)expVal;
+						p = e;
+					}
+				}
+
+				//convert to float, the result is correctly rounded as long as the significand and power of 10 are exact doubles (and the double isn't a float rounding midpoint)
+				static const double Pow10[23] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+				if(0 == mant) {
+					value = negative ? -0.0f : 0.0f;
+					return p;
+				} else if(digits <= 19 && mant <= (std::uint64_t(1) << 53) && exp10 >= -22 && exp10 <= 22) {
+					const double d = exp10 < 0 ? double(mant) / Pow10[-exp10] : double(mant) * Pow10[exp10];
+					std::uint64_t bits;
+					std::memcpy(&bits, &d, 8);
+					const bool midpoint = 0x10000000ull == (bits & 0x1FFFFFFFull);//the 29 bits truncated by converting to float are exactly half a float ulp
+					if(!midpoint && d >= FLT_MIN && d <= FLT_MAX) {
+						value = negative ? -float(d) : float(d);
+						return p;
+					}
+				}
+
+				//fall back to strtof for rare cases
+				return convertToken(numStart, end, [&value](char const * str, char** strEnd){value = std::strtof(str, strEnd);});
+			#endif
+		}
+
+		//@brief: skip whitespace separated tokens without converting them
+		//@param data: pointer to first character to skip
+		//@param end: end of the buffer (this is never read past)
+		//@param count: number of tokens to skip
+		//@return: pointer to first character after the last skipped token (stops at the end of the line)
+		inline char const * skipTokens(char const * data, char const * const end, size_t count) {
+			for(size_t i = 0; i < count; i++) {
+				data = skipBlanks(data, end);
+				while(data < end && ' ' != *data && '\t' != *data && '\r' != *data && '\n' != *data) ++data;
+			}
+			return data;
+		}
+
+		//@brief: parse a decimal unsigned integer ([+]digits), leading blanks are skipped
+		//@param data: pointer to first character to parse
+		//@param end: end of the buffer (this is never read past)
+		//@param value: location to write parsed value (0 if the token isn't an unsigned integer, e.g. -1)
+		//@return: pointer to first character after the token (data if there is no token before the end of the line)
+		//@note: the whole token is consumed even if it isn't a number so the following columns stay aligned
+		//@note: values too large for a size_t saturate to SIZE_MAX (the same as strtoul)
+		inline char const * parseUInt(char const * data, char const * const end, size_t& value) {
+			char const * const tokenStart = skipBlanks(data, end);
+			char const * const tokenEnd = skipTokens(tokenStart, end, 1);
+			value = 0;
+			if(tokenStart == tokenEnd) return data;//no token
+			#ifdef TSL_USE_STRTOF
+				char const * const numEnd = convertToken(tokenStart, end, [&value](char const * str, char** strEnd){value = std::strtoul(str, strEnd, 10);});
+				if(numEnd == tokenStart || '-' == *tokenStart) value = 0;//strtoul negates negative values
+			#else
+				char const * p = tokenStart;
+				if('+' == *p) ++p;
+				char const * const digitStart = p;
+				std::uint64_t val = 0;
+				size_t digits = 0;
+				p = parseDigits(p, end, val, digits);
+				if(digits > 19 || val > SIZE_MAX) {//parseDigits may have wrapped, let from_chars check the range
+					size_t exact;
+					value = std::errc() == std::from_chars(digitStart, p, exact).ec ? exact : SIZE_MAX;
+				} else {
+					value = (size_t)val;
+				}
+			#endif
+			return tokenEnd;
+		}
+
+		//@brief: parse a single line of ang data into scan data buffers (tokens for NULL buffers are skipped)
+		//@param data: start of line to parse
+		//@param end: end of buffer (this is never read past)
+		//@param buffers: buffers to parse into
+		//@param i: index of point to parse into
+		//@param tokens: number of tokens per point
+		//@return: pointer to first character after the last parsed token
+		char const * readAngLine(char const * data, char const * const end, const ScanBuffers& buffers, const size_t i, const size_t tokens) {
+			if(NULL == buffers.eu) {//skip euler angles
+				data = skipTokens(data, end, 3);
+			} else {
+				data = parseFloat(data, end, buffers.eu[3*i  ]);//parse first euler angle
+				data = parseFloat(data, end, buffers.eu[3*i+1]);//parse second euler angle
+				data = parseFloat(data, end, buffers.eu[3*i+2]);//parse third euler angle
+			}
+			data = NULL == buffers.x     ? skipTokens(data, end, 1) : parseFloat(data, end, buffers.x    [i]);//parse x
+			data = NULL == buffers.y     ? skipTokens(data, end, 1) : parseFloat(data, end, buffers.y    [i]);//parse y
+			data = NULL == buffers.iq    ? skipTokens(data, end, 1) : parseFloat(data, end, buffers.iq   [i]);//parse image quality
+			data = NULL == buffers.ci    ? skipTokens(data, end, 1) : parseFloat(data, end, buffers.ci   [i]);//parse confidence index
+			data = NULL == buffers.phase ? skipTokens(data, end, 1) : parseUInt (data, end, buffers.phase[i]);//parse phase
+			if(tokens > 8) {//are there 9 or more tokens?
+				data = NULL == buffers.sem ? skipTokens(data, end, 1) : parseFloat(data, end, buffers.sem[i]);//parse SE signal
+				if(tokens > 9 && NULL != buffers.fit) {//are there 10 or more tokens?
+					data = parseFloat(data, end, buffers.fit[i]);//parse fit
+				}
+			}
+			return data;
+		}
+
+		//@brief: advance to the start of the next line
+		//@param data: pointer within current line
+		//@param end: end of buffer (this is never read past)
+		//@return: pointer to the first character after the next '\n' (or end)
+		inline char const * nextLine(char const * data, char const * const end) {
+			char const * const newLine = (char const *)std::memchr(data, '\n', end - data);
+			return NULL == newLine ? end : newLine + 1;
+		}
+
+		//@brief: compute the sine and cosine of a float (cephes style range reduction and minimax polynomials, ~1 ulp for |x| < 8192)
+		//@param x: angle in radians
+		//@param s: location to write sin(x)
+		//@param c: location to write cos(x)
+		inline void sincos(const float x, float& s, float& c) {
+			//reduce to [-pi/4, pi/4] with extended precision pi/2
+			float a = std::fabs(x);
+			const int j = (int(a * 1.27323954473516f) + 1) & ~1;//octant rounded up to even
+			const float y = float(j);
+			a = ((a - y * 0.78515625f) - y * 2.4187564849853515625e-4f) - y * 3.77489497744594108e-8f;
+
+			//evaluate polynomials and select / flip based on the octant
+			const float z  = a * a;
+			const float pc = ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z + 4.166664568298827e-2f) * z * z - 0.5f * z + 1.0f;
+			const float ps = ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f) * z * a + a;
+			const bool swap = 0 != (j & 2);
+			s = swap ? pc : ps;
+			c = swap ? ps : pc;
+			if((0 != (j & 4)) != (x < 0)) s = -s;
+			if(0 == ((j - 2) & 4)) c = -c;
+		}
+
+		//@brief: compute the sine and cosine of an array of floats (same results as the scalar version)
+		//@param x: angles in radians
+		//@param s: location to write sin(x)
+		//@param c: location to write cos(x)
+		//@param n: number of angles
+		inline void sincos(float const * const x, float * const s, float * const c, const size_t n) {
+			size_t i = 0;
+			#if _TSL_SIMD_TYPE_ != _TSL_SIMD_NONE_
+				const __m128  absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+				const __m128i one     = _mm_set1_epi32(1);
+				const __m128i two     = _mm_set1_epi32(2);
+				const __m128i four    = _mm_set1_epi32(4);
+				for(; i + 4 <= n; i += 4) {
+					//reduce to [-pi/4, pi/4] with extended precision pi/2
+					const __m128  vx = _mm_loadu_ps(x + i);
+					__m128        a  = _mm_and_ps(vx, absMask);
+					const __m128i j  = _mm_andnot_si128(one, _mm_add_epi32(_mm_cvttps_epi32(_mm_mul_ps(a, _mm_set1_ps(1.27323954473516f))), one));
+					const __m128  y  = _mm_cvtepi32_ps(j);
+					a = _mm_sub_ps(a, _mm_mul_ps(y, _mm_set1_ps(0.78515625f                 )));
+					a = _mm_sub_ps(a, _mm_mul_ps(y, _mm_set1_ps(2.4187564849853515625e-4f   )));
+					a = _mm_sub_ps(a, _mm_mul_ps(y, _mm_set1_ps(3.77489497744594108e-8f     )));
+
+					//evaluate polynomials
+					const __m128 z = _mm_mul_ps(a, a);
+					__m128 pc = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(2.443315711809948e-5f), z), _mm_set1_ps(1.388731625493765e-3f));
+					pc = _mm_add_ps(_mm_mul_ps(pc, z), _mm_set1_ps(4.166664568298827e-2f));
+					pc = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_mul_ps(pc, z), z), _mm_mul_ps(_mm_set1_ps(0.5f), z)), _mm_set1_ps(1.0f));
+					__m128 ps = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.9515295891e-4f), z), _mm_set1_ps(8.3321608736e-3f));
+					ps = _mm_sub_ps(_mm_mul_ps(ps, z), _mm_set1_ps(1.6666654611e-1f));
+					ps = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ps, z), a), a);
+
+					//select / flip based on the octant
+					const __m128 swap   = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, two), two));
+					const __m128 sinNeg = _mm_xor_ps(_mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, four), 29)), _mm_andnot_ps(absMask, vx));
+					const __m128 cosNeg = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(j, two), four), 29));
+					const __m128 vs = _mm_or_ps(_mm_and_ps(swap, pc), _mm_andnot_ps(swap, ps));
+					const __m128 vc = _mm_or_ps(_mm_and_ps(swap, ps), _mm_andnot_ps(swap, pc));
+					_mm_storeu_ps(s + i, _mm_xor_ps(vs, sinNeg));
+					_mm_storeu_ps(c + i, _mm_xor_ps(vc, cosNeg));
+				}
+			#endif
+			for(; i < n; i++) sincos(x[i], s[i], c[i]);
+		}
+
+		//@brief: convert bunge euler angles to quaternions
+		//@param eu: euler angle triples (radians)
+		//@param qu: quaternions to write (w, x, y, z)
+		//@param plane: distance between planes of w, x, y, and z (0 for interleaved wxyz)
+		//@param first: index of first pixel to convert
+		//@param count: number of pixels to convert
+		//@note: quaternions are passive with a non-negative scalar part, following Rowenhorst et al. (2015) with P = +1
+		inline void eulerToQuat(float const * const eu, float * const qu, const size_t plane, const size_t first, const size_t count) {
+			static const size_t Block = 64;//convert in blocks that stay in L1
+			float half[3][Block], sn[3][Block], cs[3][Block];
+			for(size_t b = 0; b < count; b += Block) {
+				//compute half angles: (phi1 + phi2) / 2, Phi / 2, (phi1 - phi2) / 2
+				const size_t n = std::min(Block, count - b);
+				float const * const e = eu + 3 * (first + b);
+				for(size_t i = 0; i < n; i++) {
+					half[0][i] = (e[3*i] + e[3*i+2]) * 0.5f;
+					half[1][i] =  e[3*i+1]           * 0.5f;
+					half[2][i] = (e[3*i] - e[3*i+2]) * 0.5f;
+				}
+				for(size_t k = 0; k < 3; k++) sincos(half[k], sn[k], cs[k], n);
+
+				//assemble quaternions: (c cos(sigma), -s cos(delta), -s sin(delta), -c sin(sigma)) with the sign chosen so w >= 0
+				const size_t compStride  = 0 == plane ? 1 : plane;
+				const size_t pointStride = 0 == plane ? 4 : 1;
+				float * const q = qu + (first + b) * pointStride;
+				for(size_t i = 0; i < n; i++) {
+					const float w = cs[1][i] * cs[0][i];
+					const float sign = w < 0 ? -1.0f : 1.0f;
+					float * const qi = q + i * pointStride;
+					qi[0             ] =  sign * w;
+					qi[compStride    ] = -sign * sn[1][i] * cs[2][i];
+					qi[compStride * 2] = -sign * sn[1][i] * sn[2][i];
+					qi[compStride * 3] = -sign * cs[1][i] * sn[0][i];
+				}
+			}
+		}
+
+		//rotational symmetry operators of each laue group as quaternions (w, x, y, z), specialized at compile time so zero / unit components fold away
+		template <LaueGroup G> struct LaueOps;
+		static constexpr float R2 = 0.707106781186547524f;//sqrt(1/2)
+		static constexpr float R3 = 0.866025403784438647f;//sqrt(3/4)
+		template <> struct LaueOps<LaueGroup::Triclinic     > {static constexpr size_t Count =  1; static constexpr float Ops[Count][4] = {{1,0,0,0}};};
+		template <> struct LaueOps<LaueGroup::Monoclinic    > {static constexpr size_t Count =  2; static constexpr float Ops[Count][4] = {{1,0,0,0}, {0,0,1,0}};};
+		template <> struct LaueOps<LaueGroup::Orthorhombic  > {static constexpr size_t Count =  4; static constexpr float Ops[Count][4] = {{1,0,0,0}, {0,1,0,0}, {0,0,1,0}, {0,0,0,1}};};
+		template <> struct LaueOps<LaueGroup::TetragonalLow > {static constexpr size_t Count =  4; static constexpr float Ops[Count][4] = {{1,0,0,0}, {R2,0,0,R2}, {0,0,0,1}, {R2,0,0,-R2}};};
+		template <> struct LaueOps<LaueGroup::TetragonalHigh> {static constexpr size_t Count =  8; static constexpr float Ops[Count][4] = {{1,0,0,0}, {R2,0,0,R2}, {0,0,0,1}, {R2,0,0,-R2},
+		                                                                                                                                  {0,1,0,0}, {0,0,1,0}, {0,R2,R2,0}, {0,-R2,R2,0}};};
+		template <> struct LaueOps<LaueGroup::TrigonalLow   > {static constexpr size_t Count =  3; static constexpr float Ops[Count][4] = {{1,0,0,0}, {0.5f,0,0,R3}, {0.5f,0,0,-R3}};};
+		template <> struct LaueOps<LaueGroup::TrigonalHigh  > {static constexpr size_t Count =  6; static constexpr float Ops[Count][4] = {{1,0,0,0}, {0.5f,0,0,R3}, {0.5f,0,0,-R3},
+		                                                                                                                                  {0,1,0,0}, {0,0.5f,R3,0}, {0,-0.5f,R3,0}};};
+		template <> struct LaueOps<LaueGroup::HexagonalLow  > {static constexpr size_t Count =  6; static constexpr float Ops[Count][4] = {{1,0,0,0}, {R3,0,0,0.5f}, {0.5f,0,0,R3}, {0,0,0,1}, {0.5f,0,0,-R3}, {R3,0,0,-0.5f}};};
+		template <> struct LaueOps<LaueGroup::HexagonalHigh > {static constexpr size_t Count = 12; static constexpr float Ops[Count][4] = {{1,0,0,0}, {R3,0,0,0.5f}, {0.5f,0,0,R3}, {0,0,0,1}, {0.5f,0,0,-R3}, {R3,0,0,-0.5f},
+		                                                                                                                                  {0,1,0,0}, {0,R3,0.5f,0}, {0,0.5f,R3,0}, {0,0,1,0}, {0,-0.5f,R3,0}, {0,-R3,0.5f,0}};};
+		template <> struct LaueOps<LaueGroup::CubicLow      > {static constexpr size_t Count = 12; static constexpr float Ops[Count][4] = {{1,0,0,0}, {0,1,0,0}, {0,0,1,0}, {0,0,0,1},
+		                                                                                                                                  {0.5f, 0.5f, 0.5f, 0.5f}, {0.5f,-0.5f,-0.5f,-0.5f}, {0.5f, 0.5f,-0.5f,-0.5f}, {0.5f,-0.5f, 0.5f, 0.5f},
+		                                                                                                                                  {0.5f,-0.5f, 0.5f,-0.5f}, {0.5f, 0.5f,-0.5f, 0.5f}, {0.5f,-0.5f,-0.5f, 0.5f}, {0.5f, 0.5f, 0.5f,-0.5f}};};
+		template <> struct LaueOps<LaueGroup::CubicHigh     > {static constexpr size_t Count = 24; static constexpr float Ops[Count][4] = {{1,0,0,0}, {0,1,0,0}, {0,0,1,0}, {0,0,0,1},
+		                                                                                                                                  {0.5f, 0.5f, 0.5f, 0.5f}, {0.5f,-0.5f,-0.5f,-0.5f}, {0.5f, 0.5f,-0.5f,-0.5f}, {0.5f,-0.5f, 0.5f, 0.5f},
+		                                                                                                                                  {0.5f,-0.5f, 0.5f,-0.5f}, {0.5f, 0.5f,-0.5f, 0.5f}, {0.5f,-0.5f,-0.5f, 0.5f}, {0.5f, 0.5f, 0.5f,-0.5f},
+		                                                                                                                                  {R2,R2,0,0}, {R2,0,R2,0}, {R2,0,0,R2}, {R2,-R2,0,0}, {R2,0,-R2,0}, {R2,0,0,-R2},
+		                                                                                                                                  {0,R2,R2,0}, {0,-R2,R2,0}, {0,0,R2,R2}, {0,0,-R2,R2}, {0,R2,0,R2}, {0,-R2,0,R2}};};
+
+		//@brief: compute disorientation angles for a batch of misorientations
+		//@param w, x, y, z: components of each misorientation conjugate (w, -x, -y, -z) so (S * dq).w is a dot product
+		//@param angles: location to write disorientation angles (radians)
+		//@param n: number of misorientations
+		template <LaueGroup G> void disorientationBatch(float const * const w, float const * const x, float const * const y, float const * const z, float * const angles, const size_t n) {
+			typedef LaueOps<G> L;
+			size_t i = 0;
+			#if _TSL_SIMD_TYPE_ != _TSL_SIMD_NONE_
+				const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+				for(; i + 4 <= n; i += 4) {//4 misorientations at a time
+					const __m128 vw = _mm_loadu_ps(w + i), vx = _mm_loadu_ps(x + i), vy = _mm_loadu_ps(y + i), vz = _mm_loadu_ps(z + i);
+					__m128 best = _mm_setzero_ps();
+					for(size_t k = 0; k < L::Count; k++) {//|w| of each symmetric equivalent
+						__m128 dot =                _mm_mul_ps(_mm_set1_ps(L::Ops[k][0]), vw) ;
+						dot = _mm_add_ps(dot, _mm_mul_ps(_mm_set1_ps(L::Ops[k][1]), vx));
+						dot = _mm_add_ps(dot, _mm_mul_ps(_mm_set1_ps(L::Ops[k][2]), vy));
+						dot = _mm_add_ps(dot, _mm_mul_ps(_mm_set1_ps(L::Ops[k][3]), vz));
+						best = _mm_max_ps(best, _mm_and_ps(dot, absMask));
+					}
+					float b[4];
+					_mm_storeu_ps(b, _mm_min_ps(best, _mm_set1_ps(1.0f)));
+					for(size_t j = 0; j < 4; j++) angles[i + j] = 2.0f * std::acos(b[j]);
+				}
+			#endif
+			for(; i < n; i++) {
+				float best = 0;
+				for(size_t k = 0; k < L::Count; k++) best = std::max(best, std::fabs(L::Ops[k][0] * w[i] + L::Ops[k][1] * x[i] + L::Ops[k][2] * y[i] + L::Ops[k][3] * z[i]));
+				angles[i] = 2.0f * std::acos(std::min(best, 1.0f));
+			}
+		}
+
+		//@brief: compute disorientation angles for a batch of misorientations with a laue group selected at run time
+		//@param g: laue group
+		//@param w, x, y, z: components of each misorientation conjugate
+		//@param angles: location to write disorientation angles (radians)
+		//@param n: number of misorientations
+		inline void disorientationBatch(const LaueGroup g, float const * const w, float const * const x, float const * const y, float const * const z, float * const angles, const size_t n) {
+			switch(g) {
+				case LaueGroup::Triclinic     : return disorientationBatch<LaueGroup::Triclinic     >(w, x, y, z, angles, n);
+				case LaueGroup::Monoclinic    : return disorientationBatch<LaueGroup::Monoclinic    >(w, x, y, z, angles, n);
+				case LaueGroup::Orthorhombic  : return disorientationBatch<LaueGroup::Orthorhombic  >(w, x, y, z, angles, n);
+				case LaueGroup::TetragonalLow : return disorientationBatch<LaueGroup::TetragonalLow >(w, x, y, z, angles, n);
+				case LaueGroup::TetragonalHigh: return disorientationBatch<LaueGroup::TetragonalHigh>(w, x, y, z, angles, n);
+				case LaueGroup::TrigonalLow   : return disorientationBatch<LaueGroup::TrigonalLow   >(w, x, y, z, angles, n);
+				case LaueGroup::TrigonalHigh  : return disorientationBatch<LaueGroup::TrigonalHigh  >(w, x, y, z, angles, n);
+				case LaueGroup::HexagonalLow  : return disorientationBatch<LaueGroup::HexagonalLow  >(w, x, y, z, angles, n);
+				case LaueGroup::HexagonalHigh : return disorientationBatch<LaueGroup::HexagonalHigh >(w, x, y, z, angles, n);
+				case LaueGroup::CubicLow      : return disorientationBatch<LaueGroup::CubicLow      >(w, x, y, z, angles, n);
+				case LaueGroup::CubicHigh     : return disorientationBatch<LaueGroup::CubicHigh     >(w, x, y, z, angles, n);
+			}
+		}
+
+		//@brief: get the laue group of each phase ID in a scan
+		//@param om: scan to get the phase groups of
+		//@return: laue group of each phase ID (index with the phase ID, -1 for unindexed), or a single entry if the scan has no phase column
+		//@note: throws if a pixel has a phase ID larger than any phase in the phase list (e.g. corrupt data) instead of sizing the table by it
+		inline std::vector<int> phaseGroups(const OrientationMap& om) {
+			//get the largest phase id
+			size_t maxPhase = 0;
+			for(const Phase& p : om.phaseList) maxPhase = std::max(maxPhase, p.num);
+			if(!om.phase.empty()) {
+				const size_t maxPixel = *std::max_element(om.phase.begin(), om.phase.end());
+				if(maxPixel > maxPhase) throw std::runtime_error("phase ID " + std::to_string(maxPixel) + " isn't in the phase list");
+			}
+
+			//match phase ids to phases
+			std::vector<int> groups(maxPhase + 1, -1);
+			for(const Phase& p : om.phaseList) groups[p.num] = (int)laueGroup(p.sym);
+			if(1 == om.phaseList.size()) groups[0] = groups[om.phaseList.front().num];//single phase scans label pixels with 0
+			if(om.phase.empty() && om.phaseList.size() != 1) throw std::runtime_error("the phase column is required for scans that don't have exactly one phase");
+			return groups;
+		}
+
+		//@brief: add columns needed to compute requested columns
+		//@param columns: requested columns
+		//@return: columns to read
+		inline Column readColumns(const Column columns) {
+			return (hasColumn(columns, Column::Qu) || hasColumn(columns, Column::QuSoA)) ? columns | Column::Eu : columns;//quaternions are computed from euler angles
+		}
+
+		//minimum size of a chunk of ang data worth parsing on a separate thread
+		static const size_t MinChunkBytes = 1024 * 1024;//1 MB
+
+		//@brief: split ang data into newline aligned chunks
+		//@param data: start of data
+		//@param end: end of data
+		//@param chunks: maximum number of chunks (may be reduced so that chunks are at least MinChunkBytes)
+		//@return: chunk boundaries (chunk i is [bounds[i], bounds[i+1]))
+		inline std::vector<char const *> splitLines(char const * const data, char const * const end, size_t chunks) {
+			const size_t dataBytes = end - data;
+			chunks = std::max<size_t>(1, std::min<size_t>(chunks, dataBytes / MinChunkBytes));
+			std::vector<char const *> bounds(chunks + 1, data);
+			bounds.back() = end;
+			for(size_t i = 1; i < chunks; i++) {
+				char const * target = std::max(bounds[i-1], data + dataBytes * i / chunks);//approximate chunk start
+				char const * newLine = (char const *)std::memchr(target, '\n', end - target);//move forward to next line
+				bounds[i] = NULL == newLine ? bounds.back() : newLine + 1;
+			}
+			return bounds;
+		}
+
+		//@brief: simple pool of threads pulling tasks from a shared queue
+		class TaskPool {
+			public:
+				//@brief: start the worker threads
+				//@param threads: number of worker threads (0 to use all hardware threads)
+				TaskPool(const size_t threads) : active(0), stop(false) {
+					const size_t count = 0 == threads ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads;
+					for(size_t i = 0; i < count; i++) workers.emplace_back(&TaskPool::work, this);
+				}
+
+				//@brief: finish all queued tasks and join the worker threads
+				~TaskPool() {
+					wait();
+					{
+						std::lock_guard<std::mutex> lock(mut);
+						stop = true;
+					}
+					workAvailable.notify_all();
+					for(std::thread& t : workers) t.join();
+				}
+
+				//@brief: get the number of worker threads
+				//@return: number of threads
+				size_t size() const {return workers.size();}
+
+				//@brief: add a task to the queue (tasks must not throw)
+				//@param task: task to add
+				//@param urgent: true to run the task before any other queued tasks (used for work on files that are already in flight)
+				void push(std::function<void()> task, const bool urgent = false) {
+					{
+						std::lock_guard<std::mutex> lock(mut);
+						if(urgent) tasks.push_front(std::move(task));
+						else       tasks.push_back (std::move(task));
+					}
+					workAvailable.notify_one();
+				}
+
+				//@brief: block until the queue is empty and all workers are idle
+				void wait() {
+					std::unique_lock<std::mutex> lock(mut);
+					allDone.wait(lock, [this](){return tasks.empty() && 0 == active;});
+				}
+
+			private:
+				//@brief: worker thread loop
+				void work() {
+					std::unique_lock<std::mutex> lock(mut);
+					while(true) {
+						workAvailable.wait(lock, [this](){return stop || !tasks.empty();});
+						if(tasks.empty()) return;//stop was requested and there is no work left
+						std::function<void()> task = std::move(tasks.front());
+						tasks.pop_front();
+						++active;
+						lock.unlock();
+						task();
+						lock.lock();
+						if(0 == --active && tasks.empty()) allDone.notify_all();
+					}
+				}
+
+				std::vector<std::thread>          workers      ;//worker threads
+				std::deque<std::function<void()>> tasks        ;//queued tasks
+				std::mutex                        mut          ;//protects tasks, active, and stop
+				std::condition_variable           workAvailable;//signaled when a task is queued (or the pool is stopped)
+				std::condition_variable           allDone      ;//signaled when the last running task finishes with an empty queue
+				size_t                            active       ;//number of tasks currently running
+				bool                              stop         ;//true when the workers should exit
+		};
+
+		//@brief: parse a decimal signed integer ([+-]digits), leading blanks are skipped
+		//@param data: pointer to first character to parse
+		//@param end: end of the buffer (this is never read past)
+		//@param value: location to write parsed value (0 if no number was parsed)
+		//@return: pointer to first character after the number (data if no number was parsed)
+		template <typename T> char const * parseInt(char const * data, char const * const end, T& value) {
+			char const * p = skipBlanks(data, end);
+			const bool negative = p < end && '-' == *p;
+			if(negative) ++p;
+			size_t magnitude = 0;
+			char const * const numEnd = parseUInt(p, end, magnitude);
+			value = negative ? -T(magnitude) : T(magnitude);
+			return numEnd == p ? data : numEnd;
+		}
+
+		//@brief: zero copy tokenizer for whitespace separated values in a single line of text
+		struct LineTokenizer {
+			char const *       data;//current position in line
+			char const * const end ;//end of the line (excluding the line ending)
+
+			//@brief: construct a tokenizer for a line
+			//@param begin: first character of line
+			//@param lineEnd: end of the line
+			LineTokenizer(char const * begin, char const * lineEnd) : data(begin), end(lineEnd) {}
+
+			//@brief: get the next token
+			//@return: next token (empty if there are no more tokens)
+			std::string_view next() {
+				data = skipBlanks(data, end);
+				char const * const tokenStart = data;
+				while(data < end && ' ' != *data && '\t' != *data && '\r' != *data) ++data;
+				return std::string_view(tokenStart, data - tokenStart);
+			}
+
+			//@brief: parse the next token as a number (the value is left as 0 if the token isn't a number)
+			//@param value: location to write parsed value
+			void parse(float   & value) {data = parseFloat(data, end, value);}
+			void parse(size_t  & value) {data = parseUInt (data, end, value);}
+			void parse(int32_t & value) {data = parseInt  (data, end, value);}
+			void parse(uint32_t& value) {data = parseInt  (data, end, value);}
+			void parse(std::string& value) {value = std::string(next());}
+			void parse(GridType& value) {
+				const std::string_view name = next();
+				if     ("SqrGrid" == name) value = GridType::Square;
+				else if("HexGrid" == name) value = GridType::Hexagonal;
+				else value = GridType::Unknown;
+			}
+		};
+
+		//@brief: compile time hash of a header keyword (FNV-1a) for switch based keyword dispatch
+		//@param key: keyword to hash
+		//@return: hash of keyword
+		constexpr std::uint32_t keywordHash(const std::string_view key) {
+			std::uint32_t hash = 2166136261u;
+			for(const char c : key) hash = (hash ^ std::uint8_t(c)) * 16777619u;
+			return hash;
+		}
+
+		//@brief: append the shortest decimal representation of a value that parses back to the same value
+		//@param text: string to append to
+		//@param value: value to format (in fixed notation)
+		//@param width: minimum token width including separating space (shorter tokens are right aligned with spaces)
+		template <typename T> void appendToken(std::string& text, const T value, const size_t width) {
+			char buff[64];//large enough for any float in fixed notation
+			std::to_chars_result result;
+			if constexpr(std::is_floating_point<T>::value) {
+				result = std::to_chars(buff, buff + sizeof(buff), value, std::chars_format::fixed);
+			} else {
+				result = std::to_chars(buff, buff + sizeof(buff), value);
+			}
+			const size_t len = result.ptr - buff;
+			text.append(len < width ? width - len : 1, ' ');//always separate tokens by at least one space
+			text.append(buff, len);
+		}
+
+		//@brief: format a value as the shortest decimal representation that parses back to the same value
+		//@param value: value to format
+		//@return: formatted value
+		inline std::string toString(const float value) {
+			std::string text;
+			appendToken(text, value, 0);
+			return text.substr(1);//remove separating space
+		}
+
+		//@brief: helper to serialize values to a byte buffer (native byte order)
+		struct ByteWriter {
+			std::string buff;//serialized bytes
+
+			//@brief: append a trivially copyable value to the buffer
+			//@param v: value to append
+			template <typename T> void put(const T& v) {buff.append((char const *)&v, sizeof(T));}
+
+			//@brief: append a length prefixed string to the buffer
+			//@param str: string to append
+			void putString(const std::string& str) {put<std::uint64_t>(str.size()); buff.append(str);}
+		};
+
+		//@brief: helper to deserialize values from a byte buffer (native byte order)
+		struct ByteReader {
+			char const *       data;//current read position
+			char const * const end ;//end of buffer
+
+			//@brief: construct a reader from a byte range
+			//@param start: start of buffer
+			//@param stop: end of buffer
+			ByteReader(char const * start, char const * stop) : data(start), end(stop) {}
+
+			//@brief: check that bytes remain in the buffer
+			//@param bytes: number of bytes to check for
+			void require(const std::uint64_t bytes) const {if(bytes > std::uint64_t(end - data)) throw std::runtime_error("unexpected end of binary data");}
+
+			//@brief: extract a trivially copyable value from the buffer
+			//@return: extracted value
+			template <typename T> T get() {
+				require(sizeof(T));
+				T v;
+				std::memcpy(&v, data, sizeof(T));
+				data += sizeof(T);
+				return v;
+			}
+
+			//@brief: extract a length prefixed string from the buffer
+			//@return: extracted string
+			std::string getString() {
+				const std::uint64_t len = get<std::uint64_t>();
+				require(len);
+				std::string str(data, data + len);
+				data += len;
+				return str;
+			}
+		};
+
+		//@brief: compute a fast checksum of a buffer
+		//@param data: buffer to compute checksum of (must be 8 byte aligned)
+		//@param bytes: size of buffer in bytes (must be a multiple of 8)
+		//@return: checksum
+		//@note: this is a fletcher style sum over 64 bit words (4 independent lanes for speed), it detects truncation / corruption but isn't cryptographic
+		std::uint64_t checksum(char const * data, const std::uint64_t bytes) {
+			std::uint64_t const * words = (std::uint64_t const *)data;
+			const std::uint64_t count = bytes / 8;
+			std::uint64_t a[4] = {0, 0, 0, 0}, b[4] = {0, 0, 0, 0};
+			std::uint64_t i = 0;
+			for(; i + 4 <= count; i += 4) {
+				for(size_t j = 0; j < 4; j++) {
+					a[j] += words[i+j];
+					b[j] += a[j];
+				}
+			}
+			for(; i < count; i++) {
+				a[0] += words[i];
+				b[0] += a[0];
+			}
+			std::uint64_t sum = count;
+			for(size_t j = 0; j < 4; j++) sum = (sum ^ a[j]) * 0x100000001B3ull + b[j];
+			return sum;
+		}
+
+		//@brief: get the size and modification time of a file
+		//@param fileName: name of file to check
+		//@param bytes: location to write file size (0 if the file doesn't exist)
+		//@param time: location to write modification time (0 if the file doesn't exist)
+		void fileStamp(const std::string& fileName, std::uint64_t& bytes, std::int64_t& time) {
+			std::error_code ec;
+			bytes = std::filesystem::file_size(fileName, ec);
+			if(ec) bytes = 0;
+			const std::filesystem::file_time_type modified = std::filesystem::last_write_time(fileName, ec);
+			time = ec ? 0 : (std::int64_t)modified.time_since_epoch().count();
+		}
+
+		//layout of binary .angb files (all values in native byte order):
+		//  preamble (AngbPreambleBytes): magic number, version, source file size, source file modification time, checksum of everything after the preamble
+		//  header  : header values, phase list, column table (id, element type, byte offset, element count for each column)
+		//  columns : raw scan data column arrays (each aligned to AngbAlignment)
+		static const char          AngbMagic[8]      = {'T', 'S', 'L', 'A', 'N', 'G', 'B', '\0'};
+		static const std::uint32_t AngbVersion       = 1 ;
+		static const std::uint64_t AngbPreambleBytes = 40;
+		static const std::uint64_t AngbAlignment     = 64;
+
+		//layout of saved row index files: magic number, version, source file size, source file modification time, row count, row offsets
+		static const char          AngiMagic[8]      = {'T', 'S', 'L', 'A', 'N', 'G', 'I', '\0'};
+		static const std::uint32_t AngiVersion       = 1 ;
+
+		//column identifiers for binary files
+		enum class AngbColumn : std::uint32_t {Eu = 0, X = 1, Y = 2, Iq = 3, Ci = 4, Sem = 5, Fit = 6, Phase = 7};
+
+		//element types for binary files
+		enum class AngbType : std::uint32_t {Float32 = 0, UInt64 = 1};
+
+		//@brief: entry in the column table of a binary file
+		struct AngbEntry {
+			AngbColumn    id    ;//column stored
+			AngbType      type  ;//type of column elements
+			std::uint64_t offset;//offset to column start from file start in bytes
+			std::uint64_t count ;//number of elements
+		};
+
+		//@brief: round a byte count up to the binary column alignment
+		//@param bytes: byte count to round
+		//@return: rounded byte count
+		inline std::uint64_t angbAlign(const std::uint64_t bytes) {return (bytes + AngbAlignment - 1) / AngbAlignment * AngbAlignment;}
+
+		//@brief: serialize header values and phases for a binary file
+		//@param writer: buffer to write to
+		//@param header: values to serialize
+		void writeAngbHeader(ByteWriter& writer, const ScanHeader& header) {
+			//serialize header values
+			writer.put(header.pixPerUm       );
+			writer.put(header.xStar          );
+			writer.put(header.yStar          );
+			writer.put(header.zStar          );
+			writer.put(header.workingDistance);
+			writer.put(header.xStep          );
+			writer.put(header.yStep          );
+			writer.put<std::uint64_t>(header.nColsOdd );
+			writer.put<std::uint64_t>(header.nColsEven);
+			writer.put<std::uint64_t>(header.nRows    );
+			writer.put<std::uint32_t>((std::uint32_t)header.gridType);
+			writer.putString(header.operatorName);
+			writer.putString(header.sampleId    );
+			writer.putString(header.scanId      );
+
+			//serialize phases
+			writer.put<std::uint64_t>(header.phaseList.size());
+			for(const Phase& p : header.phaseList) {
+				writer.put<std::uint64_t>(p.num);
+				writer.putString(p.name);
+				writer.putString(p.form);
+				writer.putString(p.info);
+				writer.put(p.sym);
+				writer.put(p.lat);
+				writer.put<std::uint64_t>(p.hklFam.size());
+				for(const HKLFamily& f : p.hklFam) writer.put(f);
+				writer.put(p.el);
+				writer.put<std::uint64_t>(p.cats.size());
+				for(const size_t& c : p.cats) writer.put<std::uint64_t>(c);
+			}
+		}
+
+		//@brief: deserialize header values and phases from a binary file
+		//@param reader: buffer to read from
+		//@param header: location to write values
+		void readAngbHeader(ByteReader& reader, ScanHeader& header) {
+			//parse header values
+			header.pixPerUm        = reader.get<float>();
+			header.xStar           = reader.get<float>();
+			header.yStar           = reader.get<float>();
+			header.zStar           = reader.get<float>();
+			header.workingDistance = reader.get<float>();
+			header.xStep           = reader.get<float>();
+			header.yStep           = reader.get<float>();
+			header.nColsOdd        = (size_t)reader.get<std::uint64_t>();
+			header.nColsEven       = (size_t)reader.get<std::uint64_t>();
+			header.nRows           = (size_t)reader.get<std::uint64_t>();
+			header.gridType        = (GridType)reader.get<std::uint32_t>();
+			header.operatorName    = reader.getString();
+			header.sampleId        = reader.getString();
+			header.scanId          = reader.getString();
+
+			//parse phases
+			header.phaseList.resize((size_t)reader.get<std::uint64_t>());
+			for(Phase& p : header.phaseList) {
+				p.num  = (size_t)reader.get<std::uint64_t>();
+				p.name = reader.getString();
+				p.form = reader.getString();
+				p.info = reader.getString();
+				p.sym  = reader.get<std::uint32_t>();
+				for(float& v : p.lat) v = reader.get<float>();
+				p.hklFam.resize((size_t)reader.get<std::uint64_t>());
+				for(HKLFamily& f : p.hklFam) f = reader.get<HKLFamily>();
+				for(float& v : p.el) v = reader.get<float>();
+				p.cats.resize((size_t)reader.get<std::uint64_t>());
+				for(size_t& c : p.cats) c = (size_t)reader.get<std::uint64_t>();
+			}
+		}
+
+		//@brief: check the preamble of a mapped binary file
+		//@param mapped: memory mapped binary file
+		//@param fileName: name of binary file (for error messages)
+		//@param source: file the binary must have been written from (or empty to skip validation)
+		//@param verify: true/false to verify/skip verifying the checksum
+		//@return: reader positioned at the start of the header values
+		//@note: throws if the file isn't a valid binary file
+		ByteReader openAngb(const memorymap::File& mapped, const std::string& fileName, const std::string& source, const bool verify) {
+			ByteReader reader(mapped.constData(), mapped.constData() + mapped.size());
+			reader.require(AngbPreambleBytes);
+			if(0 != std::memcmp(reader.data, AngbMagic, sizeof(AngbMagic))) throw std::runtime_error(fileName + " isn't a binary ang file");
+			reader.data += sizeof(AngbMagic);
+			if(AngbVersion != reader.get<std::uint32_t>()) throw std::runtime_error(fileName + " has an unsupported binary ang version");
+			reader.get<std::uint32_t>();//reserved
+			const std::uint64_t sourceBytes = reader.get<std::uint64_t>();
+			const std::int64_t  sourceTime  = reader.get<std:: int64_t>();
+			const std::uint64_t sum         = reader.get<std::uint64_t>();
+			if(!source.empty()) {
+				std::uint64_t bytes;
+				std::int64_t  time;
+				fileStamp(source, bytes, time);
+				if(bytes != sourceBytes || time != sourceTime) throw std::runtime_error(fileName + " is out of date with " + source);
+			}
+			if(0 != mapped.size() % 8) throw std::runtime_error(fileName + " is corrupt (truncated)");
+			if(verify && sum != checksum(reader.data, mapped.size() - AngbPreambleBytes)) throw std::runtime_error(fileName + " is corrupt (checksum mismatch)");
+			return reader;
+		}
+
+		//@brief: read the column table of a binary file
+		//@param reader: buffer to read from (positioned after the header values)
+		//@param fileBytes: size of binary file
+		//@param fileName: name of binary file (for error messages)
+		//@return: column table (with bounds, types, and lengths verified)
+		//@note: this is the only validation of the column table when the checksum isn't verified
+		std::vector<AngbEntry> readAngbColumns(ByteReader& reader, const std::uint64_t fileBytes, const std::string& fileName) {
+			std::vector<AngbEntry> columns((size_t)reader.get<std::uint64_t>());
+			std::uint64_t points = UINT64_MAX;//number of points in the first standard column
+			for(AngbEntry& entry : columns) {
+				entry = reader.get<AngbEntry>();
+				if(AngbType::Float32 != entry.type && AngbType::UInt64 != entry.type) throw std::runtime_error(fileName + " has an unsupported column type");
+				const std::uint64_t elemBytes = AngbType::UInt64 == entry.type ? 8 : 4;
+				if(entry.offset > fileBytes || entry.count > (fileBytes - entry.offset) / elemBytes) throw std::runtime_error(fileName + " column extends past end of file");
+				if(0 != entry.offset % AngbAlignment) throw std::runtime_error(fileName + " column is misaligned");
+				if(entry.id > AngbColumn::Phase) continue;//unknown columns are skipped by readers
+				const AngbType expected = AngbColumn::Phase == entry.id ? AngbType::UInt64 : AngbType::Float32;
+				if(expected != entry.type) throw std::runtime_error(fileName + " has an unsupported column type");
+
+				//standard columns must all describe the same points (views index every column with the same point count)
+				const std::uint64_t width = AngbColumn::Eu == entry.id ? 3 : 1;
+				if(0 != entry.count % width) throw std::runtime_error(fileName + " has a truncated euler column");
+				if(UINT64_MAX == points) points = entry.count / width;
+				else if(points != entry.count / width) throw std::runtime_error(fileName + " has columns of different lengths");
+			}
+			return columns;
+		}
+
+		//@brief: get the time elapsed since a time point
+		//@param start: time point to measure from
+		//@return: elapsed time in seconds
+		inline double secondsSince(const std::chrono::steady_clock::time_point start) {
+			return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		//@brief: get the number of page faults this process has taken
+		//@param minor: location to write number of faults serviced without I/O
+		//@param major: location to write number of faults that required I/O
+		inline void pageFaults(size_t& minor, size_t& major) {
+			#if _MMAP_API_TYPE_ == _MMAP_NIX_
+				struct rusage usage;
+				if(0 == getrusage(RUSAGE_SELF, &usage)) {
+					minor = (size_t)usage.ru_minflt;
+					major = (size_t)usage.ru_majflt;
+					return;
+				}
+			#endif
+			minor = major = 0;
+		}
+
+		//thread safe row completion counter that calls a progress callback every N rows
+		class RowProgress {
+			public:
+				//@brief: construct a counter from load statistics
+				//@param stats: statistics holding the callback and interval
+				//@param rows: total number of rows
+				RowProgress(const LoadStats& stats, const size_t rows) : callback(stats.progress), interval(stats.progressRows), total(rows), done(0), reported(0), failed(false) {}
+
+				//@brief: check if progress should be tracked for load statistics
+				//@param stats: statistics to check (or NULL)
+				//@return: true if there is a callback to call
+				static bool Enabled(LoadStats const * const stats) {return NULL != stats && 0 != stats->progressRows && stats->progress;}
+
+				//@brief: mark a row as complete (calls the callback if the row crosses an interval)
+				void rowDone() {
+					const size_t rows = ++done;
+					if(0 == rows % interval || rows == total) report(rows);
+				}
+
+				//@brief: call the callback for the final row if it hasn't been called already
+				void finish() {report(total);}
+
+				//@brief: check if the callback has thrown (parsing threads stop at their next row)
+				//@return: true if a callback threw
+				bool cancelled() const {return failed.load(std::memory_order_relaxed);}
+
+			private:
+				//@brief: call the callback if the number of rows is larger than the last reported value
+				//@param rows: number of completed rows
+				//@note: exceptions from the callback are rethrown to the parsing thread (which must forward them to the calling thread)
+				void report(const size_t rows) {
+					std::lock_guard<std::mutex> lock(mutex);
+					if(rows <= reported || cancelled()) return;//a later row was already reported by another thread
+					reported = rows;
+					try {
+						callback(rows, total);
+					} catch (...) {
+						failed.store(true, std::memory_order_relaxed);
+						throw;
+					}
+				}
+
+				const std::function<void(const size_t, const size_t)>& callback;
+				const size_t        interval;//rows between callbacks
+				const size_t        total   ;//total number of rows
+				std::atomic<size_t> done    ;//number of rows completed
+				size_t              reported;//largest number of rows passed to the callback
+				std::mutex          mutex   ;//serializes callbacks
+				std::atomic<bool>   failed  ;//true once the callback has thrown
+		};
+
+		//sequential reader for compressed files that decompresses into a ring of buffers on background threads (same interface as memorymap::ReadAheadFile)
+		//@note: gzip files (including concatenated members) are inflated on a single thread, zstd files with multiple frames are decompressed one frame per thread (frames without a recorded content size are streamed on a single thread)
+		class Decompressor {
+			public:
+				//@brief: open a compressed file and start decompressing it in the background
+				//@param fileName: name of file to read (.gz or .zst)
+				//@param threads: maximum number of zstd frames to decompress at once (0 to use all hardware threads)
+				//@param blockBytes: size of each decompressed buffer (memory use is bounded by a ring of threads + 2 buffers)
+				//@param headroom: space reserved in front of each buffer for bytes carried over from the previous block
+				Decompressor(std::string fileName, const size_t threads = 1, const size_t blockBytes = 8 * 1024 * 1024, const size_t headroom = 64 * 1024);
+
+				//@brief: stop decompressing and close the file
+				~Decompressor();
+
+				//@brief: get size of compressed file in bytes
+				//@return: size of compressed file in bytes
+				std::uint64_t size() const {return file.size();}
+
+				//@brief: get number of decompressed bytes returned by next() so far
+				//@return: number of decompressed bytes
+				std::uint64_t decompressed() const {return returned;}
+
+				//@brief: get the next decompressed block (waiting for it to be decompressed if needed)
+				//@param keep: start of unused bytes at the end of the previous block to place directly in front of the next block (e.g. a partial line), or NULL
+				//@param bytes: location to write the size of the block (including kept bytes)
+				//@return: read only pointer to the block (valid until the next call), or NULL once the entire file has been returned (the previous block stays valid)
+				char const * next(char const * keep, size_t& bytes);
+
+				//@brief: check if every decompressed byte has been returned (waiting for the following blocks to be decompressed if needed)
+				//@return: true if only empty blocks (if any) remain
+				bool finished();
+
+			private:
+				struct Frame {
+					std::uint64_t offset ;//offset of compressed frame in the file
+					size_t        bytes  ;//size of compressed frame
+					std::uint64_t content;//size of decompressed frame
+					size_t        first  ;//index of first block holding the decompressed frame (each frame is split into one or more blocks)
+				};
+
+				struct Block {
+					std::unique_ptr<char[]> buffer  ;//headroom followed by decompressed data
+					char *                  data    ;//start of decompressed data (headroom bytes into the buffer)
+					size_t                  capacity;//bytes available after the headroom
+					size_t                  bytes   ;//number of decompressed bytes
+					size_t                  index   ;//index of block held by the buffer (SIZE_MAX while empty)
+				};
+
+				//@brief: wait for the buffer of a block to be released
+				//@param n: index of block to write
+				//@return: buffer to write block into, or NULL if the reader is being destroyed
+				Block* acquire(const size_t n);
+
+				//@brief: mark a block as ready to read
+				//@param n: index of block
+				//@param last: true if this is the final block of a streamed file
+				void publish(const size_t n, const bool last);
+
+				//@brief: decompress a gzip file sequentially (run on the background thread)
+				void inflateLoop();
+
+				//@brief: decompress a zstd file sequentially (run on the background thread)
+				void streamLoop();
+
+				//@brief: decompress zstd frames in parallel (run on each background thread)
+				void frameLoop();
+
+				//@brief: run a decompression loop and record any error for next() to rethrow
+				//@param loop: loop to run
+				void guard(void (Decompressor::*loop)());
+
+				std::string                                        name      ;//name of file (for error messages)
+				memorymap::File                                    file      ;//compressed data
+				std::vector<Frame>                                 frames    ;//zstd frames decompressed in parallel (empty for streamed files)
+				std::vector<Block>                                 blocks    ;//ring of buffers
+				size_t                                             blockBytes;//size of each streamed buffer
+				size_t                                             headroom  ;//space in front of each block for carried over bytes
+				size_t                                             total     ;//number of blocks (SIZE_MAX until a streamed file ends)
+				size_t                                             claimed   ;//number of frames claimed by decompression threads
+				size_t                                             consumed  ;//number of blocks returned by next()
+				std::uint64_t                                      returned  ;//number of decompressed bytes returned by next()
+				bool                                               stop      ;//flag to stop the decompression threads
+				std::string                                        error     ;//error message from a decompression thread
+				std::mutex                                         mutex     ;//protects everything but the contents of blocks being written
+				std::condition_variable                            changed   ;//signaled when a block is written or released
+				std::vector<std::thread>                           workers   ;//background decompression threads
+
+				//disable copying
+				Decompressor(Decompressor const &) = delete;
+				void operator=(Decompressor const &) = delete;
+		};
+
+		//@brief: open a compressed file and start decompressing it in the background
+		//@param fileName: name of file to read (.gz or .zst)
+		//@param threads: maximum number of zstd frames to decompress at once (0 to use all hardware threads)
+		//@param blockBytes: size of each decompressed buffer for streamed (gzip / single frame) files
+		//@param headroom: space reserved in front of each buffer for bytes carried over from the previous block
+		inline Decompressor::Decompressor(std::string fileName, const size_t threads, const size_t blockBytes, const size_t headroom) :
+			name(fileName), file(fileName, memorymap::Hint::Sequential), blockBytes(std::max<size_t>(blockBytes, 4096)), headroom(headroom), total(SIZE_MAX), claimed(0), consumed(0), returned(0), stop(false) {
+			//pick a decompression loop from the file type (and magic number)
+			const unsigned char * const magic = (const unsigned char *)file.constData();
+			const bool gz = FileType::AngGz == getFileType(fileName);
+			void (Decompressor::*loop)() = NULL;
+			size_t count = 1;//number of decompression threads
+			if(gz) {
+				if(file.size() < 2 || 0x1f != magic[0] || 0x8b != magic[1]) throw std::runtime_error(fileName + " isn't a gzip file");
+				#ifdef TSL_USE_ZLIB
+					loop = &Decompressor::inflateLoop;
+				#else
+					throw std::runtime_error("gzip support is disabled (define TSL_USE_ZLIB before including tsl.hpp)");
+				#endif
+			} else {
+				if(file.size() < 4 || 0x28 != magic[0] || 0xb5 != magic[1] || 0x2f != magic[2] || 0xfd != magic[3]) throw std::runtime_error(fileName + " isn't a zstd file");
+				#ifdef TSL_USE_ZSTD
+					//split the file into frames, multiple frames (e.g. from pzstd or concatenated files) are independent and can be decompressed in parallel
+					//the recorded content sizes give each frame a fixed range of blocks so frames can be written into the ring out of order
+					bool sized = true;
+					size_t blockCount = 0;
+					for(std::uint64_t offset = 0; offset < file.size(); ) {
+						const size_t frameBytes = ZSTD_findFrameCompressedSize(file.constData() + offset, (size_t)(file.size() - offset));
+						if(ZSTD_isError(frameBytes)) throw std::runtime_error(fileName + " has a corrupt zstd frame: " + ZSTD_getErrorName(frameBytes));
+						const unsigned long long content = ZSTD_getFrameContentSize(file.constData() + offset, frameBytes);
+						if(ZSTD_CONTENTSIZE_UNKNOWN == content || ZSTD_CONTENTSIZE_ERROR == content) sized = false;
+						else frames.push_back(Frame{offset, frameBytes, content, blockCount});
+						blockCount += std::max<size_t>(1, (size_t)((content + this->blockBytes - 1) / this->blockBytes));//empty (or skippable) frames still get a block
+						offset += frameBytes;
+					}
+					count = std::min(frames.size(), 0 == threads ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads);
+					if(sized && count > 1) {
+						total = blockCount;
+						loop = &Decompressor::frameLoop;
+					} else {
+						frames.clear();
+						count = 1;
+						loop = &Decompressor::streamLoop;
+					}
+				#else
+					(void)threads;
+					throw std::runtime_error("zstd support is disabled (define TSL_USE_ZSTD before including tsl.hpp)");
+				#endif
+			}
+
+			//allocate the ring and start decompressing
+			blocks.resize(count + 2);//one block in use, one ready, and one being written by each thread
+			for(Block& block : blocks) {
+				block.buffer.reset(new char[this->headroom + this->blockBytes]);//left uninitialized
+				block.data = block.buffer.get() + this->headroom;
+				block.capacity = this->blockBytes;
+				block.bytes = 0;
+				block.index = SIZE_MAX;
+			}
+			for(size_t i = 0; i < count; i++) workers.emplace_back(&Decompressor::guard, this, loop);
+		}
+
+		//@brief: stop decompressing and close the file
+		inline Decompressor::~Decompressor() {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stop = true;
+			}
+			changed.notify_all();
+			for(std::thread& worker : workers) worker.join();
+		}
+
+		//@brief: get the next decompressed block (waiting for it to be decompressed if needed)
+		//@param keep: start of unused bytes at the end of the previous block to place directly in front of the next block (e.g. a partial line), or NULL
+		//@param bytes: location to write the size of the block (including kept bytes)
+		//@return: read only pointer to the block (valid until the next call), or NULL once the entire file has been returned (the previous block stays valid)
+		inline char const * Decompressor::next(char const * keep, size_t& bytes) {
+			bytes = 0;
+
+			//get bytes to carry over from the block in use
+			size_t keepBytes = 0;
+			if(NULL != keep && consumed > 0) {
+				const Block& current = blocks[(consumed - 1) % blocks.size()];
+				if(keep < current.buffer.get() || keep > current.data + current.bytes) throw std::logic_error("kept bytes must be inside the previous block");
+				keepBytes = current.data + current.bytes - keep;
+			}
+
+			//wait for the next block (or the end of the file)
+			std::unique_lock<std::mutex> lock(mutex);
+			Block& block = blocks[consumed % blocks.size()];
+			changed.wait(lock, [&](){return consumed == block.index || consumed >= total || !error.empty();});
+			if(!error.empty()) throw std::runtime_error(error);
+			if(consumed >= total) return NULL;//end of file
+			if(keepBytes > headroom) throw std::runtime_error(name + " has a line longer than the decompression headroom");
+
+			//copy carried over bytes in front of the block, then release the previous block
+			if(keepBytes > 0) std::memmove(block.data - keepBytes, keep, keepBytes);//the previous block's buffer can't be refilled until consumed is incremented
+			bytes = block.bytes + keepBytes;
+			returned += block.bytes;
+			++consumed;
+			lock.unlock();
+			changed.notify_all();
+			return block.data - keepBytes;
+		}
+
+		//@brief: check if every decompressed byte has been returned (waiting for the following blocks to be decompressed if needed)
+		//@return: true if only empty blocks (if any) remain
+		inline bool Decompressor::finished() {
+			std::unique_lock<std::mutex> lock(mutex);
+			for(size_t n = consumed; n + 1 < consumed + blocks.size(); n++) {//blocks that can be written without releasing the block in use
+				const Block& block = blocks[n % blocks.size()];
+				changed.wait(lock, [&](){return n == block.index || n >= total || !error.empty();});
+				if(!error.empty()) throw std::runtime_error(error);
+				if(n >= total) return true;
+				if(0 != block.bytes) return false;
+			}
+			return false;
+		}
+
+		//@brief: wait for the buffer of a block to be released
+		//@param n: index of block to write
+		//@return: buffer to write block into, or NULL if the reader is being destroyed
+		inline Decompressor::Block* Decompressor::acquire(const size_t n) {
+			std::unique_lock<std::mutex> lock(mutex);
+			changed.wait(lock, [&](){return stop || n + 1 < consumed + blocks.size();});//the block in use is consumed - 1
+			if(stop) return NULL;
+			Block& block = blocks[n % blocks.size()];
+			block.index = SIZE_MAX;
+			block.bytes = 0;
+			return &block;
+		}
+
+		//@brief: mark a block as ready to read
+		//@param n: index of block
+		//@param last: true if this is the final block of a streamed file
+		inline void Decompressor::publish(const size_t n, const bool last) {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				blocks[n % blocks.size()].index = n;
+				if(last) total = n + 1;
+			}
+			changed.notify_all();
+		}
+
+		//@brief: decompress a gzip file sequentially (run on the background thread)
+		inline void Decompressor::inflateLoop() {
+		#ifdef TSL_USE_ZLIB
+			z_stream zs = {};
+			if(Z_OK != inflateInit2(&zs, 15 + 32)) throw std::runtime_error("couldn't initialize zlib");//+32 to detect the gzip header
+			std::unique_ptr<z_stream, int(*)(z_stream*)> cleanup(&zs, inflateEnd);
+			const unsigned char * input = (const unsigned char *)file.constData();
+			std::uint64_t remaining = file.size();
+			bool done = false;
+			for(size_t n = 0; !done; n++) {
+				Block * const block = acquire(n);
+				if(NULL == block) return;
+				while(block->bytes < block->capacity) {
+					//feed input (zlib counts are 32 bit)
+					if(0 == zs.avail_in && remaining > 0) {
+						zs.next_in = (Bytef*)input;
+						zs.avail_in = (uInt)std::min<std::uint64_t>(remaining, 1u << 30);
+						input += zs.avail_in;
+						remaining -= zs.avail_in;
+					}
+					zs.next_out = (Bytef*)block->data + block->bytes;
+					zs.avail_out = (uInt)std::min<size_t>(block->capacity - block->bytes, 1u << 30);
+					const uInt before = zs.avail_out;
+					const int status = inflate(&zs, Z_NO_FLUSH);
+					block->bytes += before - zs.avail_out;
+					if(Z_STREAM_END == status) {
+						if(0 == zs.avail_in && 0 == remaining) {
+							done = true;
+							break;
+						}
+						if(Z_OK != inflateReset(&zs)) throw std::runtime_error("couldn't reset zlib");//concatenated gzip members
+					} else if(Z_BUF_ERROR == status && 0 == zs.avail_in && 0 == remaining) {
+						throw std::runtime_error(name + " ended unexpectedly");
+					} else if(Z_OK != status && Z_BUF_ERROR != status) {
+						throw std::runtime_error(name + " couldn't be decompressed: " + (NULL != zs.msg ? zs.msg : "corrupt data"));
+					}
+				}
+				publish(n, done);
+			}
+		#endif
+		}
+
+		//@brief: decompress a zstd file sequentially (run on the background thread)
+		inline void Decompressor::streamLoop() {
+		#ifdef TSL_USE_ZSTD
+			std::unique_ptr<ZSTD_DStream, size_t(*)(ZSTD_DStream*)> stream(ZSTD_createDStream(), ZSTD_freeDStream);
+			if(NULL == stream) throw std::runtime_error("couldn't initialize zstd");
+			ZSTD_inBuffer in = {file.constData(), (size_t)file.size(), 0};
+			size_t status = 1;//nonzero while a frame is incomplete
+			for(size_t n = 0; ; n++) {
+				Block * const block = acquire(n);
+				if(NULL == block) return;
+				ZSTD_outBuffer out = {block->data, block->capacity, 0};
+				while(out.pos < out.size && (in.pos < in.size || 0 != status)) {//keep flushing after the input is consumed until the frame is complete
+					const bool drain = in.pos == in.size;
+					const size_t before = out.pos;
+					status = ZSTD_decompressStream(stream.get(), &out, &in);
+					if(ZSTD_isError(status)) throw std::runtime_error(name + " couldn't be decompressed: " + ZSTD_getErrorName(status));
+					if(drain && before == out.pos && 0 != status) throw std::runtime_error(name + " ended unexpectedly");//nothing left to flush but the frame is incomplete
+				}
+				block->bytes = out.pos;
+				const bool last = 0 == status && in.pos == in.size && out.pos < out.size;//frame is complete and the decoder had space left over
+				publish(n, last);
+				if(last) return;
+			}
+		#endif
+		}
+
+		//@brief: decompress zstd frames in parallel (run on each background thread)
+		inline void Decompressor::frameLoop() {
+		#ifdef TSL_USE_ZSTD
+			std::unique_ptr<ZSTD_DStream, size_t(*)(ZSTD_DStream*)> stream(ZSTD_createDStream(), ZSTD_freeDStream);
+			if(NULL == stream) throw std::runtime_error("couldn't initialize zstd");
+			while(true) {
+				//claim the next frame
+				size_t f;
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					if(stop || claimed == frames.size()) return;
+					f = claimed++;
+				}
+
+				//stream the frame into its range of blocks, the last block holds the remainder of the frame
+				const Frame& frame = frames[f];
+				ZSTD_inBuffer in = {file.constData() + frame.offset, frame.bytes, 0};
+				ZSTD_DCtx_reset(stream.get(), ZSTD_reset_session_only);
+				const size_t last = f + 1 < frames.size() ? frames[f + 1].first - 1 : total - 1;
+				size_t status = 1;//nonzero while the frame is incomplete
+				for(size_t n = frame.first; n <= last; n++) {
+					Block * const block = acquire(n);
+					if(NULL == block) return;
+					ZSTD_outBuffer out = {block->data, n < last ? block->capacity : (size_t)(frame.content - (n - frame.first) * blockBytes), 0};
+					while(out.pos < out.size || (n == last && 0 != status)) {//the last block also finishes the frame (e.g. its checksum)
+						const size_t outBefore = out.pos, inBefore = in.pos;
+						status = ZSTD_decompressStream(stream.get(), &out, &in);
+						if(ZSTD_isError(status)) throw std::runtime_error(name + " couldn't be decompressed: " + ZSTD_getErrorName(status));
+						if(outBefore == out.pos && inBefore == in.pos) throw std::runtime_error(name + (in.pos == in.size ? " ended unexpectedly" : " has a zstd frame larger than its recorded content size"));
+					}
+					block->bytes = out.pos;
+					publish(n, false);
+				}
+			}
+		#endif
+		}
+
+		//@brief: run a decompression loop and record any error for next() to rethrow
+		//@param loop: loop to run
+		inline void Decompressor::guard(void (Decompressor::*loop)()) {
+			try {
+				(this->*loop)();
+			} catch (std::exception& e) {
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					if(error.empty()) error = e.what();
+				}
+				changed.notify_all();
+			}
+		}
+
+		//@brief: reverse the order of pixels in each row of a column
+		//@param data: column to reverse rows of (in file order)
+		//@param header: scan dimensions
+		//@param k: number of components per pixel (e.g. 3 for euler angles)
+		template <typename T> void reverseRows(T * const data, const ScanHeader& header, const size_t k = 1) {
+			for(size_t row = 0; row < header.nRows; row++) {
+				T * const first = data + k * header.rowStart(row);
+				const size_t width = header.rowWidth(row);
+				for(size_t i = 0; i < width / 2; i++) std::swap_ranges(first + k * i, first + k * (i + 1), first + k * (width - 1 - i));
+			}
+		}
+
+	#ifdef TSL_USE_HDF5
+		//owning wrapper for an hdf5 identifier
+		class H5Id {
+			public:
+				//@brief: take ownership of an identifier
+				//@param id: identifier (negative for failed opens)
+				//@param closer: function to close the identifier with
+				H5Id(const hid_t id, herr_t (*closer)(hid_t)) : id(id), closer(closer) {}
+				~H5Id() {if(id >= 0) closer(id);}
+				operator hid_t() const {return id;}
+				bool valid() const {return id >= 0;}
+			private:
+				const hid_t id;
+				herr_t (* const closer)(hid_t);
+				H5Id(H5Id const &) = delete;
+				void operator=(H5Id const &) = delete;
+		};
+
+		//disables hdf5's automatic error printing while in scope (missing datasets are reported with exceptions instead)
+		class H5Quiet {
+			public:
+				H5Quiet() {H5Eget_auto2(H5E_DEFAULT, &func, &data); H5Eset_auto2(H5E_DEFAULT, NULL, NULL);}
+				~H5Quiet() {H5Eset_auto2(H5E_DEFAULT, func, data);}
+			private:
+				H5E_auto2_t func;
+				void*       data;
+		};
+
+		//@brief: check if a group has a link
+		//@param loc: group to check
+		//@param name: name of link
+		//@return: true if the link exists
+		inline bool h5Has(const hid_t loc, const std::string& name) {return H5Lexists(loc, name.c_str(), H5P_DEFAULT) > 0;}
+
+		//@brief: read a scalar dataset
+		//@param loc: group containing dataset
+		//@param name: name of dataset
+		//@param memType: native type to read as (e.g. H5T_NATIVE_FLOAT)
+		//@param value: location to write value
+		//@note: throws if the dataset can't be read
+		template <typename T> void h5Read(const hid_t loc, const std::string& name, const hid_t memType, T& value) {
+			H5Id dset(H5Dopen2(loc, name.c_str(), H5P_DEFAULT), H5Dclose);
+			H5Id space(dset.valid() ? H5Dget_space(dset) : -1, H5Sclose);
+			if(!space.valid() || 1 != H5Sget_simple_extent_npoints(space)) throw std::runtime_error("hdf5 file is missing scalar '" + name + "'");
+			if(H5Dread(dset, memType, H5S_ALL, H5S_ALL, H5P_DEFAULT, &value) < 0) throw std::runtime_error("couldn't read hdf5 dataset '" + name + "'");
+		}
+
+		//@brief: read a string dataset (fixed or variable length)
+		//@param loc: group containing dataset
+		//@param name: name of dataset
+		//@return: string (empty if the dataset doesn't exist)
+		inline std::string h5String(const hid_t loc, const std::string& name) {
+			if(!h5Has(loc, name)) return std::string();
+			H5Id dset(H5Dopen2(loc, name.c_str(), H5P_DEFAULT), H5Dclose);
+			H5Id type(dset.valid() ? H5Dget_type(dset) : -1, H5Tclose);
+			if(!type.valid() || H5T_STRING != H5Tget_class(type)) throw std::runtime_error("hdf5 dataset '" + name + "' isn't a string");
+			H5Id memType(H5Tcopy(H5T_C_S1), H5Tclose);
+			std::string value;
+			if(H5Tis_variable_str(type) > 0) {
+				H5Tset_size(memType, H5T_VARIABLE);
+				char* str = NULL;
+				if(H5Dread(dset, memType, H5S_ALL, H5S_ALL, H5P_DEFAULT, &str) < 0) throw std::runtime_error("couldn't read hdf5 string '" + name + "'");
+				if(NULL != str) value = str;
+				H5free_memory(str);
+			} else {
+				const size_t size = H5Tget_size(type);
+				H5Tset_size(memType, size + 1);//room for the terminator
+				std::vector<char> buff(size + 1, 0);
+				if(H5Dread(dset, memType, H5S_ALL, H5S_ALL, H5P_DEFAULT, buff.data()) < 0) throw std::runtime_error("couldn't read hdf5 string '" + name + "'");
+				value = buff.data();
+			}
+			while(!value.empty() && std::isspace((unsigned char)value.back())) value.pop_back();//strip padding
+			return value;
+		}
+
+		//@brief: read a 1D dataset into a (possibly strided) buffer
+		//@param loc: group containing dataset
+		//@param name: name of dataset
+		//@param memType: native type to read as (hdf5 converts from the file type)
+		//@param buffer: buffer to read into
+		//@param count: maximum number of values to read
+		//@param stride: spacing of values in buffer (e.g. 3 to read one component of euler angle triples)
+		//@return: number of values read
+		inline size_t h5Column(const hid_t loc, const std::string& name, const hid_t memType, void * const buffer, const size_t count, const size_t stride = 1) {
+			H5Id dset(H5Dopen2(loc, name.c_str(), H5P_DEFAULT), H5Dclose);
+			if(!dset.valid()) throw std::runtime_error("hdf5 file is missing dataset '" + name + "'");
+			H5Id fileSpace(H5Dget_space(dset), H5Sclose);
+			const hssize_t available = H5Sget_simple_extent_npoints(fileSpace);
+			const hsize_t n = (hsize_t)std::min<size_t>(count, available < 0 ? 0 : (size_t)available);
+			if(0 == n) return 0;
+			const hsize_t zero = 0, memCount = n * stride, step = stride;
+			H5Id memSpace(H5Screate_simple(1, &memCount, NULL), H5Sclose);
+			H5Sselect_hyperslab(memSpace, H5S_SELECT_SET, &zero, &step, &n, NULL);//every stride'th value of the buffer
+			H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, &zero, NULL, &n, NULL);//the first n values of the dataset
+			if(H5Dread(dset, memType, memSpace, fileSpace, H5P_DEFAULT, buffer) < 0) throw std::runtime_error("couldn't read hdf5 dataset '" + name + "'");
+			return (size_t)n;
+		}
+
+		//@brief: get the name of a link in a group by index
+		//@param loc: group to get link from
+		//@param i: index of link
+		//@return: name of link
+		inline std::string h5LinkName(const hid_t loc, const hsize_t i) {
+			const ssize_t len = H5Lget_name_by_idx(loc, ".", H5_INDEX_NAME, H5_ITER_INC, i, NULL, 0, H5P_DEFAULT);
+			if(len < 0) throw std::runtime_error("couldn't get hdf5 link name");
+			std::vector<char> name(len + 1, 0);
+			H5Lget_name_by_idx(loc, ".", H5_INDEX_NAME, H5_ITER_INC, i, name.data(), name.size(), H5P_DEFAULT);
+			return std::string(name.data());
+		}
+	#endif
+
+		//@brief: update the minimum, maximum, and sum of an array
+		//@param values: values to reduce
+		//@param n: number of values
+		//@param vMin: location of minimum to update
+		//@param vMax: location of maximum to update
+		//@param sum: location of sum to add to
+		//@note: values are summed in double precision (in SIMD lanes where available) so sums of large scans don't drift
+		inline void minMaxSum(float const * const values, const size_t n, float& vMin, float& vMax, double& sum) {
+			size_t i = 0;
+		#if _TSL_SIMD_TYPE_ == _TSL_SIMD_AVX2_
+			if(n >= 8) {
+				__m256  mn = _mm256_set1_ps(vMin), mx = _mm256_set1_ps(vMax);
+				__m256d lo = _mm256_setzero_pd(), hi = _mm256_setzero_pd();
+				for(; i + 8 <= n; i += 8) {
+					const __m256 v = _mm256_loadu_ps(values + i);
+					mn = _mm256_min_ps(mn, v);
+					mx = _mm256_max_ps(mx, v);
+					lo = _mm256_add_pd(lo, _mm256_cvtps_pd(_mm256_castps256_ps128(v)));
+					hi = _mm256_add_pd(hi, _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+				}
+				float lanesMin[8], lanesMax[8];
+				double lanesSum[4];
+				_mm256_storeu_ps(lanesMin, mn);
+				_mm256_storeu_ps(lanesMax, mx);
+				_mm256_storeu_pd(lanesSum, _mm256_add_pd(lo, hi));
+				vMin = *std::min_element(lanesMin, lanesMin + 8);
+				vMax = *std::max_element(lanesMax, lanesMax + 8);
+				sum += (lanesSum[0] + lanesSum[1]) + (lanesSum[2] + lanesSum[3]);
+			}
+		#elif _TSL_SIMD_TYPE_ == _TSL_SIMD_SSE2_
+			if(n >= 4) {
+				__m128  mn = _mm_set1_ps(vMin), mx = _mm_set1_ps(vMax);
+				__m128d lo = _mm_setzero_pd(), hi = _mm_setzero_pd();
+				for(; i + 4 <= n; i += 4) {
+					const __m128 v = _mm_loadu_ps(values + i);
+					mn = _mm_min_ps(mn, v);
+					mx = _mm_max_ps(mx, v);
+					lo = _mm_add_pd(lo, _mm_cvtps_pd(v));
+					hi = _mm_add_pd(hi, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+				}
+				float lanesMin[4], lanesMax[4];
+				double lanesSum[2];
+				_mm_storeu_ps(lanesMin, mn);
+				_mm_storeu_ps(lanesMax, mx);
+				_mm_storeu_pd(lanesSum, _mm_add_pd(lo, hi));
+				vMin = *std::min_element(lanesMin, lanesMin + 4);
+				vMax = *std::max_element(lanesMax, lanesMax + 4);
+				sum += lanesSum[0] + lanesSum[1];
+			}
+		#endif
+			for(; i < n; i++) {//remainder (or everything without SIMD)
+				vMin = std::min(vMin, values[i]);
+				vMax = std::max(vMax, values[i]);
+				sum += values[i];
+			}
+		}
+
+		//@brief: gather values from a column
+		//@param src: column to gather from
+		//@param index: indices of values to gather
+		//@param dst: location to write gathered values
+		//@param n: number of values to gather
+		//@param k: number of components per value (e.g. 3 for euler angles)
+		template <typename T> void gather(T const * const src, std::uint32_t const * const index, T * const dst, const size_t n, const size_t k = 1) {
+			if(1 == k) {
+				for(size_t i = 0; i < n; i++) dst[i] = src[index[i]];
+			} else {
+				for(size_t i = 0; i < n; i++) std::copy(src + k * index[i], src + k * index[i] + k, dst + k * i);
+			}
+		}
+
+		#if _TSL_SIMD_TYPE_ == _TSL_SIMD_AVX2_
+		//@brief: gather single component floats 8 at a time
+		//@note: the hardware gather takes signed indices so groups containing an index of 2^31 or more are gathered one at a time
+		template <> inline void gather(float const * const src, std::uint32_t const * const index, float * const dst, const size_t n, const size_t k) {
+			if(1 != k) {
+				for(size_t i = 0; i < n; i++) std::copy(src + k * index[i], src + k * index[i] + k, dst + k * i);
+				return;
+			}
+			size_t i = 0;
+			for(; i + 8 <= n; i += 8) {
+				const __m256i idx = _mm256_loadu_si256((__m256i const *)(index + i));
+				if(0 == _mm256_movemask_ps(_mm256_castsi256_ps(idx))) {
+					_mm256_storeu_ps(dst + i, _mm256_i32gather_ps(src, idx, 4));
+				} else {
+					for(size_t j = i; j < i + 8; j++) dst[j] = src[index[j]];
+				}
+			}
+			for(; i < n; i++) dst[i] = src[index[i]];
+		}
+		#endif
+
+		//@brief: replace each value of a column with the value of its origin pixel
+		//@param column: column to update (empty columns are skipped)
+		//@param origin: pixel to take each value from
+		//@param points: number of pixels
+		//@param k: number of components per pixel (e.g. 3 for euler angles), the column must hold k * points values
+		//@param planar: true if the components of the column are stored as planes
+		//@param chunks: number of threads to gather with
+		template <typename T> void gatherOrigins(ScanVector<T>& column, std::uint32_t const * const origin, const size_t points, const size_t k, const bool planar, const size_t chunks) {
+			if(column.empty()) return;
+			if(column.size() != k * points) throw std::runtime_error("column size doesn't match scan");
+			const ScanVector<T> previous(column);//each value must be read before it is overwritten
+			const size_t planes = planar ? k : 1, comps = planar ? 1 : k;
+			auto gatherRange = [&](const size_t first, const size_t last) {
+				for(size_t p = 0; p < planes; p++) gather(previous.data() + p * points, origin + first, column.data() + p * points + first * comps, last - first, comps);
+			};
+			if(1 == chunks) {
+				gatherRange(0, points);
+			} else {
+				std::vector<std::thread> workers;
+				for(size_t i = 0; i < chunks; i++) workers.emplace_back(gatherRange, points * i / chunks, points * (i + 1) / chunks);
+				for(std::thread& t : workers) t.join();
+			}
+		}
+
+		//@brief: iterate a neighborhood update until no pixel changes
+		//@param grid: scan geometry
+		//@param origin: pixel each pixel's values are taken from (updated in place)
+		//@param ids: label of each pixel, copied from neighbors along with origin (NULL if unused)
+		//@param threads: number of threads to iterate with (0 to use all hardware threads)
+		//@param iterations: maximum number of iterations (0 for no limit)
+		//@param dirty: dirty(i) returns true if pixel i should be updated
+		//@param choose: choose(i, neighbors, count) returns the neighbor pixel i should copy (SIZE_MAX to leave it unchanged)
+		//@return: iteration counts
+		//@note: rows are split into tiles that each own a contiguous range of pixels, every tile evaluates its queued pixels against the previous iteration's state and stages
+		//       the changes, which are applied once all tiles are evaluated, neighbors of changed pixels are queued for the next iteration (in the owning tile's inbox for tile edges)
+		template <typename Dirty, typename Choose>
+		CleanupResult iterateNeighborhoods(const ScanHeader& grid, std::uint32_t * const origin, std::uint32_t * const ids, const size_t threads, const size_t iterations, Dirty dirty, Choose choose) {
+			//split rows into tiles
+			const size_t totalPoints = grid.numPoints();
+			size_t chunks = 0 == threads ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads;
+			chunks = std::max<size_t>(1, std::min(chunks, grid.nRows));
+			std::vector<size_t> firstPixel(chunks + 1);
+			for(size_t c = 0; c <= chunks; c++) firstPixel[c] = grid.rowStart(grid.nRows * c / chunks);
+			auto owner = [&](const size_t i) {return size_t(std::upper_bound(firstPixel.begin() + 1, firstPixel.end(), i) - firstPixel.begin()) - 1;};
+
+			//get the neighbors of a pixel from its index
+			const size_t neighbors = grid.neighbors();
+			auto neighborsOf = [&](const size_t i, size_t * const nbrs) {
+				const size_t pair = grid.nColsOdd + grid.nColsEven;
+				size_t row = 2 * (i / pair), rem = i % pair;
+				if(rem >= grid.nColsOdd) {
+					++row;
+					rem -= grid.nColsOdd;
+				}
+				const size_t col = grid.rowWidth(row) - 1 - rem;
+				size_t count = 0;
+				for(size_t k = 0; k < neighbors; k++) {
+					const size_t j = grid.neighbor(row, col, k);
+					if(SIZE_MAX != j) nbrs[count++] = j;
+				}
+				return count;
+			};
+
+			//per tile work lists
+			struct Change {std::uint32_t pixel, origin, id;};
+			struct Tile {
+				std::vector<std::uint32_t> queue  ;//pixels to evaluate in the next iteration
+				std::vector<Change       > changes;//changes staged in the current iteration
+				size_t changed = 0, visited = 0   ;//counts over all iterations
+			};
+			std::vector<Tile> tiles(chunks);
+			std::vector<std::vector<std::uint32_t> > inbox(chunks * chunks);//inbox[src * chunks + dst]: pixels of tile dst next to changes in tile src
+			std::vector<std::uint32_t> queued(totalPoints, 0);//last iteration each pixel was queued for (only written by the pixel's tile)
+			auto enqueue = [&](Tile& t, const size_t i, const std::uint32_t it) {
+				if(it == queued[i]) return;
+				queued[i] = it;
+				t.queue.push_back((std::uint32_t)i);
+			};
+
+			//queue all dirty pixels for the first iteration
+			auto seed = [&](const size_t c, const std::uint32_t it) {
+				for(size_t i = firstPixel[c]; i < firstPixel[c+1]; i++) {
+					if(dirty(i)) enqueue(tiles[c], i, it);
+				}
+			};
+
+			//evaluate queued pixels (reads neighbors in other tiles but only writes to this tile)
+			auto evaluate = [&](const size_t c, const std::uint32_t it) {
+				Tile& t = tiles[c];
+				for(size_t s = 0; s < chunks; s++) {//collect halo pixels queued by other tiles
+					std::vector<std::uint32_t>& halo = inbox[s * chunks + c];
+					for(const std::uint32_t i : halo) enqueue(t, i, it);
+					halo.clear();
+				}
+				size_t nbrs[6];
+				for(const std::uint32_t i : t.queue) {
+					if(!dirty(i)) continue;
+					const size_t j = choose(i, (size_t const *)nbrs, neighborsOf(i, nbrs));
+					if(SIZE_MAX != j) t.changes.push_back(Change{i, origin[j], NULL == ids ? 0 : ids[j]});
+				}
+				t.visited += t.queue.size();
+				t.queue.clear();
+			};
+
+			//apply staged changes and queue their neighbors for the next iteration
+			auto apply = [&](const size_t c, const std::uint32_t it) {
+				Tile& t = tiles[c];
+				size_t nbrs[6];
+				for(const Change& ch : t.changes) {
+					origin[ch.pixel] = ch.origin;
+					if(NULL != ids) ids[ch.pixel] = ch.id;
+					const size_t count = neighborsOf(ch.pixel, nbrs);
+					for(size_t k = 0; k < count; k++) {
+						const size_t o = owner(nbrs[k]);
+						if(o == c) enqueue(t, nbrs[k], it + 1);
+						else inbox[c * chunks + o].push_back((std::uint32_t)nbrs[k]);
+					}
+				}
+				t.changed += t.changes.size();
+				t.changes.clear();
+			};
+
+			//run a step on every tile
+			auto step = [&](auto& work, const std::uint32_t it) {
+				if(1 == chunks) {
+					work(0, it);
+				} else {
+					std::vector<std::thread> workers;
+					for(size_t c = 0; c < chunks; c++) workers.emplace_back([&work, c, it](){work(c, it);});
+					for(std::thread& t : workers) t.join();
+				}
+			};
+
+			//iterate until nothing changes
+			CleanupResult result = {0, 0, 0};
+			step(seed, 1);
+			for(std::uint32_t it = 1; 0 == iterations || it <= iterations; it++) {
+				bool pending = false;
+				for(const Tile& t : tiles) pending |= !t.queue.empty();
+				for(const std::vector<std::uint32_t>& halo : inbox) pending |= !halo.empty();
+				if(!pending) break;
+
+				step(evaluate, it);
+				++result.iterations;
+				bool changed = false;
+				for(const Tile& t : tiles) changed |= !t.changes.empty();
+				if(!changed) break;
+				step(apply, it);
+			}
+			for(const Tile& t : tiles) {
+				result.changed += t.changed;
+				result.visited += t.visited;
+			}
+			return result;
+		}
+	}
+
+	//@brief: read a GridType from an input stream
+	//@param is: input stream to read from
+	//@param grid: location to write parsed grid type
+	//@return: input stream read from
+	std::istream& operator>>(std::istream& is, GridType& grid) {
+		std::string name;
+		is >> name;
+		if     (0 == name.compare("SqrGrid")) grid = GridType::Square;
+		else if(0 == name.compare("HexGrid")) grid = GridType::Hexagonal;
+		else grid = GridType::Unknown;
+		return is;
+	}
+
+	//@brief: read a GridType from an output stream
+	//@param os: output stream to write to
+	//@param grid: grid type to write
+	//@return: output stream written to
+	std::ostream& operator<<(std::ostream& os, const GridType& grid) {
+		switch(grid) {
+			case GridType::Square   : return os << "SqrGrid";
+			case GridType::Hexagonal: return os << "HexGrid";
+			default: throw std::runtime_error("unknown grid type");
+		}
+	}
+
+	//@brief: get the type of a file
+	//@param fileName: name to parse extension from
+	//@return: parsed extension
+	FileType getFileType(std::string fileName) {
+		size_t pos = fileName.find_last_of(".");//find the last '.' in the name
+		if(std::string::npos == pos) return FileType::Unknown;//handle files with no extension
+		std::string ext = fileName.substr(pos+1);//extract the file extension
+		std::transform(ext.begin(), ext.end(), ext.begin(), [](char c){return std::tolower(c);});//convert to lowercase
+
+		if     (0 == ext.compare("ang" )) return FileType::Ang;
+		else if(0 == ext.compare("osc" )) return FileType::Osc;
+		else if(0 == ext.compare("hdf" )) return FileType::Hdf;
+		else if(0 == ext.compare("hdf5")) return FileType::Hdf;
+		else if(0 == ext.compare("h5"  )) return FileType::Hdf;
+		else if(0 == ext.compare("angb")) return FileType::Angb;
+		else if(0 == ext.compare("gz"  ) || 0 == ext.compare("zst")) {//compressed files are identified by the extension in front of the compression extension
+			const bool gz = 0 == ext.compare("gz");
+			return FileType::Ang == getFileType(fileName.substr(0, pos)) ? (gz ? FileType::AngGz : FileType::AngZst) : FileType::Unknown;
+		}
+		else return FileType::Unknown;
+	}
+
+	//@brief: compute the number of pixels based on grid type and dimensions
+	//@return: number of pixels in the scan
+	size_t ScanHeader::numPoints() const {
+		switch(gridType) {
+			case GridType::Square: return std::max(nColsOdd, nColsEven) * nRows;
+
+			case GridType::Hexagonal: {
+				size_t totalPoints = size_t(nRows / 2) * (nColsOdd + nColsEven);
+				if(1 == nRows % 2) totalPoints += nColsOdd;
+				return totalPoints;
+			}
+
+			default: throw std::runtime_error("only Square and Hexagonal grid types are supported");
+		}
+	}
+
+	//bookkeeping for a scan arena
+	struct ScanArena::State {
+		typedef std::map<char*, size_t> FreeRanges;
+		std::mutex                            mut    ;//allocations may come from multiple threads (e.g. readMany with a shared arena)
+		std::vector<std::pair<char*, size_t>> blocks ;//allocated blocks and their sizes
+		FreeRanges                            ranges ;//free ranges of the blocks by start address (adjacent ranges of the same block are merged)
+		size_t                                carved ;//total bytes currently carved from all blocks
+		size_t                                live   ;//number of allocations that haven't been freed
+		bool                                  trim   ;//true to free all blocks once nothing is carved from them
+
+		State() : carved(0), live(0), trim(false) {}
+		~State() {freeBlocks();}
+
+		//@brief: free all blocks
+		void freeBlocks() {
+			for(const std::pair<char*, size_t>& b : blocks) detail::alignedFree(b.first);
+			blocks.clear();
+			ranges.clear();
+			carved = 0;
+		}
+
+		//@brief: check if an address is the start of a block (ranges are never merged across blocks)
+		//@param ptr: address to check
+		//@return: true if a block starts at ptr
+		bool blockStart(char const * const ptr) const {
+			for(const std::pair<char*, size_t>& b : blocks) {
+				if(b.first == ptr) return true;
+			}
+			return false;
+		}
+
+		//@brief: find a free range with a number of bytes, allocating a new block if none is big enough (must hold lock)
+		//@param bytes: number of bytes needed
+		//@return: smallest free range that fits
+		//@note: if nothing is carved from the arena existing blocks are coalesced into a single block instead of adding another
+		FreeRanges::iterator ensure(const size_t bytes) {
+			FreeRanges::iterator best = ranges.end();
+			for(FreeRanges::iterator it = ranges.begin(); it != ranges.end(); ++it) {
+				if(it->second >= bytes && (ranges.end() == best || it->second < best->second)) best = it;
+			}
+			if(ranges.end() != best) return best;//enough space already
+			size_t total = bytes;
+			if(0 == live && !blocks.empty()) {//replace all blocks with a single block big enough for everything
+				for(const std::pair<char*, size_t>& b : blocks) total = std::max(total, b.second);
+				freeBlocks();
+			}
+			blocks.emplace_back((char*)detail::alignedAlloc(total), total);
+			return ranges.emplace(blocks.back().first, total).first;
+		}
+
+		//@brief: carve memory from the arena
+		//@param bytes: number of bytes to carve
+		//@return: carved memory (64 byte aligned)
+		void* allocate(size_t bytes) {
+			bytes = detail::arenaBytes(std::max<size_t>(bytes, 1));
+			std::lock_guard<std::mutex> lock(mut);
+			const FreeRanges::iterator it = ensure(bytes);
+			char* const ptr = it->first;
+			const size_t remaining = it->second - bytes;
+			ranges.erase(it);
+			if(remaining > 0) ranges.emplace(ptr + bytes, remaining);
+			carved += bytes;
+			++live;
+			return ptr;
+		}
+
+		//@brief: return carved memory to the arena so later allocations can reuse it
+		//@param ptr: memory to return
+		//@param bytes: number of bytes that were carved
+		void deallocate(void* const ptr, size_t bytes) {
+			bytes = detail::arenaBytes(std::max<size_t>(bytes, 1));
+			std::lock_guard<std::mutex> lock(mut);
+			carved -= bytes;
+			if(0 == --live) {
+				if(trim) {
+					freeBlocks();
+					trim = false;
+				} else {//every block is free again (blocks are coalesced on the next reservation that doesn't fit)
+					ranges.clear();
+					for(const std::pair<char*, size_t>& b : blocks) ranges.emplace(b.first, b.second);
+				}
+				return;
+			}
+
+			//merge with the neighboring free ranges of the same block
+			FreeRanges::iterator it = ranges.emplace((char*)ptr, bytes).first;
+			const FreeRanges::iterator next = std::next(it);
+			if(ranges.end() != next && it->first + it->second == next->first && !blockStart(next->first)) {
+				it->second += next->second;
+				ranges.erase(next);
+			}
+			if(ranges.begin() != it) {
+				const FreeRanges::iterator prev = std::prev(it);
+				if(prev->first + prev->second == it->first && !blockStart(it->first)) {
+					prev->second += it->second;
+					ranges.erase(it);
+				}
+			}
+		}
+	};
+
+	//@brief: construct an empty arena (memory is allocated on first use)
+	ScanArena::ScanArena() : state(std::make_shared<State>()) {}
+
+	//@brief: move an arena
+	//@param other: arena to move from (left holding a new empty arena so it can still be allocated from)
+	ScanArena::ScanArena(ScanArena&& other) noexcept : state(std::make_shared<State>()) {state.swap(other.state);}
+
+	//@brief: move an arena
+	//@param other: arena to move from (left holding a new empty arena so it can still be allocated from)
+	//@return: this
+	ScanArena& ScanArena::operator=(ScanArena&& other) noexcept {
+		if(this != &other) {
+			state = std::move(other.state);
+			other.state = std::make_shared<State>();
+		}
+		return *this;
+	}
+
+	//@brief: make sure a single contiguous block with at least a given number of free bytes is available
+	//@param bytes: number of bytes to reserve
+	//@note: if nothing is currently carved from the arena existing blocks are coalesced into a single block
+	void ScanArena::reserve(const size_t bytes) {
+		if(0 == bytes) return;
+		std::lock_guard<std::mutex> lock(state->mut);
+		state->trim = false;
+		state->ensure(detail::arenaBytes(bytes));
+	}
+
+	//@brief: get the total number of bytes held by the arena
+	//@return: bytes held
+	size_t ScanArena::capacity() const {
+		std::lock_guard<std::mutex> lock(state->mut);
+		size_t bytes = 0;
+		for(const std::pair<char*, size_t>& b : state->blocks) bytes += b.second;
+		return bytes;
+	}
+
+	//@brief: get the number of bytes currently carved from the arena
+	//@return: bytes in use
+	size_t ScanArena::used() const {
+		std::lock_guard<std::mutex> lock(state->mut);
+		return state->carved;
+	}
+
+	//@brief: free all memory held by the arena (deferred until columns currently carved from the arena are freed)
+	void ScanArena::release() {
+		std::lock_guard<std::mutex> lock(state->mut);
+		if(0 == state->live) state->freeBlocks();
+		else state->trim = true;
+	}
+
+	//@brief: allocate uninitialized storage
+	//@param n: number of elements to allocate
+	//@return: pointer to storage (64 byte aligned)
+	template <typename T> T* ScanAllocator<T>::allocate(const size_t n) {
+		if(n > SIZE_MAX / sizeof(T)) throw std::bad_alloc();
+		if(state) return (T*)state->allocate(n * sizeof(T));
+		return (T*)detail::alignedAlloc(detail::arenaBytes(std::max<size_t>(n * sizeof(T), 1)));
+	}
+
+	//@brief: free storage
+	//@param ptr: storage to free
+	//@param n: number of elements in storage
+	template <typename T> void ScanAllocator<T>::deallocate(T* ptr, const size_t n) {
+		if(state) state->deallocate(ptr, n * sizeof(T));
+		else detail::alignedFree(ptr);
+	}
+
+	//@brief: get raw pointers to the scan data
+	//@return: pointers to each column (NULL for unallocated columns)
+	ScanBuffers OrientationMap::buffers() {
+		ScanBuffers buff;
+		buff.eu    = eu   .empty() ? NULL : eu   .data();
+		buff.x     = x    .empty() ? NULL : x    .data();
+		buff.y     = y    .empty() ? NULL : y    .data();
+		buff.iq    = iq   .empty() ? NULL : iq   .data();
+		buff.ci    = ci   .empty() ? NULL : ci   .data();
+		buff.sem   = sem  .empty() ? NULL : sem  .data();
+		buff.fit   = fit  .empty() ? NULL : fit  .data();
+		buff.phase = phase.empty() ? NULL : phase.data();
+		buff.qu    = qu   .empty() ? NULL : qu   .data();
+		buff.quPlane = quPlanar ? qu.size() / 4 : 0;
+		return buff;
+	}
+
+	//@brief: allocate space to hold scan data based on grid type and dimensions
+	//@param tokenCount: number of arrays to use - eu, x, y, iq, ci and phase are always allocated, sem is only allocated for 9+ tokens and fit for 10+
+	//@param requested: columns to allocate (unrequested columns are emptied)
+	void OrientationMap::allocate(const size_t tokenCount, const Column requested) {
+		//compute number of pixels based on dimensions and grid type
+		const size_t totalPoints = numPoints();
+		const Column columns = detail::readColumns(requested);//add columns that requested columns are computed from
+
+		//get the size of each requested column
+		const size_t euCount  = hasColumn(columns, Column::Eu ) ? 3 * totalPoints : 0;
+		const size_t xCount   = hasColumn(columns, Column::X  ) ?     totalPoints : 0;
+		const size_t yCount   = hasColumn(columns, Column::Y  ) ?     totalPoints : 0;
+		const size_t iqCount  = hasColumn(columns, Column::Iq ) ?     totalPoints : 0;
+		const size_t ciCount  = hasColumn(columns, Column::Ci ) ?     totalPoints : 0;
+		const size_t semCount = hasColumn(columns, Column::Sem) && tokenCount > 8 ? totalPoints : 0;
+		const size_t fitCount = hasColumn(columns, Column::Fit) && tokenCount > 9 ? totalPoints : 0;
+		const size_t phsCount = hasColumn(columns, Column::Phase) ? totalPoints : 0;
+		const size_t quCount  = euCount > 0 && (hasColumn(columns, Column::Qu) || hasColumn(columns, Column::QuSoA)) ? 4 * totalPoints : 0;
+		quPlanar = hasColumn(columns, Column::QuSoA);
+
+		//return existing columns to the arena so their memory can be recycled, then reserve a single block for all columns
+		release();
+		size_t bytes = 0;
+		for(const size_t count : {euCount, xCount, yCount, iqCount, ciCount, semCount, fitCount, quCount}) bytes += detail::arenaBytes(count * sizeof(float));
+		bytes += detail::arenaBytes(phsCount * sizeof(size_t));
+		arena.reserve(bytes);
+
+		//carve requested arrays from the arena (left uninitialized since they're about to be overwritten)
+		auto allocColumn = [&](auto& v, const size_t count) {
+			typedef typename std::decay<decltype(v)>::type Vector;
+			v = Vector(typename Vector::allocator_type(arena));
+			resizeUninitialized(v, count);
+		};
+		allocColumn(eu   , euCount );
+		allocColumn(x    , xCount  );
+		allocColumn(y    , yCount  );
+		allocColumn(iq   , iqCount );
+		allocColumn(ci   , ciCount );
+		allocColumn(sem  , semCount);
+		allocColumn(fit  , fitCount);
+		allocColumn(phase, phsCount);
+		allocColumn(qu   , quCount );
+	}
+
+	//@brief: copy the header and columns of an orientation map
+	//@param other: map to copy (columns are carved from this map's arena, which isn't replaced by the source's)
+	//@return: this
+	OrientationMap& OrientationMap::operator=(const OrientationMap& other) {
+		if(this != &other) {
+			ScanHeader::operator=(other);
+			for(ScanVector<float>* v : {&eu, &x, &y, &iq, &ci, &sem, &fit, &qu}) {//carve from this map's arena (columns hold another allocator after copy construction or a move)
+				if(v->get_allocator() != ScanAllocator<float>(arena)) *v = ScanVector<float>(ScanAllocator<float>(arena));
+			}
+			if(phase.get_allocator() != ScanAllocator<size_t>(arena)) phase = ScanVector<size_t>(ScanAllocator<size_t>(arena));
+			eu    = other.eu   ;
+			x     = other.x    ;
+			y     = other.y    ;
+			iq    = other.iq   ;
+			ci    = other.ci   ;
+			sem   = other.sem  ;
+			fit   = other.fit  ;
+			phase = other.phase;
+			qu    = other.qu   ;
+			quPlanar = other.quPlanar;
+		}
+		return *this;
+	}
+
+	//@brief: free all scan columns (their memory is returned to the arena)
+	void OrientationMap::release() {
+		eu   .clear(); eu   .shrink_to_fit();
+		x    .clear(); x    .shrink_to_fit();
+		y    .clear(); y    .shrink_to_fit();
+		iq   .clear(); iq   .shrink_to_fit();
+		ci   .clear(); ci   .shrink_to_fit();
+		sem  .clear(); sem  .shrink_to_fit();
+		fit  .clear(); fit  .shrink_to_fit();
+		phase.clear(); phase.shrink_to_fit();
+		qu   .clear(); qu   .shrink_to_fit();
+	}
+
+	//@brief: get the number of arena bytes carved for the scan columns
+	//@return: bytes held by the allocated columns (including alignment padding)
+	size_t OrientationMap::columnBytes() const {
+		size_t bytes = 0;
+		for(const ScanVector<float>* v : {&eu, &x, &y, &iq, &ci, &sem, &fit, &qu}) bytes += detail::arenaBytes(v->capacity() * sizeof(float));
+		bytes += detail::arenaBytes(phase.capacity() * sizeof(size_t));
+		return bytes;
+	}
+
+	//@brief: compute quaternions from the euler angles (this is done while parsing if Column::Qu or Column::QuSoA is requested)
+	//@param planar: true to store quaternions as 4 planes, false to interleave wxyz
+	//@param threads: number of threads to convert with (0 to use all hardware threads)
+	//@note: quaternions are passive with a non-negative scalar part, following Rowenhorst et al. (2015) with P = +1
+	void OrientationMap::computeQuats(const bool planar, const size_t threads) {
+		//allocate space
+		const size_t count = eu.size() / 3;
+		quPlanar = planar;
+		if(qu.size() != 4 * count) {
+			qu = ScanVector<float>(ScanAllocator<float>(arena));
+			resizeUninitialized(qu, 4 * count);
+		}
+
+		//convert blocks of pixels in parallel
+		static const size_t MinChunkPoints = 64 * 1024;
+		size_t chunks = 0 == threads ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads;
+		chunks = std::max<size_t>(1, std::min<size_t>(chunks, count / MinChunkPoints));
+		auto convert = [&](const size_t i) {
+			const size_t first = count *  i      / chunks;
+			const size_t last  = count * (i + 1) / chunks;
+			detail::eulerToQuat(eu.data(), qu.data(), planar ? count : 0, first, last - first);
+		};
+		if(1 == chunks) {
+			convert(0);
+		} else {
+			std::vector<std::thread> workers;
+			for(size_t i = 0; i < chunks; i++) workers.emplace_back(convert, i);
+			for(std::thread& t : workers) t.join();
+		}
+	}
+
+	//@brief: construct empty statistics
+	//@param lo: lower bound of histogram
+	//@param hi: upper bound of histogram
+	//@param bins: number of histogram bins
+	ColumnStats::ColumnStats(const float lo, const float hi, const size_t bins) : lo(lo), hi(hi), histogram(bins, 0), count(0), sum(0) {
+		if(!(hi > lo)) throw std::runtime_error("column statistics histogram must have hi > lo");
+		clear();
+	}
+
+	//@brief: accumulate values
+	//@param values: values to add
+	//@param n: number of values
+	void ColumnStats::add(float const * const values, const size_t n) {
+		detail::minMaxSum(values, n, min, max, sum);
+		count += n;
+		if(histogram.empty()) return;
+		const float scale = float(histogram.size()) / (hi - lo);
+		const float top = float(histogram.size() - 1);
+		for(size_t i = 0; i < n; i++) {
+			float bin = (values[i] - lo) * scale;
+			bin = bin > 0.0f ? bin : 0.0f;//clamp (NaN goes in the first bin)
+			bin = bin < top ? bin : top;
+			++histogram[(size_t)bin];
+		}
+	}
+
+	//@brief: accumulate another set of statistics
+	//@param other: statistics to merge (must have the same histogram range and bins)
+	void ColumnStats::merge(const ColumnStats& other) {
+		if(lo != other.lo || hi != other.hi || histogram.size() != other.histogram.size()) throw std::runtime_error("can't merge column statistics with different histograms");
+		count += other.count;
+		sum   += other.sum;
+		min = std::min(min, other.min);
+		max = std::max(max, other.max);
+		for(size_t i = 0; i < histogram.size(); i++) histogram[i] += other.histogram[i];
+	}
+
+	//@brief: clear counts (keeping the histogram range and bins)
+	void ColumnStats::clear() {
+		std::fill(histogram.begin(), histogram.end(), 0);
+		count = 0;
+		sum = 0;
+		min =  std::numeric_limits<float>::infinity();
+		max = -std::numeric_limits<float>::infinity();
+	}
+
+	//@brief: accumulate a contiguous range of pixels
+	//@param iq: image quality of first pixel (or NULL to skip)
+	//@param ci: confidence index of first pixel (or NULL to skip)
+	//@param fit: fit of first pixel (or NULL to skip)
+	//@param phase: phase ID of first pixel (or NULL to skip per phase statistics)
+	//@param count: number of pixels
+	void ScanStats::add(float const * const iq, float const * const ci, float const * const fit, size_t const * const phase, const size_t count) {
+		if(NULL != iq ) this->iq .add(iq , count);
+		if(NULL != ci ) this->ci .add(ci , count);
+		if(NULL != fit) this->fit.add(fit, count);
+		if(NULL == phase) return;
+		for(size_t i = 0; i < count; ) {//phases are spatially coherent, so accumulate runs of the same phase with a single lookup
+			size_t j = i + 1;
+			while(j < count && phase[j] == phase[i]) ++j;
+			PhaseStats& stats = phases[phase[i]];
+			stats.pixels += j - i;
+			if(NULL != iq ) stats.iqSum  += std::accumulate(iq  + i, iq  + j, 0.0);
+			if(NULL != ci ) stats.ciSum  += std::accumulate(ci  + i, ci  + j, 0.0);
+			if(NULL != fit) stats.fitSum += std::accumulate(fit + i, fit + j, 0.0);
+			i = j;
+		}
+	}
+
+	//@brief: accumulate another set of statistics
+	//@param other: statistics to merge (must have the same histogram ranges and bins)
+	void ScanStats::merge(const ScanStats& other) {
+		iq .merge(other.iq );
+		ci .merge(other.ci );
+		fit.merge(other.fit);
+		for(const std::pair<const size_t, PhaseStats>& p : other.phases) {
+			PhaseStats& stats = phases[p.first];
+			stats.pixels += p.second.pixels;
+			stats.iqSum  += p.second.iqSum ;
+			stats.ciSum  += p.second.ciSum ;
+			stats.fitSum += p.second.fitSum;
+		}
+	}
+
+	//@brief: clear counts (keeping the histogram ranges and bins)
+	void ScanStats::clear() {
+		iq .clear();
+		ci .clear();
+		fit.clear();
+		phases.clear();
+	}
+
+	//@brief: clear statistics from a previous read but keep the progress hook and scan statistics target
+	void LoadStats::reset() {
+		const size_t rows = progressRows;
+		std::function<void(const size_t, const size_t)> callback = std::move(progress);
+		ScanStats * const target = scanStats;
+		*this = LoadStats();
+		progressRows = rows;
+		progress = std::move(callback);
+		scanStats = target;
+		if(NULL != scanStats) scanStats->clear();
+	}
+
+	//@brief: record a bad line
+	//@param offset: byte offset of the start of the line in the file
+	//@param line: index of the data line
+	//@param problems: problems found in the line
+	void ValidationReport::add(const std::uint64_t offset, const size_t line, const LineProblem problems) {
+		++badLines;
+		if(LineProblem::None != (problems & LineProblem::Tokens  )) ++tokenLines   ;
+		if(LineProblem::None != (problems & LineProblem::Number  )) ++numberLines  ;
+		if(LineProblem::None != (problems & LineProblem::Euler   )) ++eulerLines   ;
+		if(LineProblem::None != (problems & LineProblem::Phase   )) ++phaseLines   ;
+		if(LineProblem::None != (problems & LineProblem::Position)) ++positionLines;
+		if(lines.size() < maxLines) lines.push_back(BadLine{offset, line, problems});
+	}
+
+	//@brief: add problems found in a later part of the same file
+	//@param other: report to add (lines must follow the lines of this report)
+	void ValidationReport::merge(const ValidationReport& other) {
+		pointsRead    += other.pointsRead   ;
+		badLines      += other.badLines     ;
+		tokenLines    += other.tokenLines   ;
+		numberLines   += other.numberLines  ;
+		eulerLines    += other.eulerLines   ;
+		phaseLines    += other.phaseLines   ;
+		positionLines += other.positionLines;
+		const size_t count = std::min(other.lines.size(), maxLines - std::min(maxLines, lines.size()));
+		lines.insert(lines.end(), other.lines.begin(), other.lines.begin() + count);
+	}
+
+	//@brief: clear counts and lines (the line limit is kept)
+	void ValidationReport::clear() {
+		pointsExpected = pointsRead = badLines = tokenLines = numberLines = eulerLines = phaseLines = positionLines = 0;
+		lines.clear();
+	}
+
+	//@brief: list the selected pixels
+	//@param threads: number of threads to list with (0 to use all hardware threads)
+	//@return: indices of selected pixels in increasing order
+	std::vector<size_t> PixelMask::indices(const size_t threads) const {
+		std::vector<size_t> words, offsets;
+		detail::splitMask(bits, threads, 16 * 1024, words, offsets);
+		std::vector<size_t> list(offsets.back());
+		auto fill = [&](const size_t i) {
+			size_t * dst = list.data() + offsets[i];
+			for(size_t w = words[i]; w < words[i+1]; w++) {
+				for(std::uint64_t word = bits[w]; 0 != word; word &= word - 1) *dst++ = 64 * w + detail::countTrailingZeros(word);
+			}
+		};
+		if(1 == words.size() - 1) {
+			fill(0);
+		} else {
+			std::vector<std::thread> workers;
+			for(size_t i = 0; i + 1 < words.size(); i++) workers.emplace_back(fill, i);
+			for(std::thread& t : workers) t.join();
+		}
+		return list;
+	}
+
+	//@brief: select the pixels that pass a filter
+	//@param filter: criteria to select pixels with (the ci / iq / phase columns must have been read for the tests that are used)
+	//@param threads: number of threads to filter with (0 to use all hardware threads)
+	//@return: bitmask of selected pixels
+	PixelMask OrientationMap::select(const PixelFilter& filter, const size_t threads) const {
+		//get the columns needed for the tests
+		const size_t count = numPoints();
+		const bool testCi = filter.minCi > -std::numeric_limits<float>::infinity();
+		const bool testIq = filter.minIq > -std::numeric_limits<float>::infinity();
+		const bool testPhase = !filter.phases.empty();
+		if(testCi    && ci   .size() < count) throw std::runtime_error("filtering by ci requires the ci column");
+		if(testIq    && iq   .size() < count) throw std::runtime_error("filtering by iq requires the iq column");
+		if(testPhase && phase.size() < count) throw std::runtime_error("filtering by phase requires the phase column");
+
+		//test word aligned blocks of pixels in parallel
+		PixelMask mask;
+		mask.points = count;
+		mask.bits.assign((count + 63) / 64, 0);
+		static const size_t MinChunkWords = 4 * 1024;
+		size_t chunks = 0 == threads ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads;
+		chunks = std::max<size_t>(1, std::min<size_t>(chunks, mask.bits.size() / MinChunkWords));
+		std::vector<size_t> selected(chunks, 0);
+		auto test = [&](const size_t i) {
+			const size_t first = mask.bits.size() *  i      / chunks;
+			const size_t last  = mask.bits.size() * (i + 1) / chunks;
+			for(size_t w = first; w < last; w++) {
+				const size_t p = 64 * w;
+				const size_t n = std::min<size_t>(64, count - p);
+				mask.bits[w] = detail::filterWord(testCi ? ci.data() + p : NULL, testIq ? iq.data() + p : NULL, testPhase ? phase.data() + p : NULL, n, filter.minCi, filter.minIq, filter.phases.data(), filter.phases.size());
+				selected[i] += detail::countBits(mask.bits[w]);
+			}
+		};
+		if(1 == chunks) {
+			test(0);
+		} else {
+			std::vector<std::thread> workers;
+			for(size_t i = 0; i < chunks; i++) workers.emplace_back(test, i);
+			for(std::thread& t : workers) t.join();
+		}
+		mask.selected = std::accumulate(selected.begin(), selected.end(), size_t(0));
+		return mask;
+	}
+
+	//@brief: copy the selected pixels into contiguous arrays (so later stages don't need per pixel checks)
+	//@param mask: pixels to copy (from select)
+	//@param threads: number of threads to copy with (0 to use all hardware threads)
+	//@return: selected pixels of every column that was read, in scan order
+	ScanSelection OrientationMap::compact(const PixelMask& mask, const size_t threads) const {
+		//allocate the selected columns
+		const size_t count = numPoints();
+		if(mask.points != count) throw std::runtime_error("pixel mask doesn't match scan size");
+		ScanSelection sel;
+		const size_t n = mask.selected;
+		auto have = [count](const size_t size, const size_t k) {return size >= k * count;};
+		sel.index.resize(n);
+		if(have(eu   .size(), 3)) sel.eu   .resize(3 * n);
+		if(have(x    .size(), 1)) sel.x    .resize(    n);
+		if(have(y    .size(), 1)) sel.y    .resize(    n);
+		if(have(iq   .size(), 1)) sel.iq   .resize(    n);
+		if(have(ci   .size(), 1)) sel.ci   .resize(    n);
+		if(have(sem  .size(), 1)) sel.sem  .resize(    n);
+		if(have(fit  .size(), 1)) sel.fit  .resize(    n);
+		if(have(phase.size(), 1)) sel.phase.resize(    n);
+		if(have(qu   .size(), 4)) sel.qu   .resize(4 * n);
+		sel.quPlanar = quPlanar;
+
+		//each word aligned chunk writes its pixels after the pixels selected in previous chunks (a prefix sum of the per chunk counts)
+		std::vector<size_t> words, offsets;
+		detail::splitMask(mask.bits, threads, 4 * 1024, words, offsets);
+		if(offsets.back() != n) throw std::runtime_error("pixel mask selection count is inconsistent with its bits");
+		auto copy = [&](const size_t i) {
+			const size_t first = words[i], last = words[i+1], o = offsets[i];
+			const std::uint64_t * const bits = mask.bits.data();
+			size_t * dst = sel.index.data() + o;
+			for(size_t w = first; w < last; w++) {
+				for(std::uint64_t word = bits[w]; 0 != word; word &= word - 1) *dst++ = 64 * w + detail::countTrailingZeros(word);
+			}
+			if(!sel.eu   .empty()) detail::compactColumn(eu   .data(), 3, sel.eu   .data() + 3 * o, bits, first, last);
+			if(!sel.x    .empty()) detail::compactColumn(x    .data(), 1, sel.x    .data() +     o, bits, first, last);
+			if(!sel.y    .empty()) detail::compactColumn(y    .data(), 1, sel.y    .data() +     o, bits, first, last);
+			if(!sel.iq   .empty()) detail::compactColumn(iq   .data(), 1, sel.iq   .data() +     o, bits, first, last);
+			if(!sel.ci   .empty()) detail::compactColumn(ci   .data(), 1, sel.ci   .data() +     o, bits, first, last);
+			if(!sel.sem  .empty()) detail::compactColumn(sem  .data(), 1, sel.sem  .data() +     o, bits, first, last);
+			if(!sel.fit  .empty()) detail::compactColumn(fit  .data(), 1, sel.fit  .data() +     o, bits, first, last);
+			if(!sel.phase.empty()) detail::compactColumn(phase.data(), 1, sel.phase.data() +     o, bits, first, last);
+			if(!sel.qu.empty()) {
+				if(quPlanar) {//copy each plane
+					for(size_t j = 0; j < 4; j++) detail::compactColumn(qu.data() + j * count, 1, sel.qu.data() + j * n + o, bits, first, last);
+				} else {
+					detail::compactColumn(qu.data(), 4, sel.qu.data() + 4 * o, bits, first, last);
+				}
+			}
+		};
+		if(1 == words.size() - 1) {
+			copy(0);
+		} else {
+			std::vector<std::thread> workers;
+			for(size_t i = 0; i + 1 < words.size(); i++) workers.emplace_back(copy, i);
+			for(std::thread& t : workers) t.join();
+		}
+		return sel;
+	}
+
+	//@brief: compute global and per phase statistics of the iq, ci, fit, and phase columns
+	//@param stats: statistics to fill (cleared first, the histogram ranges and bins are kept)
+	//@param threads: number of threads to reduce with (0 to use all hardware threads)
+	void OrientationMap::computeStats(ScanStats& stats, const size_t threads) const {
+		//reduce blocks of pixels in parallel
+		stats.clear();
+		const size_t count = numPoints();
+		static const size_t MinChunkPoints = 256 * 1024;
+		size_t chunks = 0 == threads ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads;
+		chunks = std::max<size_t>(1, std::min<size_t>(chunks, count / MinChunkPoints));
+		std::vector<ScanStats> partial(chunks, stats);
+		auto reduce = [&](const size_t i) {
+			const size_t first = count *  i      / chunks;
+			const size_t last  = count * (i + 1) / chunks;
+			partial[i].add(
+				iq   .size() < count ? NULL : iq   .data() + first,
+				ci   .size() < count ? NULL : ci   .data() + first,
+				fit  .size() < count ? NULL : fit  .data() + first,
+				phase.size() < count ? NULL : phase.data() + first,
+				last - first
+			);
+		};
+		if(1 == chunks) {
+			reduce(0);
+		} else {
+			std::vector<std::thread> workers;
+			for(size_t i = 0; i < chunks; i++) workers.emplace_back(reduce, i);
+			for(std::thread& t : workers) t.join();
+		}
+		for(const ScanStats& p : partial) stats.merge(p);
+	}
+
+	//@brief: construct an orientation map from a file
+	//@param fileName: file to read (currently only .ang is supported)
+	//@param threads: number of threads to parse data with (0 to use all hardware threads)
+	//@param columns: columns to read (unrequested columns are left empty and skipped while parsing)
+	//@param stats: location to write load statistics (and progress callback to call), or NULL
+	void OrientationMap::read(std::string fileName, const size_t threads, const Column columns, LoadStats * const stats) {
+		//start collecting statistics
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		size_t minorFaults = 0, majorFaults = 0;
+		if(NULL != stats) {
+			stats->reset();
+			detail::pageFaults(minorFaults, majorFaults);
+		}
+
+		//read data from the file
+		size_t pointsRead = 0;//nothing has been read
+		auto readBinary = [&](const std::string& binaryName, const std::string& source) {
+			pointsRead = readAngb(binaryName, source, columns);
+			if(NULL != stats) {
+				stats->cached = true;
+				stats->bytesScanned = std::filesystem::file_size(binaryName);
+				stats->peakBytes = columnBytes();
+				if(NULL != stats->scanStats) computeStats(*stats->scanStats, threads);
+				stats->parseSeconds = detail::secondsSince(start);
+				if(detail::RowProgress::Enabled(stats)) detail::RowProgress(*stats, nRows).finish();
+			}
+		};
+		switch(getFileType(fileName)) {//dispatch the file to the appropraite reader based on the extension
+			case FileType::Ang: {
+				//prefer an up to date sidecar cache over parsing text
+				try {
+					const std::string sidecar = SidecarName(fileName);
+					if(std::filesystem::exists(sidecar)) {
+						readBinary(sidecar, fileName);
+						break;
+					}
+				} catch (std::exception&) {//stale or corrupt cache (or an unreadable directory), fall back to the ang file
+					phaseList.clear();
+				}
+				pointsRead = readAng(fileName, threads, columns, AngSource::MemMap, stats);
+			} break;
+			case FileType::Angb: readBinary(fileName, std::string()); break;
+			case FileType::AngGz :
+			case FileType::AngZst: pointsRead = readAng(fileName, threads, columns, AngSource::Compressed, stats); break;
+			case FileType::Hdf:
+				#ifdef TSL_USE_HDF5
+					pointsRead = readHdf(fileName, columns);
+					if(NULL != stats && NULL != stats->scanStats) computeStats(*stats->scanStats, threads);
+					break;
+				#else
+					throw std::runtime_error("hdf5 support is disabled (define TSL_USE_HDF5 before including tsl.hpp)");
+				#endif
+			case FileType::Osc: throw std::runtime_error("the .osc reader isn't implemented yet (see the open follow-ups in README.md), export .ang or .h5 from OIM instead");
+			default: throw std::runtime_error("unsupported file type (currently only .ang, .ang.gz, .ang.zst, .angb, and .h5 files are supported)");
+		}
+
+		//finish collecting statistics
+		if(NULL != stats) {
+			size_t minor = 0, major = 0;
+			detail::pageFaults(minor, major);
+			stats->minorFaults = minor - minorFaults;
+			stats->majorFaults = major - majorFaults;
+			stats->totalSeconds = detail::secondsSince(start);
+		}
+
+		//check that enough data was read
+		requirePoints(pointsRead);
+	}
+
+	//@brief: read scan data from a '.ang' file and validate every line instead of throwing for bad data
+	//@param fileName: ang file to read (sidecar caches are ignored since the text is validated)
+	//@param threads: number of threads to parse and validate data with (0 to use all hardware threads)
+	//@param columns: columns to read
+	//@param maxLines: maximum number of bad lines to record in the report
+	//@return: problems found (a truncated file or bad lines are reported instead of thrown, missing points are 0)
+	//@note: each line is bounded to its own text so a short line never takes values from the next line
+	ValidationReport OrientationMap::readValidated(std::string fileName, const size_t threads, const Column columns, const size_t maxLines) {
+		//memory map the file and parse the header (a bad header still throws)
+		if(FileType::Ang != getFileType(fileName)) throw std::runtime_error("only .ang files can be validated");
+		if(!std::filesystem::exists(fileName)) throw std::runtime_error("ang file " + fileName + " doesn't exist");
+		const memorymap::File mapped(fileName, memorymap::Hint::Sequential);
+		char const * const file = mapped.constData();
+		char const * const end = file + mapped.size();
+		size_t offset = 0;
+		const size_t tokenCount = readAngHeader(file, end, offset);
+		allocate(tokenCount, columns);
+		ValidationReport report(maxLines);
+		report.pointsExpected = numPoints();
+		char const * const data = file + offset;
+
+		//take the position of the first point as the grid origin
+		float origin[2] = {0, 0};
+		if(data < end) {
+			float eu[3];
+			ScanBuffers first = {eu, origin, origin + 1, NULL, NULL, NULL, NULL, NULL};
+			detail::readAngLine(data, detail::nextLine(data, end), first, 0, std::min<size_t>(tokenCount, 5));
+		}
+
+		//validate newline aligned chunks in parallel (with a report per chunk)
+		if(data < end) {
+			const std::vector<char const *> bounds = detail::splitLines(data, end, 0 == threads ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads);
+			const size_t chunks = bounds.size() - 1;
+			if(1 == chunks) {
+				validateAngChunk(data, end, 0, tokenCount, file, origin, report);
+			} else {
+				std::vector<size_t> lines(chunks + 1, 0);
+				std::vector<std::thread> workers;
+				for(size_t i = 0; i < chunks; i++) workers.emplace_back([&, i](){lines[i+1] = std::count(bounds[i], bounds[i+1], '\n');});
+				for(std::thread& t : workers) t.join();
+				std::partial_sum(lines.begin(), lines.end(), lines.begin());
+				std::vector<ValidationReport> partial(chunks, ValidationReport(maxLines));
+				workers.clear();
+				for(size_t i = 0; i < chunks; i++) workers.emplace_back([&, i](){validateAngChunk(bounds[i], bounds[i+1], lines[i], tokenCount, file, origin, partial[i]);});
+				for(std::thread& t : workers) t.join();
+				for(const ValidationReport& p : partial) report.merge(p);
+			}
+		}
+
+		//zero points missing from a truncated file
+		if(report.truncated()) {
+			const size_t totalPoints = report.pointsExpected;
+			for(size_t line = report.pointsRead; line < totalPoints; line++) {
+				bool evenRow;
+				size_t completeRowPoints, currentCol;
+				lineToPoint(line, completeRowPoints, currentCol, evenRow);
+				const size_t i = completeRowPoints + currentCol;
+				if(!eu.empty()) std::fill(eu.begin() + 3 * i, eu.begin() + 3 * i + 3, 0.0f);
+				for(ScanVector<float>* c : {&x, &y, &iq, &ci, &sem, &fit}) {
+					if(!c->empty()) (*c)[i] = 0;
+				}
+				if(!phase.empty()) phase[i] = 0;
+			}
+		}
+		if(!qu.empty()) computeQuats(quPlanar, threads);
+		return report;
+	}
+
+	//@brief: read scan data from a '.ang' file with the std::istream based parser instead of the memory mapped parser
+	//@param fileName: ang file to read (sidecar caches are ignored)
+	//@param columns: columns to read
+	void OrientationMap::readStream(std::string fileName, const Column columns) {
+		if(FileType::Ang != getFileType(fileName)) throw std::runtime_error("only .ang files can be read with the stream parser");
+		requirePoints(readAng(fileName, 1, columns, AngSource::Stream));
+	}
+
+	//@brief: read scan data from a '.ang' file with large background reads instead of a memory map
+	//@param fileName: ang file to read (sidecar caches are ignored)
+	//@param threads: number of threads to parse data with (0 to use all hardware threads)
+	//@param columns: columns to read
+	//@param stats: location to write load statistics (and progress callback to call), or NULL
+	void OrientationMap::readBuffered(std::string fileName, const size_t threads, const Column columns, LoadStats * const stats) {
+		if(FileType::Ang != getFileType(fileName)) throw std::runtime_error("only .ang files can be read with background reads");
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		if(NULL != stats) stats->reset();
+		const size_t pointsRead = readAng(fileName, threads, columns, AngSource::ReadAhead, stats);
+		if(NULL != stats) stats->totalSeconds = detail::secondsSince(start);
+		requirePoints(pointsRead);
+	}
+
+	//@brief: check that a complete scan was read
+	//@param pointsRead: number of points read
+	void OrientationMap::requirePoints(const size_t pointsRead) const {
+		const size_t totalPoints = numPoints();
+		if(pointsRead < totalPoints) {
+			std::stringstream ss;
+			ss << "file ended after reading " << pointsRead << " of " << totalPoints << " data points";
+			throw std::runtime_error(ss.str());
+		}
+	}
+
+	//@brief: read a rectangular region from a TSL orientation map file
+	//@param fileName: file to read (.ang files are accessed through a row index, .angb files and up to date sidecars are copied from directly)
+	//@param x0: index of first column to read (in file order)
+	//@param y0: index of first row to read
+	//@param w: number of columns to read (clipped to the width of each row)
+	//@param h: number of rows to read
+	//@param columns: columns to read
+	//@note: the header is updated to describe only the region read (hexagonal reads must start on an even row index so the row offsets line up)
+	void OrientationMap::readRegion(std::string fileName, const size_t x0, const size_t y0, const size_t w, const size_t h, const Column columns) {
+		//open the file, preferring binary data
+		std::unique_ptr<OrientationMapView> view;
+		std::unique_ptr<AngStreamReader> reader;
+		switch(getFileType(fileName)) {
+			case FileType::Angb: view.reset(new OrientationMapView(fileName, false)); break;
+			case FileType::Ang: {
+				try {
+					if(std::filesystem::exists(SidecarName(fileName))) view.reset(new OrientationMapView(fileName, false));
+				} catch (std::exception&) {}//stale or corrupt cache (or an unreadable directory), fall back to the ang file
+				if(!view) reader.reset(new AngStreamReader(fileName, memorymap::Hint::Random));
+			} break;
+			default: throw std::runtime_error("unsupported file type (currently only .ang and .angb files are supported)");
+		}
+		const ScanHeader& source = view ? (const ScanHeader&)*view : (const ScanHeader&)*reader;
+
+		//get the size of the region
+		if(y0 + h > source.nRows || 0 == h) throw std::runtime_error("region rows are outside of scan");
+		if(GridType::Hexagonal == source.gridType && 1 == y0 % 2) throw std::runtime_error("hexagonal regions must start on an even row index so the row offsets line up");
+		auto spanWidth = [&](const size_t row) {//number of columns read from a row
+			const size_t width = source.rowWidth(row);
+			return x0 >= width ? 0 : std::min(w, width - x0);
+		};
+		if(0 == spanWidth(y0)) throw std::runtime_error("region columns are outside of scan");
+
+		//update the header to describe the region
+		*(ScanHeader*)this = source;
+		nRows     = h;
+		nColsOdd  = spanWidth(y0    );
+		nColsEven = spanWidth(y0 + 1 < source.nRows ? y0 + 1 : y0);
+		const size_t tokens = reader ? reader->tokens() : (NULL != view->fit ? 10 : (NULL != view->sem ? 9 : 8));//binary files only have sem/fit columns if the ang did
+		allocate(tokens, columns);
+
+		//copy each row of the region
+		size_t pointsRead = 0;
+		const size_t totalPoints = numPoints();
+		for(size_t row = 0; row < h; row++) {
+			const size_t srcRow = y0 + row;
+			const size_t count = rowWidth(row);
+			if(view) {
+				//columns x0 -> x0+count in file order are stored contiguously (reversed) in both the source and the region
+				const size_t first = source.rowStart(srcRow) + source.rowWidth(srcRow) - x0 - count;
+				auto copySpan = [&](const float* src, ScanVector<float>& dst, const size_t n) {
+					if(NULL != src && !dst.empty()) std::copy(src + first * n, src + (first + count) * n, dst.begin() + pointsRead * n);
+				};
+				copySpan(view->eu , eu , 3);
+				copySpan(view->x  , x  , 1);
+				copySpan(view->y  , y  , 1);
+				copySpan(view->iq , iq , 1);
+				copySpan(view->ci , ci , 1);
+				copySpan(view->sem, sem, 1);
+				copySpan(view->fit, fit, 1);
+				if(NULL != view->phase && !phase.empty()) std::copy(view->phase + first, view->phase + first + count, phase.begin() + pointsRead);
+				if(!qu.empty() && !eu.empty()) detail::eulerToQuat(eu.data(), qu.data(), quPlanar ? totalPoints : 0, pointsRead, count);
+				pointsRead += count;
+			} else {
+				ScanBuffers buff = buffers();
+				if(NULL != buff.eu   ) buff.eu    += 3 * pointsRead;
+				if(NULL != buff.x    ) buff.x     +=     pointsRead;
+				if(NULL != buff.y    ) buff.y     +=     pointsRead;
+				if(NULL != buff.iq   ) buff.iq    +=     pointsRead;
+				if(NULL != buff.ci   ) buff.ci    +=     pointsRead;
+				if(NULL != buff.sem  ) buff.sem   +=     pointsRead;
+				if(NULL != buff.fit  ) buff.fit   +=     pointsRead;
+				if(NULL != buff.phase) buff.phase +=     pointsRead;
+				if(NULL != buff.qu   ) buff.qu    += (0 == buff.quPlane ? 4 : 1) * pointsRead;
+				reader->seekRow(srcRow);
+				const size_t read = reader->readRowSpan(x0, count, buff);
+				pointsRead += read;
+				if(read < count) break;//file ended
+			}
+		}
+
+		//check that enough data was read
+		if(pointsRead < totalPoints) {
+			std::stringstream ss;
+			ss << "file ended after reading " << pointsRead << " of " << totalPoints << " region points";
+			throw std::runtime_error(ss.str());
+		}
+	}
+
+	//@brief: write scan data to a file
+	//@param fileName: file to write (currently only .ang and .angb are supported)
+	//@param threads: number of threads to format data with (0 to use all hardware threads)
+	void OrientationMap::write(std::string fileName, const size_t threads) const {
+		switch(getFileType(fileName)) {//dispatch the file to the appropraite writer based on the extension
+			case FileType::Ang : writeAng (fileName, threads); break;
+			case FileType::Angb: writeAngb(fileName         ); break;
+			default: throw std::runtime_error("unsupported file type (currently only .ang and .angb files are supported)");
+		}
+	}
+
+	//@brief: write scan data to a '.ang' file
+	//@param fileName: name of ang file to write
+	//@param threads: number of threads to format data with (0 to use all hardware threads)
+	void OrientationMap::writeAng(std::string fileName, const size_t threads) const {
+		//make sure the scan data is consistent with the header
+		const size_t totalPoints = numPoints();
+		const bool goodSize = (eu.empty() || eu.size() == 3 * totalPoints) && (x  .empty() || x  .size() == totalPoints) && (y  .empty() || y  .size() == totalPoints)
+		                   && (iq.empty() || iq.size() ==     totalPoints) && (ci .empty() || ci .size() == totalPoints) && (sem.empty() || sem.size() == totalPoints)
+		                   && (fit.empty() || fit.size() ==   totalPoints) && (phase.empty() || phase.size() == totalPoints);
+		if(!goodSize) throw std::runtime_error("scan data size doesn't match header dimensions");
+		const size_t tokens = fit.empty() ? (sem.empty() ? 8 : 9) : 10;
+
+		//format header values
+		std::ostringstream ss;
+		ss << "# TEM_PIXperUM          " << detail::toString(pixPerUm       ) << '\n';
+		ss << "# x-star                " << detail::toString(xStar          ) << '\n';
+		ss << "# y-star                " << detail::toString(yStar          ) << '\n';
+		ss << "# z-star                " << detail::toString(zStar          ) << '\n';
+		ss << "# WorkingDistance       " << detail::toString(workingDistance) << '\n';
+		ss << "#\n";
+
+		//format phases
+		for(const Phase& p : phaseList) {
+			ss << "# Phase " << p.num << '\n';
+			ss << "# MaterialName  \t" << p.name << '\n';
+			ss << "# Formula     \t"   << p.form << '\n';
+			ss << "# Info \t\t"        << p.info << '\n';
+			ss << "# Symmetry              " << p.sym << '\n';
+			ss << "# LatticeConstants      ";
+			for(size_t i = 0; i < 6; i++) ss << (i == 0 ? "" : " ") << detail::toString(p.lat[i]);
+			ss << '\n';
+			ss << "# NumberFamilies        " << p.hklFam.size() << '\n';
+			for(const HKLFamily& f : p.hklFam) ss << "# hklFamilies   \t " << f.hkl[0] << ' ' << f.hkl[1] << ' ' << f.hkl[2] << ' ' << f.useIdx << ' ' << f.intensity << ' ' << f.showBands << '\n';
+			for(size_t i = 0; i < 6; i++) {
+				ss << "# ElasticConstants \t";
+				for(size_t j = 0; j < 6; j++) ss << (j == 0 ? "" : " ") << detail::toString(p.el[6*i+j]);
+				ss << '\n';
+			}
+			ss << "# Categories";//tsl doesn't print space between categories and first number
+			for(size_t i = 0; i < p.cats.size(); i++) ss << (i == 0 ? "" : " ") << p.cats[i];
+			ss << '\n';
+			ss << "#\n";
+		}
+
+		//format grid and scan information
+		ss << "# GRID: "       << gridType << '\n';
+		ss << "# XSTEP: "      << detail::toString(xStep) << '\n';
+		ss << "# YSTEP: "      << detail::toString(yStep) << '\n';
+		ss << "# NCOLS_ODD: "  << nColsOdd  << '\n';
+		ss << "# NCOLS_EVEN: " << nColsEven << '\n';
+		ss << "# NROWS: "      << nRows     << '\n';
+		ss << "#\n";
+		ss << "# OPERATOR: \t" << operatorName << '\n';
+		ss << "#\n";
+		ss << "# SAMPLEID: \t" << sampleId << '\n';
+		ss << "#\n";
+		ss << "# SCANID: \t"   << scanId << '\n';
+		ss << "#\n";
+		const std::string header = ss.str();
+
+		//format blocks of rows in parallel into per thread buffers
+		static const size_t MinChunkPoints = 64 * 1024;
+		size_t chunks = 0 == threads ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads;
+		chunks = std::max<size_t>(1, std::min<size_t>(std::min(chunks, nRows), totalPoints / MinChunkPoints));
+		std::vector<std::string> text(chunks);
+		auto formatChunk = [&](const size_t i) {
+			const size_t first = nRows *  i      / chunks;
+			const size_t last  = nRows * (i + 1) / chunks;
+			text[i].reserve((last - first) * std::max(nColsOdd, nColsEven) * 96);//typical line length
+			formatAngRows(first, last, tokens, text[i]);
+		};
+		if(1 == chunks) {
+			formatChunk(0);
+		} else {
+			std::vector<std::thread> workers;
+			for(size_t i = 0; i < chunks; i++) workers.emplace_back(formatChunk, i);
+			for(std::thread& t : workers) t.join();
+		}
+
+		//write the header and blocks into a presized memory mapped file
+		std::vector<std::uint64_t> offsets(chunks + 1, header.size());
+		for(size_t i = 0; i < chunks; i++) offsets[i+1] = offsets[i] + text[i].size();
+		memorymap::File file(fileName, memorymap::Hint::Sequential, true, offsets.back());
+		char* buff = file.data();
+		std::memcpy(buff, header.data(), header.size());
+		for(size_t i = 0; i < chunks; i++) std::memcpy(buff + offsets[i], text[i].data(), text[i].size());
+	}
+
+	//@brief: format rows of scan data as ang data lines
+	//@param first: index of first row to format
+	//@param last: index of row after the last row to format
+	//@param tokens: number of tokens per point
+	//@param text: location to append formatted lines to
+	//@note: columns that aren't allocated are written as 0 (x and y are computed from the grid instead)
+	void OrientationMap::formatAngRows(const size_t first, const size_t last, const size_t tokens, std::string& text) const {
+		const bool hex = GridType::Hexagonal == gridType;
+		for(size_t row = first; row < last; row++) {
+			const size_t width = rowWidth(row);
+			const size_t start = rowStart(row);
+			for(size_t col = 0; col < width; col++) {
+				const size_t i = start + width - 1 - col;//points are stored from the end of each row
+				const float xi = x.empty() ? xStep * (float(col) + (hex && 1 == row % 2 ? 0.5f : 0.0f)) : x[i];//compute x from grid if needed
+				const float yi = y.empty() ? yStep * float(row) : y[i];//compute y from grid if needed
+				detail::appendToken(text, eu   .empty() ? 0.0f : eu[3*i  ], 10);//format first euler angle
+				detail::appendToken(text, eu   .empty() ? 0.0f : eu[3*i+1], 10);//format second euler angle
+				detail::appendToken(text, eu   .empty() ? 0.0f : eu[3*i+2], 10);//format third euler angle
+				detail::appendToken(text, xi                              , 13);//format x
+				detail::appendToken(text, yi                              , 13);//format y
+				detail::appendToken(text, iq   .empty() ? 0.0f : iq   [i] ,  9);//format image quality
+				detail::appendToken(text, ci   .empty() ? 0.0f : ci   [i] ,  7);//format confidence index
+				detail::appendToken(text, phase.empty() ? 0    : phase[i] ,  3);//format phase
+				if(tokens > 8) detail::appendToken(text, sem.empty() ? 0.0f : sem[i], 7);//format SE signal
+				if(tokens > 9) detail::appendToken(text, fit.empty() ? 0.0f : fit[i], 7);//format fit
+				text.push_back('\n');
+			}
+		}
+	}
+
+	//@brief: write scan data to a binary .angb file
+	//@param fileName: file to write
+	//@param source: file to record the size and modification time of for cache validation (or empty for none)
+	void OrientationMap::writeAngb(std::string fileName, std::string source) const {
+		//serialize header values and phases
+		detail::ByteWriter header;
+		detail::writeAngbHeader(header, *this);
+
+		//build column table
+		struct Column {
+			detail::AngbEntry entry;
+			char const *      data ;
+		};
+		std::vector<Column> columns;
+		columns.push_back(Column{{detail::AngbColumn::Eu   , detail::AngbType::Float32, 0, eu   .size()}, (char const *)eu   .data()});
+		columns.push_back(Column{{detail::AngbColumn::X    , detail::AngbType::Float32, 0, x    .size()}, (char const *)x    .data()});
+		columns.push_back(Column{{detail::AngbColumn::Y    , detail::AngbType::Float32, 0, y    .size()}, (char const *)y    .data()});
+		columns.push_back(Column{{detail::AngbColumn::Iq   , detail::AngbType::Float32, 0, iq   .size()}, (char const *)iq   .data()});
+		columns.push_back(Column{{detail::AngbColumn::Ci   , detail::AngbType::Float32, 0, ci   .size()}, (char const *)ci   .data()});
+		columns.push_back(Column{{detail::AngbColumn::Phase, detail::AngbType::UInt64 , 0, phase.size()}, (char const *)phase.data()});
+		if(!sem.empty()) columns.push_back(Column{{detail::AngbColumn::Sem, detail::AngbType::Float32, 0, sem.size()}, (char const *)sem.data()});
+		if(!fit.empty()) columns.push_back(Column{{detail::AngbColumn::Fit, detail::AngbType::Float32, 0, fit.size()}, (char const *)fit.data()});
+
+		//compute column offsets and file size
+		const std::uint64_t headerEnd = detail::AngbPreambleBytes + header.buff.size() + sizeof(std::uint64_t) + columns.size() * sizeof(detail::AngbEntry);
+		std::uint64_t fileBytes = detail::angbAlign(headerEnd);
+		for(Column& c : columns) {
+			c.entry.offset = fileBytes;
+			fileBytes = detail::angbAlign(fileBytes + c.entry.count * (detail::AngbType::UInt64 == c.entry.type ? 8 : 4));
+		}
+		header.put<std::uint64_t>(columns.size());
+		for(const Column& c : columns) header.put(c.entry);
+
+		//write everything after the preamble (zeroing padding in case an existing file is being overwritten)
+		memorymap::File file(fileName, memorymap::Hint::Sequential, true, fileBytes);
+		char* buff = file.data();
+		std::memcpy(buff + detail::AngbPreambleBytes, header.buff.data(), header.buff.size());
+		std::uint64_t written = headerEnd;
+		for(const Column& c : columns) {
+			std::memset(buff + written, 0, c.entry.offset - written);
+			if(detail::AngbType::UInt64 == c.entry.type && sizeof(size_t) != sizeof(std::uint64_t)) {//phase needs to be widened
+				std::uint64_t* const out = (std::uint64_t*)(buff + c.entry.offset);
+				size_t const * const in = (size_t const *)c.data;
+				std::copy(in, in + c.entry.count, out);
+				written = c.entry.offset + c.entry.count * 8;
+			} else {
+				const std::uint64_t bytes = c.entry.count * (detail::AngbType::UInt64 == c.entry.type ? 8 : 4);
+				std::memcpy(buff + c.entry.offset, c.data, bytes);
+				written = c.entry.offset + bytes;
+			}
+		}
+		std::memset(buff + written, 0, fileBytes - written);
+
+		//write the preamble last
+		std::uint64_t sourceBytes = 0;
+		std::int64_t  sourceTime  = 0;
+		if(!source.empty()) detail::fileStamp(source, sourceBytes, sourceTime);
+		detail::ByteWriter preamble;
+		preamble.put(detail::AngbMagic  );
+		preamble.put(detail::AngbVersion);
+		preamble.put<std::uint32_t>(0   );//reserved
+		preamble.put(sourceBytes        );
+		preamble.put(sourceTime         );
+		preamble.put(detail::checksum(buff + detail::AngbPreambleBytes, fileBytes - detail::AngbPreambleBytes));
+		std::memcpy(buff, preamble.buff.data(), preamble.buff.size());
+	}
+
+	//@brief: read data from a binary '.angb' file
+	//@param fileName: name of angb file to read
+	//@param source: file the angb must have been written from (or empty to skip validation)
+	//@param columns: columns to read
+	//@param verify: true to verify the checksum (touches every page of the file), false to only check the source stamp and column table
+	//@return: number of scan points read from file
+	//@note: throws if the file is corrupt or doesn't match the source
+	size_t OrientationMap::readAngb(std::string fileName, std::string source, const Column columns, const bool verify) {
+		//open memory mapped file and parse the header
+		const memorymap::File mapped(fileName, memorymap::Hint::Sequential);
+		detail::ByteReader reader = detail::openAngb(mapped, fileName, source, verify);
+		detail::readAngbHeader(reader, *this);
+
+		//copy requested columns
+		size_t pointsRead = 0;
+		allocate(0, Column::None);//release existing data
+		const std::vector<detail::AngbEntry> entries = detail::readAngbColumns(reader, mapped.size(), fileName);
+		size_t bytes = 0;
+		for(const detail::AngbEntry& entry : entries) bytes += detail::arenaBytes((size_t)entry.count * sizeof(size_t));//upper bound since phase is the largest type
+		arena.reserve(bytes);//carve all columns from a single block
+		auto attach = [&](auto& v) {
+			typedef typename std::decay<decltype(v)>::type Vector;
+			v = Vector(typename Vector::allocator_type(arena));
+		};
+		attach(eu); attach(x); attach(y); attach(iq); attach(ci); attach(sem); attach(fit); attach(phase);
+		for(const detail::AngbEntry& entry : entries) {
+			char const * const data = mapped.constData() + entry.offset;
+			ScanVector<float>* target = NULL;
+			switch(entry.id) {
+				case detail::AngbColumn::Eu : if(hasColumn(detail::readColumns(columns), Column::Eu)) target = &eu; break;
+				case detail::AngbColumn::X  : if(hasColumn(columns, Column::X  )) target = &x  ; break;
+				case detail::AngbColumn::Y  : if(hasColumn(columns, Column::Y  )) target = &y  ; break;
+				case detail::AngbColumn::Iq : if(hasColumn(columns, Column::Iq )) target = &iq ; pointsRead = (size_t)entry.count; break;
+				case detail::AngbColumn::Ci : if(hasColumn(columns, Column::Ci )) target = &ci ; break;
+				case detail::AngbColumn::Sem: if(hasColumn(columns, Column::Sem)) target = &sem; break;
+				case detail::AngbColumn::Fit: if(hasColumn(columns, Column::Fit)) target = &fit; break;
+				case detail::AngbColumn::Phase: {
+					if(hasColumn(columns, Column::Phase)) {
+						std::uint64_t const * const in = (std::uint64_t const *)data;
+						phase.assign(in, in + entry.count);
+					}
+				} break;
+				default: break;//skip unknown columns
+			}
+			if(NULL != target) {
+				resizeUninitialized(*target, (size_t)entry.count);
+				std::memcpy(target->data(), data, (size_t)entry.count * sizeof(float));
+			}
+		}
+		if(hasColumn(columns, Column::Qu) || hasColumn(columns, Column::QuSoA)) computeQuats(hasColumn(columns, Column::QuSoA));//binary files don't store quaternions
+		return pointsRead;
+	}
+
+	//@brief: build the row index of ang data, or load it from IndexName(fileName) if a saved index is up to date
+	//@param header: parsed header of the ang file
+	//@param data: start of the scan data in memory
+	//@param end: end of the scan data in memory
+	//@param fileName: name of the ang file (empty to skip loading a saved index)
+	AngRowIndex::AngRowIndex(const ScanHeader& header, char const * data, char const * end, std::string fileName) : lineBytes(0), numRows(header.nRows), nOdd(header.nColsOdd), nEven(header.nColsEven) {
+		//check for fixed width lines: the data size must match the first line width and sampled row starts must follow a newline
+		const size_t totalPoints = header.numPoints();
+		char const * const firstEnd = detail::nextLine(data, end);
+		const std::uint64_t width = firstEnd - data;
+		if(firstEnd != end && '\n' == firstEnd[-1] && width * totalPoints == std::uint64_t(end - data)) {
+			bool fixed = true;
+			static const size_t Samples = 64;
+			for(size_t i = 1; i <= Samples && fixed; i++) {
+				const size_t point = totalPoints * i / Samples;//sample evenly spaced lines
+				if('\n' != data[width * point - 1]) fixed = false;
+			}
+			if(fixed) {
+				lineBytes = width;
+				return;
+			}
+		}
+
+		//try to use a saved index
+		if(!fileName.empty() && load(fileName)) return;
+
+		//build the index with a single pass over newlines
+		offsets.resize(numRows + 1, std::uint64_t(end - data));//rows past the end of the file start at the end
+		char const * p = data;
+		for(size_t row = 0; row < numRows && p < end; row++) {
+			offsets[row] = p - data;
+			const size_t width = 0 == row % 2 ? nOdd : nEven;
+			for(size_t col = 0; col < width && p < end; col++) p = detail::nextLine(p, end);
+		}
+		offsets[numRows] = p - data;
+	}
+
+	//@brief: save the row index so future random access to the file can skip building it
+	//@param fileName: name of the ang file the index was built from (the index is written to IndexName(fileName))
+	void AngRowIndex::write(std::string fileName) const {
+		std::uint64_t sourceBytes;
+		std::int64_t  sourceTime;
+		detail::fileStamp(fileName, sourceBytes, sourceTime);
+		detail::ByteWriter writer;
+		writer.put(detail::AngiMagic  );
+		writer.put(detail::AngiVersion);
+		writer.put<std::uint32_t>(0   );//reserved
+		writer.put(sourceBytes        );
+		writer.put(sourceTime         );
+		writer.put(lineBytes          );
+		writer.put<std::uint64_t>(offsets.size());
+		writer.buff.append((char const *)offsets.data(), offsets.size() * sizeof(std::uint64_t));
+		std::ofstream os(IndexName(fileName).c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		if(!os.write(writer.buff.data(), writer.buff.size())) throw std::runtime_error("failed to write row index " + IndexName(fileName));
+	}
+
+	//@brief: try to load a saved index
+	//@param fileName: name of the ang file
+	//@return: true if an up to date index was loaded
+	bool AngRowIndex::load(std::string fileName) {
+		//read the index file
+		std::ifstream is(IndexName(fileName).c_str(), std::ios::in | std::ios::binary);
+		if(!is) return false;
+		const std::string buff((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+
+		//check that the index is up to date
+		try {
+			std::uint64_t bytes;
+			std::int64_t  time;
+			detail::fileStamp(fileName, bytes, time);
+			detail::ByteReader reader(buff.data(), buff.data() + buff.size());
+			reader.require(sizeof(detail::AngiMagic));
+			if(0 != std::memcmp(reader.data, detail::AngiMagic, sizeof(detail::AngiMagic))) return false;
+			reader.data += sizeof(detail::AngiMagic);
+			if(detail::AngiVersion != reader.get<std::uint32_t>()) return false;
+			reader.get<std::uint32_t>();//reserved
+			if(bytes != reader.get<std::uint64_t>()) return false;
+			if(time  != reader.get<std:: int64_t>()) return false;
+			if(0     != reader.get<std::uint64_t>()) return false;//fixed width files don't need an index
+			const std::uint64_t count = reader.get<std::uint64_t>();
+			if(count != numRows + 1) return false;
+			reader.require(count * sizeof(std::uint64_t));
+			offsets.resize((size_t)count);
+			std::memcpy(offsets.data(), reader.data, (size_t)count * sizeof(std::uint64_t));
+		} catch (std::exception&) {
+			offsets.clear();
+			return false;
+		}
+		return true;
+	}
+
+	//@brief: open an ang file and parse the header
+	//@param fileName: name of ang file to read
+	//@param hint: access pattern hint for the memory map (Random for region reads)
+	AngStreamReader::AngStreamReader(std::string fileName, const memorymap::Hint hint) : name(fileName), start(NULL), data(NULL), end(NULL), tokenCount(0), currentRow(0), currentPoint(0), window(0), released(0), prefetched(0) {
+		//memory map the file and parse the header
+		if(!std::filesystem::exists(fileName)) throw std::runtime_error("ang file " + fileName + " doesn't exist");
+		file.reset(new memorymap::File(fileName, hint));
+		end = file->constData() + file->size();
+		size_t offset = 0;//offset to data start
+		tokenCount = readAngHeader(file->constData(), end, offset);//read header and count number of tokens per point
+		numPoints();//make sure the grid type is supported
+		start = data = file->constData() + offset;
+		released = prefetched = offset;
+	}
+
+	//@brief: read the next block of rows into caller provided buffers
+	//@param rows: maximum number of rows to read
+	//@param buffers: buffers to read into (each non NULL buffer must hold at least blockPoints(rows) points), NULL columns are skipped
+	//@return: number of points read (0 once all rows have been read)
+	//@note: points are laid out the same way as in an OrientationMap (relative to the first point of the block)
+	//@note: if the file ends partway through a row the points read from that row are moved to the start of the row (still in reversed column order) so the first 'return value' points are always valid
+	size_t AngStreamReader::readRows(const size_t rows, const ScanBuffers& buffers) {
+		size_t pointsRead = 0;
+		for(size_t r = 0; r < rows && currentRow < nRows && data < end; r++) {
+			const size_t width = 0 == currentRow % 2 ? nColsOdd : nColsEven;//the first row (row 1) is an odd row
+			size_t col = 0;
+			for(; col < width && data < end; col++) {//points are filled from the end of each row
+				data = detail::readAngLine(data, end, buffers, pointsRead + width - 1 - col, tokenCount);//parse the point
+				data = detail::nextLine(data, end);//skip extra tokens / line ending until the end of the line
+			}
+			if(NULL != buffers.qu && NULL != buffers.eu) detail::eulerToQuat(buffers.eu, buffers.qu, buffers.quPlane, pointsRead + width - col, col);//convert the row while it is still in cache
+			currentPoint += col;
+			if(col < width) {//file ended partway through the row, move the points read to the front of the row so the first pointsRead + col slots are valid
+				const size_t from = pointsRead + width - col;
+				auto shift = [&](auto * const buff, const size_t comps) {
+					if(NULL != buff && 0 != col) std::memmove(buff + pointsRead * comps, buff + from * comps, col * comps * sizeof(*buff));
+				};
+				shift(buffers.eu   , 3);
+				shift(buffers.x    , 1);
+				shift(buffers.y    , 1);
+				shift(buffers.iq   , 1);
+				shift(buffers.ci   , 1);
+				shift(buffers.sem  , 1);
+				shift(buffers.fit  , 1);
+				shift(buffers.phase, 1);
+				if(NULL != buffers.qu && NULL != buffers.eu) {
+					if(0 == buffers.quPlane) {
+						shift(buffers.qu, 4);
+					} else {
+						for(size_t k = 0; k < 4; k++) shift(buffers.qu + k * buffers.quPlane, 1);
+					}
+				}
+				return pointsRead + col;
+			}
+			pointsRead += width;
+			++currentRow;
+		}
+		advanceWindow();
+		return pointsRead;
+	}
+
+	//@brief: prefetch ahead of / release behind the current position when a resident window is set
+	void AngStreamReader::advanceWindow() {
+		if(0 == window) return;
+		const size_t position = data - file->constData();
+		const size_t fileBytes = end - file->constData();
+
+		//release data more than a window behind (in batches of a window to limit system calls)
+		if(position < released) released = position;//moved backwards
+		if(position - released >= 2 * window) {
+			file->release(released, position - window - released);
+			released = position - window;
+		}
+
+		//prefetch the next window once half of the previous one is consumed
+		if(prefetched < fileBytes && (prefetched < position + window / 2 || prefetched > position + window)) {
+			file->prefetch(position, window);
+			prefetched = std::min(fileBytes, position + window);
+		}
+	}
+
+	//@brief: read all remaining rows a block at a time into internal buffers
+	//@param rows: number of rows per block
+	//@param columns: columns to read
+	//@param callback: function to call for each block with buffers (NULL for unrequested columns), index of the first point in the block, and number of points in the block
+	void AngStreamReader::readBlocks(const size_t rows, const Column columns, std::function<void(const ScanBuffers&, const size_t, const size_t)> callback) {
+		//allocate block buffers
+		const size_t count = blockPoints(rows);
+		const bool quats = hasColumn(columns, Column::Qu) || hasColumn(columns, Column::QuSoA);
+		std::vector<float > eu   (hasColumn(columns, Column::Eu   ) || quats          ? 3 * count : 0);
+		std::vector<float > x    (hasColumn(columns, Column::X    )                   ?     count : 0);
+		std::vector<float > y    (hasColumn(columns, Column::Y    )                   ?     count : 0);
+		std::vector<float > iq   (hasColumn(columns, Column::Iq   )                   ?     count : 0);
+		std::vector<float > ci   (hasColumn(columns, Column::Ci   )                   ?     count : 0);
+		std::vector<float > sem  (hasColumn(columns, Column::Sem  ) && tokenCount > 8 ?     count : 0);
+		std::vector<float > fit  (hasColumn(columns, Column::Fit  ) && tokenCount > 9 ?     count : 0);
+		std::vector<size_t> phase(hasColumn(columns, Column::Phase)                   ?     count : 0);
+		ScanBuffers buff;
+		buff.eu    = eu   .empty() ? NULL : eu   .data();
+		buff.x     = x    .empty() ? NULL : x    .data();
+		buff.y     = y    .empty() ? NULL : y    .data();
+		buff.iq    = iq   .empty() ? NULL : iq   .data();
+		buff.ci    = ci   .empty() ? NULL : ci   .data();
+		buff.sem   = sem  .empty() ? NULL : sem  .data();
+		buff.fit   = fit  .empty() ? NULL : fit  .data();
+		buff.phase = phase.empty() ? NULL : phase.data();
+		std::vector<float > qu   (quats ? 4 * count : 0);
+		buff.qu      = qu.empty() ? NULL : qu.data();
+		buff.quPlane = hasColumn(columns, Column::QuSoA) ? count : 0;
+
+		//read blocks until the file or scan ends
+		while(true) {
+			const size_t first = currentPoint;
+			const size_t pointsRead = readRows(rows, buff);
+			if(0 == pointsRead) break;
+			callback(buff, first, pointsRead);
+		}
+	}
+
+	//@brief: get the row index of the file (building or loading it if needed)
+	//@return: row index
+	const AngRowIndex& AngStreamReader::index() {
+		if(!rowIndex) rowIndex.reset(new AngRowIndex(*this, start, end, name));
+		return *rowIndex;
+	}
+
+	//@brief: move to the start of a row (building or loading a row index if needed)
+	//@param row: index of row to move to
+	void AngStreamReader::seekRow(const size_t row) {
+		if(row > nRows) throw std::runtime_error("seek past last row of ang file");
+		if(row == currentRow && data != NULL) return;//already there
+		const std::uint64_t offset = index().rowOffset(row);
+		data = start + std::min<std::uint64_t>(offset, end - start);
+		if(data > start && data < end && '\n' != data[-1]) throw std::runtime_error("row index is inconsistent with ang file " + name);
+		currentRow   = row;
+		currentPoint = rowStart(row);
+	}
+
+	//@brief: read part of the current row and move to the start of the next row
+	//@param col: index of first column to read (in file order)
+	//@param count: number of columns to read
+	//@param buffers: buffers to read into (each non NULL buffer must hold at least count points), NULL columns are skipped
+	//@return: number of points read
+	//@note: points are laid out the same way as in an OrientationMap (the last column read is the first point)
+	size_t AngStreamReader::readRowSpan(const size_t col, const size_t count, const ScanBuffers& buffers) {
+		if(currentRow >= nRows) return 0;
+		const size_t width = rowWidth(currentRow);
+		if(col + count > width) throw std::runtime_error("column span extends past end of ang row");
+
+		//skip to the first column
+		const std::uint64_t lineBytes = index().lineWidth();
+		if(0 != lineBytes) {
+			data = start + std::min<std::uint64_t>(index().rowOffset(currentRow) + col * lineBytes, end - start);
+		} else {
+			for(size_t i = 0; i < col && data < end; i++) data = detail::nextLine(data, end);
+		}
+
+		//read the span
+		size_t pointsRead = 0;
+		for(; pointsRead < count && data < end; pointsRead++) {
+			data = detail::readAngLine(data, end, buffers, count - 1 - pointsRead, tokenCount);//parse the point
+			data = detail::nextLine(data, end);//skip extra tokens / line ending until the end of the line
+		}
+		if(NULL != buffers.qu && NULL != buffers.eu) detail::eulerToQuat(buffers.eu, buffers.qu, buffers.quPlane, count - pointsRead, pointsRead);//convert the span while it is still in cache
+
+		//move to the next row
+		data = NULL;//invalidate position so the seek isn't skipped
+		seekRow(currentRow + 1);
+		return pointsRead;
+	}
+
+	//@brief: start tailing an ang file (the header is parsed once it has been completely written)
+	//@param fileName: name of ang file to tail
+	//@param threads: number of threads to parse new lines with (0 to use all hardware threads)
+	//@param columns: columns to read
+	AngTailReader::AngTailReader(std::string fileName, const size_t threads, const Column columns) : name(fileName), threads(threads), columns(columns), tokenCount(0), offset(0), points(0) {
+		if(!std::filesystem::exists(fileName)) throw std::runtime_error("ang file " + fileName + " doesn't exist");
+		refresh();
+	}
+
+	//@brief: parse lines appended to the file since the previous refresh
+	//@param final: true if the file won't be written anymore (a trailing line without a newline is parsed instead of waiting for the rest of it)
+	//@return: number of new points parsed
+	//@note: throws if the file shrinks (e.g. it is being overwritten by a new scan)
+	size_t AngTailReader::refresh(const bool final) {
+		//don't remap the file if nothing has been appended
+		if(complete()) return 0;
+		const std::uint64_t bytes = std::filesystem::file_size(name);
+		if(bytes < offset) throw std::runtime_error("ang file " + name + " shrank while being read");
+		if(bytes == offset) return 0;
+		const memorymap::File file(name, memorymap::Hint::Sequential);
+		char const * const data = file.constData();
+		char const * const end = data + file.size();
+
+		//parse the header once it is complete (the first data line is needed to count tokens)
+		if(!ready()) {
+			char const * line = data;
+			while(line < end && '#' == *line) {
+				line = std::find(line, end, '\n');
+				if(line < end) ++line;
+			}
+			if(line == end || (!final && end == std::find(line, end, '\n'))) return 0;//the header or first data line may still be growing
+			size_t dataStart = 0;
+			tokenCount = om.readAngHeader(data, end, dataStart);
+			om.allocate(tokenCount, columns);
+			ScanBuffers buff = om.buffers();//points that haven't been acquired yet read as 0 / unindexed
+			for(float * column : {buff.eu, buff.x, buff.y, buff.iq, buff.ci, buff.sem, buff.fit}) if(NULL != column) std::fill(column, column + (buff.eu == column ? 3 : 1) * om.numPoints(), 0.0f);
+			if(!om.qu.empty()) std::fill(om.qu.begin(), om.qu.end(), 0.0f);
+			if(!om.phase.empty()) std::fill(om.phase.begin(), om.phase.end(), 0);
+			offset = dataStart;
+		}
+
+		//parse complete lines (the final line may still be being written unless this is the final refresh)
+		char const * const first = data + offset;
+		char const * last = end;
+		if(!final) while(last > first && '\n' != last[-1]) --last;
+		const size_t pointsRead = om.readAngDataMemMap(first, last, tokenCount, threads, NULL, points);
+		points += pointsRead;
+		offset = last - data;
+		return pointsRead;
+	}
+
+	//@brief: get the number of complete rows read so far
+	//@return: number of rows
+	size_t AngTailReader::rowsRead() const {
+		if(!ready()) return 0;
+		const size_t pairPoints = om.nColsOdd + om.nColsEven;
+		return 2 * (points / pairPoints) + (points % pairPoints >= om.nColsOdd ? 1 : 0);
+	}
+
+	//@brief: compute the header of a montage that covers a set of tiles
+	//@param tiles: headers of the tiles (e.g. from an AngStreamReader, which only parses the header until rows are read)
+	//@param at: position of each tile
+	//@return: header of the smallest montage containing every tile (calibration, names, and phases are copied from the first tile)
+	//@note: all tiles must have the same grid type and step sizes
+	ScanHeader MontageBuilder::Layout(const std::vector<ScanHeader>& tiles, const std::vector<MontageTile>& at) {
+		if(tiles.empty()) throw std::runtime_error("a montage needs at least one tile");
+		if(tiles.size() != at.size()) throw std::runtime_error("each montage tile needs a position");
+		ScanHeader header = tiles.front();
+		header.nColsOdd = header.nColsEven = header.nRows = 0;
+		for(size_t i = 0; i < tiles.size(); i++) {
+			size_t col, row;
+			Locate(header, tiles[i], at[i], col, row);
+			header.nRows    = std::max(header.nRows   , row + tiles[i].nRows   );
+			header.nColsOdd = std::max(header.nColsOdd, col + tiles[i].nColsOdd);
+			if(tiles[i].nRows > 1) header.nColsEven = std::max(header.nColsEven, col + tiles[i].nColsEven);
+		}
+		if(GridType::Hexagonal == header.gridType) {//even rows are a pixel shorter
+			header.nColsOdd  = std::max(header.nColsOdd, header.nColsEven + 1);
+			header.nColsEven = header.nColsOdd - 1;
+		} else {
+			header.nColsOdd = header.nColsEven = std::max(header.nColsOdd, header.nColsEven);
+		}
+		return header;
+	}
+
+	//@brief: allocate an empty montage
+	//@param header: geometry of the montage (see Layout)
+	//@param columns: columns to assemble
+	//@param threads: number of threads to initialize the columns with (0 to use all hardware threads)
+	//@note: pixels that no tile covers are 0 (phase 0 is unindexed) with x/y computed from the grid
+	MontageBuilder::MontageBuilder(const ScanHeader& header, const Column columns, const size_t threads) : columns(columns) {
+		static_cast<ScanHeader&>(om) = header;
+		om.allocate(10, columns);//sem and fit are kept if requested
+
+		//zero fill blocks of rows and compute coordinates from the grid
+		const bool hex = GridType::Hexagonal == om.gridType;
+		auto fillRows = [&](const size_t first, const size_t last) {
+			const size_t i0 = om.rowStart(first), i1 = om.rowStart(last);
+			if(!om.eu.empty()) std::fill(om.eu.begin() + 3 * i0, om.eu.begin() + 3 * i1, 0.0f);
+			for(ScanVector<float>* c : {&om.iq, &om.ci, &om.sem, &om.fit}) {
+				if(!c->empty()) std::fill(c->begin() + i0, c->begin() + i1, 0.0f);
+			}
+			if(!om.phase.empty()) std::fill(om.phase.begin() + i0, om.phase.begin() + i1, size_t(0));
+			if(!om.qu.empty()) {
+				const ScanBuffers b = buffers(i0);
+				detail::eulerToQuat(b.eu, b.qu, b.quPlane, 0, i1 - i0);//identity quaternions for the zeroed euler angles
+			}
+			for(size_t row = first; row < last; row++) {
+				for(size_t col = 0; col < om.rowWidth(row); col++) {
+					const size_t i = om.index(row, col);
+					if(!om.x.empty()) om.x[i] = om.xStep * (col + (hex && 1 == row % 2 ? 0.5f : 0.0f));
+					if(!om.y.empty()) om.y[i] = om.yStep * row;
+				}
+			}
+		};
+		size_t chunks = 0 == threads ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads;
+		chunks = std::max<size_t>(1, std::min(chunks, om.nRows));
+		if(1 == chunks) {
+			fillRows(0, om.nRows);
+		} else {
+			std::vector<std::thread> workers;
+			for(size_t i = 0; i < chunks; i++) workers.emplace_back(fillRows, om.nRows * i / chunks, om.nRows * (i + 1) / chunks);
+			for(std::thread& t : workers) t.join();
+		}
+	}
+
+	//@brief: copy a tile into the montage
+	//@param tile: scan to copy (must have the grid type and step sizes of the montage), columns the tile doesn't have are left as is
+	//@param at: position of the tile
+	//@param threads: number of threads to copy with (0 to use all hardware threads), rows are split between threads
+	//@note: x/y are translated so the tile's first pixel lands on its grid position and phase IDs are copied as is (tiles should share a phase list)
+	//@note: pixels covered by more than one tile take the values of the last tile placed
+	void MontageBuilder::place(const OrientationMap& tile, const MontageTile& at, const size_t threads) {
+		size_t col0, row0;
+		position(tile, at, col0, row0);
+		if(0 == tile.nRows) return;
+
+		//translation from tile to montage coordinates (based on the tile's first pixel)
+		const size_t first = tile.index(0, 0);
+		const float dx = om.xStep * col0 - (tile.x.empty() ? 0.0f : tile.x[first]);
+		const float dy = om.yStep * row0 - (tile.y.empty() ? 0.0f : tile.y[first]);
+
+		//copy each row of a block as a contiguous span (rows are stored in the same reversed order in both scans)
+		auto copyRows = [&](const size_t firstRow, const size_t lastRow) {
+			for(size_t r = firstRow; r < lastRow; r++) {
+				const size_t width = tile.rowWidth(r);
+				if(0 == width) continue;
+				const size_t src = tile.rowStart(r);
+				const size_t dst = om.index(row0 + r, col0 + width - 1);
+				auto copy = [&](const auto& from, auto& to, const size_t k) {
+					if(!from.empty() && !to.empty()) std::copy(from.begin() + k * src, from.begin() + k * (src + width), to.begin() + k * dst);
+				};
+				copy(tile.eu   , om.eu   , 3);
+				copy(tile.iq   , om.iq   , 1);
+				copy(tile.ci   , om.ci   , 1);
+				copy(tile.sem  , om.sem  , 1);
+				copy(tile.fit  , om.fit  , 1);
+				copy(tile.phase, om.phase, 1);
+				if(!tile.x.empty() && !om.x.empty()) std::transform(tile.x.begin() + src, tile.x.begin() + src + width, om.x.begin() + dst, [dx](const float v){return v + dx;});
+				if(!tile.y.empty() && !om.y.empty()) std::transform(tile.y.begin() + src, tile.y.begin() + src + width, om.y.begin() + dst, [dy](const float v){return v + dy;});
+				if(!om.qu.empty() && !tile.eu.empty()) {
+					const ScanBuffers b = buffers(dst);
+					detail::eulerToQuat(b.eu, b.qu, b.quPlane, 0, width);
+				}
+			}
+		};
+		size_t chunks = 0 == threads ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads;
+		chunks = std::max<size_t>(1, std::min(chunks, tile.nRows));
+		if(1 == chunks) {
+			copyRows(0, tile.nRows);
+		} else {
+			std::vector<std::thread> workers;
+			for(size_t i = 0; i < chunks; i++) workers.emplace_back(copyRows, tile.nRows * i / chunks, tile.nRows * (i + 1) / chunks);
+			for(std::thread& t : workers) t.join();
+		}
+	}
+
+	//@brief: stream an ang file into the montage (each row is parsed directly into its final position)
+	//@param fileName: ang file to read
+	//@param at: position of the tile
+	//@note: only a window of the file is kept resident while reading (see AngStreamReader::residentWindow)
+	void MontageBuilder::place(std::string fileName, const MontageTile& at) {
+		AngStreamReader reader(fileName);
+		size_t col0, row0;
+		position(reader, at, col0, row0);
+		streamRows(reader, fileName, col0, row0);
+	}
+
+	//@brief: parse the rows of an opened ang file into the montage
+	//@param reader: reader positioned at the first row of the tile
+	//@param fileName: name of the tile file (for error messages)
+	//@param col0: index of the montage column that the first column of the tile lands on
+	//@param row0: index of the montage row that the first row of the tile lands on
+	void MontageBuilder::streamRows(AngStreamReader& reader, const std::string& fileName, const size_t col0, const size_t row0) {
+		static const size_t Window = 32 * 1024 * 1024;//resident bytes of the tile file
+		reader.residentWindow(Window);
+
+		//parse each row into its span of the montage
+		float dx = 0, dy = 0;
+		for(size_t r = 0; r < reader.nRows; r++) {
+			const size_t width = reader.rowWidth(r);
+			if(0 == width) continue;
+			const size_t dst = om.index(row0 + r, col0 + width - 1);
+			ScanBuffers b = buffers(dst);
+			if(reader.tokens() < 9) b.sem = NULL;//leave columns the tile doesn't have as is
+			if(reader.tokens() < 10) b.fit = NULL;
+			if(reader.readRows(1, b) < width) {
+				std::stringstream ss;
+				ss << fileName << " ended after reading " << reader.pointsRead() << " of " << reader.numPoints() << " data points";
+				throw std::runtime_error(ss.str());
+			}
+
+			//translate coordinates (based on the tile's first pixel)
+			if(0 == r) {
+				if(NULL != b.x) dx = om.xStep * col0 - b.x[width - 1];
+				if(NULL != b.y) dy = om.yStep * row0 - b.y[width - 1];
+			}
+			for(size_t i = 0; i < width; i++) {
+				if(NULL != b.x) b.x[i] += dx;
+				if(NULL != b.y) b.y[i] += dy;
+			}
+		}
+	}
+
+	//@brief: place tiles from many files
+	//@param fileNames: files to read
+	//@param at: position of each tile
+	//@param threads: number of threads to read with (0 to use all hardware threads)
+	//@param stream: true to stream tiles with one file per thread (non .ang tiles are read whole and then copied), false to read whole tiles with readMany and copy each as it is completed
+	//@note: tiles are placed concurrently, overlapping tiles are placed one at a time but in no particular order so shared pixels take the values of whichever tile is placed last (use place() in order to control overlaps)
+	void MontageBuilder::placeFiles(const std::vector<std::string>& fileNames, const std::vector<MontageTile>& at, const size_t threads, const bool stream) {
+		if(fileNames.size() != at.size()) throw std::runtime_error("each montage tile needs a position");
+		if(!stream) {//readMany serializes its callbacks
+			readMany(fileNames, [&](size_t i, OrientationMap& tile){place(tile, at[i]);}, threads, columns);
+			return;
+		}
+
+		//montage rectangles of the tiles currently being written (a tile waits for overlapping tiles to finish before writing)
+		struct Region {
+			size_t row0, row1, col0, col1;//half open row / column ranges
+			bool overlaps(const Region& other) const {return row0 < other.row1 && other.row0 < row1 && col0 < other.col1 && other.col0 < col1;}
+		};
+		std::list<Region> active;
+		std::mutex regionMutex;
+		std::condition_variable regionFree;
+		auto claim = [&](const ScanHeader& tile, const size_t col0, const size_t row0) {
+			const Region region = {row0, row0 + tile.nRows, col0, col0 + std::max(tile.nColsOdd, tile.nColsEven)};
+			std::unique_lock<std::mutex> lock(regionMutex);
+			regionFree.wait(lock, [&](){return std::none_of(active.begin(), active.end(), [&region](const Region& r){return r.overlaps(region);});});
+			return active.insert(active.end(), region);
+		};
+		auto release = [&](const std::list<Region>::iterator region) {
+			{
+				std::lock_guard<std::mutex> lock(regionMutex);
+				active.erase(region);
+			}
+			regionFree.notify_all();
+		};
+
+		//stream files from a shared queue
+		std::atomic<size_t> next(0);
+		std::mutex errorMutex;
+		std::exception_ptr error;
+		auto work = [&]() {
+			for(size_t i = next++; i < fileNames.size(); i = next++) {
+				try {
+					size_t col0, row0;
+					if(FileType::Ang == getFileType(fileNames[i])) {
+						AngStreamReader reader(fileNames[i]);
+						position(reader, at[i], col0, row0);
+						const std::list<Region>::iterator region = claim(reader, col0, row0);
+						try {
+							streamRows(reader, fileNames[i], col0, row0);
+						} catch (...) {
+							release(region);
+							throw;
+						}
+						release(region);
+					} else {
+						OrientationMap tile;
+						tile.read(fileNames[i], 1, columns);
+						position(tile, at[i], col0, row0);
+						const std::list<Region>::iterator region = claim(tile, col0, row0);
+						try {
+							place(tile, at[i]);
+						} catch (...) {
+							release(region);
+							throw;
+						}
+						release(region);
+					}
+				} catch (...) {//keep placing the remaining tiles, the first error is rethrown afterwards
+					std::lock_guard<std::mutex> lock(errorMutex);
+					if(!error) error = std::current_exception();
+				}
+			}
+		};
+		size_t workers = 0 == threads ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads;
+		workers = std::max<size_t>(1, std::min(workers, fileNames.size()));
+		if(1 == workers) {
+			work();
+		} else {
+			std::vector<std::thread> pool;
+			for(size_t i = 0; i < workers; i++) pool.emplace_back(work);
+			for(std::thread& t : pool) t.join();
+		}
+		if(error) std::rethrow_exception(error);
+	}
 
-			default: throw std::runtime_error("only Square and Hexagonal grid types are supported");
+	//@brief: find the grid position of a tile
+	//@param montage: montage geometry
+	//@param tile: tile geometry
+	//@param at: position of the tile
+	//@param col: location to write index of the montage column that the first column of the tile lands on
+	//@param row: location to write index of the montage row that the first row of the tile lands on
+	void MontageBuilder::Locate(const ScanHeader& montage, const ScanHeader& tile, const MontageTile& at, size_t& col, size_t& row) {
+		if(tile.gridType != montage.gridType) throw std::runtime_error("montage tiles must have the same grid type");
+		if(!(montage.xStep > 0) || !(montage.yStep > 0)) throw std::runtime_error("a montage requires positive step sizes");
+		if(std::fabs(tile.xStep - montage.xStep) > 1e-4f * montage.xStep || std::fabs(tile.yStep - montage.yStep) > 1e-4f * montage.yStep) {
+			throw std::runtime_error("montage tiles must have the same step sizes (resample tiles with different steps first)");
 		}
+		const float c = std::round(at.x / montage.xStep), r = std::round(at.y / montage.yStep);
+		if(!(c >= 0) || !(r >= 0)) throw std::runtime_error("montage tile positions must be non-negative");
+		col = (size_t)c;
+		row = (size_t)r;
+		if(GridType::Hexagonal == montage.gridType && 1 == row % 2) throw std::runtime_error("hexagonal montage tiles must start on an even row index so the row offsets line up");
+	}
 
-		//allocate arrays (filling new space with zero)
-		eu   .resize(3*totalPoints);
-		x    .resize(  totalPoints);
-		y    .resize(  totalPoints);
-		iq   .resize(  totalPoints);
-		ci   .resize(  totalPoints);
-		phase.resize(  totalPoints);
-		if(tokenCount > 8) sem.resize(totalPoints);
-		if(tokenCount > 9) fit.resize(totalPoints);
+	//@brief: find the grid position of a tile and check that it fits in the montage
+	//@param tile: tile geometry
+	//@param at: position of the tile
+	//@param col: location to write index of the montage column that the first column of the tile lands on
+	//@param row: location to write index of the montage row that the first row of the tile lands on
+	void MontageBuilder::position(const ScanHeader& tile, const MontageTile& at, size_t& col, size_t& row) const {
+		Locate(om, tile, at, col, row);
+		const bool fits = row + tile.nRows <= om.nRows && col + tile.nColsOdd <= om.nColsOdd && (tile.nRows < 2 || col + tile.nColsEven <= om.nColsEven);
+		if(!fits) throw std::runtime_error("montage tile extends past the edge of the montage");
 	}
 
-	//@brief: construct an orientation map from a file
-	//@param fileName: file to read (currently only .ang is supported)
-	void OrientationMap::read(std::string fileName) {
-		//read data from the file
-		size_t pointsRead = 0;//nothing has been read
-		switch(getFileType(fileName)) {//dispatch the file to the appropraite reader based on the extension
-			case FileType::Ang: pointsRead = readAng(fileName);;
-			default: std::runtime_error("unsupported file type (currently only .ang files are supported)");
+	//@brief: get pointers into the montage columns
+	//@param i: index of first pixel
+	//@return: buffers starting at pixel i (NULL for unallocated columns)
+	ScanBuffers MontageBuilder::buffers(const size_t i) {
+		ScanBuffers b = om.buffers();
+		for(float** c : {&b.x, &b.y, &b.iq, &b.ci, &b.sem, &b.fit}) {
+			if(NULL != *c) *c += i;
 		}
+		if(NULL != b.eu   ) b.eu    += 3 * i;
+		if(NULL != b.phase) b.phase += i;
+		if(NULL != b.qu   ) b.qu    += 0 == b.quPlane ? 4 * i : i;
+		return b;
+	}
 
-		//check that enough data was read
-		if(pointsRead < iq.size()) {//I'll compare against IQ since it is always present (and easier than comparing against euler angles)
-			std::stringstream ss;
-			ss << "file ended after reading " << pointsRead << " of " << iq.size() << " data points";
-			throw std::runtime_error(ss.str());
+	//@brief: construct a view of a binary file
+	//@param fileName: .angb file to view, or .ang file to view the up to date sidecar of
+	//@param verify: true to verify the checksum (touches every page of the file), false to skip verification
+	OrientationMapView::OrientationMapView(std::string fileName, const bool verify) : eu(NULL), x(NULL), y(NULL), iq(NULL), ci(NULL), sem(NULL), fit(NULL), phase(NULL), points(0) {
+		//get the binary file name
+		std::string source;//file the binary must be up to date with (if any)
+		switch(getFileType(fileName)) {
+			case FileType::Angb: break;
+			case FileType::Ang : source = fileName; fileName = OrientationMap::SidecarName(fileName); break;
+			default: throw std::runtime_error("unsupported file type (only .angb files and .ang files with a sidecar cache can be viewed)");
+		}
+
+		//open memory mapped file and parse the header
+		file = std::make_shared<const memorymap::File>(fileName, memorymap::Hint::Normal);
+		detail::ByteReader reader = detail::openAngb(*file, fileName, source, verify);
+		detail::readAngbHeader(reader, *this);
+
+		//point columns into the mapping
+		for(const detail::AngbEntry& entry : detail::readAngbColumns(reader, file->size(), fileName)) {
+			char const * const data = file->constData() + entry.offset;
+			switch(entry.id) {
+				case detail::AngbColumn::Eu   : eu    = (float         const *)data; break;
+				case detail::AngbColumn::X    : x     = (float         const *)data; break;
+				case detail::AngbColumn::Y    : y     = (float         const *)data; break;
+				case detail::AngbColumn::Iq   : iq    = (float         const *)data; break;
+				case detail::AngbColumn::Ci   : ci    = (float         const *)data; break;
+				case detail::AngbColumn::Sem  : sem   = (float         const *)data; break;
+				case detail::AngbColumn::Fit  : fit   = (float         const *)data; break;
+				case detail::AngbColumn::Phase: phase = (std::uint64_t const *)data; break;
+				default: continue;//skip unknown columns
+			}
+			points = (size_t)(detail::AngbColumn::Eu == entry.id ? entry.count / 3 : entry.count);//equal for every standard column
 		}
 	}
 
 	//@brief: read data from a '.ang' file
 	//@param fileName: name of ang file to read
+	//@param threads: number of threads to parse data with (0 to use all hardware threads)
+	//@param columns: columns to read
 	//@return: number of scan points read from file
-	size_t OrientationMap::readAng(std::string fileName) {
-		//parse the header
-		std::ifstream is(fileName.c_str());//open file
-		if(!is) throw std::runtime_error("ang file " + fileName + " doesn't exist");
-		size_t tokenCount = readAngHeader(is);//read header and count number of tokens per point
-		allocate(tokenCount);//allocate space
+	size_t OrientationMap::readAng(std::string fileName, const size_t threads, const Column columns, const AngSource source, LoadStats * const stats) {
+		//memory map the file (or read the first buffer) and parse the header directly from memory
+		if(!std::filesystem::exists(fileName)) throw std::runtime_error("ang file " + fileName + " doesn't exist");
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		std::unique_ptr<const memorymap::File> mapped;
+		std::unique_ptr<memorymap::ReadAheadFile> buffered;
+		std::unique_ptr<detail::Decompressor> compressed;
+		char const * data = NULL;
+		char const * end = NULL;//it is our responsibility to not go past the end of the memory map / buffer
+		if(AngSource::ReadAhead == source || AngSource::Compressed == source) {
+			size_t bytes = 0;
+			if(AngSource::ReadAhead == source) {
+				buffered.reset(new memorymap::ReadAheadFile(fileName));
+				data = buffered->next(NULL, bytes);
+			} else {
+				compressed.reset(new detail::Decompressor(fileName, threads));
+				data = compressed->next(NULL, bytes);
+			}
+			if(NULL == data) throw std::runtime_error("ang file " + fileName + " is empty");
+			end = data + bytes;
+		} else {
+			memorymap::Options options;
+			options.hugePages = true;//fewer TLB misses while parsing large files
+			mapped.reset(new memorymap::File(fileName, memorymap::Hint::Sequential, false, 0, options));
+			data = mapped->constData();
+			end = data + mapped->size();
+		}
+		size_t offset = 0;//offset to data start
+		size_t tokenCount = readAngHeader(data, end, offset);//read header and count number of tokens per point
+		if(NULL != buffered && offset >= (size_t)(end - data) && buffered->size() > (std::uint64_t)(end - data)) throw std::runtime_error("the header of " + fileName + " doesn't fit in a single read buffer");
+		if(NULL != compressed && offset >= (size_t)(end - data) && !compressed->finished()) throw std::runtime_error("the header of " + fileName + " doesn't fit in the first decompressed block");
+		if(NULL != stats) {
+			stats->headerSeconds = detail::secondsSince(start);
+			start = std::chrono::steady_clock::now();
+		}
+		allocate(tokenCount, columns);//allocate space for requested columns
+		if(NULL != stats) {
+			stats->allocateSeconds = detail::secondsSince(start);
+			stats->peakBytes = columnBytes();
+			start = std::chrono::steady_clock::now();
+		}
 
 		//read the data
-		static const bool UseMemMap = true;
-		if(UseMemMap) {
-			std::streamoff offset = is.tellg();//get offset to data start
-			is.close();//close the file
-			return readAngDataMemMap(fileName, offset, tokenCount);
-		} else {
-			return readAngData(is, tokenCount);
+		std::unique_ptr<detail::RowProgress> progress(detail::RowProgress::Enabled(stats) ? new detail::RowProgress(*stats, nRows) : NULL);
+		ScanStats * const scanStats = NULL != stats ? stats->scanStats : NULL;
+		size_t pointsRead = 0;
+		switch(source) {
+			case AngSource::MemMap:
+				pointsRead = readAngDataMemMap(data + offset, end, tokenCount, threads, progress.get(), 0, scanStats);
+				break;
+			case AngSource::Stream: {
+				std::ifstream is(fileName.c_str());//open file
+				is.seekg(offset);//skip header
+				pointsRead = readAngData(is, tokenCount, progress.get());
+				if(!qu.empty()) computeQuats(quPlanar);//the stream parser doesn't convert while parsing
+				if(NULL != scanStats) computeStats(*scanStats);//or accumulate statistics
+			} break;
+			case AngSource::ReadAhead:
+				pointsRead = readAngDataBuffered(*buffered, data + offset, end, tokenCount, threads, progress.get(), scanStats);
+				break;
+			case AngSource::Compressed://the decompressor can't be constructed without a codec
+			#if defined(TSL_USE_ZLIB) || defined(TSL_USE_ZSTD)
+				pointsRead = readAngDataBuffered(*compressed, data + offset, end, tokenCount, threads, progress.get(), scanStats);
+			#endif
+				break;
+		}
+
+		//count the work done while parsing
+		if(NULL != stats) {
+			stats->parseSeconds = detail::secondsSince(start);
+			stats->bytesScanned = NULL != buffered ? buffered->size() : (NULL != compressed ? compressed->decompressed() : mapped->size());
+			stats->linesParsed = pointsRead;
+			const size_t converted = (eu.empty() ? 0 : 3) + (x.empty() ? 0 : 1) + (y.empty() ? 0 : 1) + (iq.empty() ? 0 : 1) + (ci.empty() ? 0 : 1) + (sem.empty() ? 0 : 1) + (fit.empty() ? 0 : 1) + (phase.empty() ? 0 : 1);
+			stats->extraColumnPoints = tokenCount > 10 ? pointsRead : 0;
+			stats->skippedTokens = pointsRead * (tokenCount - std::min(tokenCount, converted));
+		}
+		return pointsRead;
+	}
+
+#ifdef TSL_USE_HDF5
+	//@brief: read data from an EDAX hdf5 file
+	//@param fileName: name of hdf5 file to read
+	//@param columns: columns to read
+	//@return: number of scan points read from file
+	size_t OrientationMap::readHdf(std::string fileName, const Column columns) {
+		//open the file and find the first scan
+		if(!std::filesystem::exists(fileName)) throw std::runtime_error("hdf5 file " + fileName + " doesn't exist");
+		const detail::H5Quiet quiet;
+		const detail::H5Id file(H5Fopen(fileName.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT), H5Fclose);
+		if(!file.valid()) throw std::runtime_error(fileName + " couldn't be opened as an hdf5 file");
+		H5G_info_t info;
+		if(H5Gget_info(file, &info) < 0) throw std::runtime_error(fileName + " couldn't be read");
+		std::string scan;
+		for(hsize_t i = 0; i < info.nlinks && scan.empty(); i++) {
+			const std::string name = detail::h5LinkName(file, i);
+			if(detail::h5Has(file, name + "/EBSD") && detail::h5Has(file, name + "/EBSD/Data") && detail::h5Has(file, name + "/EBSD/Header")) scan = name;
+		}
+		if(scan.empty()) throw std::runtime_error(fileName + " doesn't contain an EDAX EBSD scan");
+		const detail::H5Id header(H5Gopen2(file, (scan + "/EBSD/Header").c_str(), H5P_DEFAULT), H5Gclose);
+		const detail::H5Id data  (H5Gopen2(file, (scan + "/EBSD/Data"  ).c_str(), H5P_DEFAULT), H5Gclose);
+		if(!header.valid() || !data.valid()) throw std::runtime_error(fileName + " scan '" + scan + "' couldn't be opened");
+
+		//parse the header (TEM_PIXperUM isn't stored in hdf5 files)
+		pixPerUm = 1.0f;
+		xStar = yStar = zStar = workingDistance = 0.0f;
+		if(detail::h5Has(header, "Pattern Center Calibration")) {
+			const detail::H5Id pc(H5Gopen2(header, "Pattern Center Calibration", H5P_DEFAULT), H5Gclose);
+			detail::h5Read(pc, "x-star", H5T_NATIVE_FLOAT, xStar);
+			detail::h5Read(pc, "y-star", H5T_NATIVE_FLOAT, yStar);
+			detail::h5Read(pc, "z-star", H5T_NATIVE_FLOAT, zStar);
+		}
+		if(detail::h5Has(header, "Working Distance")) detail::h5Read(header, "Working Distance", H5T_NATIVE_FLOAT, workingDistance);
+		std::uint64_t nCols = 0, rows = 0;
+		detail::h5Read(header, "Step X"  , H5T_NATIVE_FLOAT , xStep);
+		detail::h5Read(header, "Step Y"  , H5T_NATIVE_FLOAT , yStep);
+		detail::h5Read(header, "nColumns", H5T_NATIVE_UINT64, nCols);
+		detail::h5Read(header, "nRows"   , H5T_NATIVE_UINT64, rows );
+		std::istringstream(detail::h5String(header, "Grid Type")) >> gridType;
+		if(GridType::Unknown == gridType) throw std::runtime_error(fileName + " has an unknown grid type");
+		nColsOdd  = (size_t)nCols;
+		nColsEven = GridType::Hexagonal == gridType && nCols > 0 ? (size_t)nCols - 1 : (size_t)nCols;
+		nRows     = (size_t)rows;
+		operatorName = detail::h5String(header, "Operator" );
+		sampleId     = detail::h5String(header, "Sample ID");
+		scanId       = detail::h5String(header, "Scan ID"  );
+
+		//parse the phases (one subgroup per phase named with the phase number)
+		phaseList.clear();
+		if(detail::h5Has(header, "Phase")) {
+			const detail::H5Id phases(H5Gopen2(header, "Phase", H5P_DEFAULT), H5Gclose);
+			if(H5Gget_info(phases, &info) < 0) throw std::runtime_error(fileName + " phases couldn't be read");
+			for(hsize_t i = 0; i < info.nlinks; i++) {
+				const std::string name = detail::h5LinkName(phases, i);
+				const detail::H5Id group(H5Gopen2(phases, name.c_str(), H5P_DEFAULT), H5Gclose);
+				if(!group.valid()) continue;
+				Phase p;
+				p.num  = std::strtoul(name.c_str(), NULL, 10);
+				p.name = detail::h5String(group, "MaterialName");
+				p.form = detail::h5String(group, "Formula"     );
+				p.info = detail::h5String(group, "Info"        );
+				detail::h5Read(group, "Symmetry", H5T_NATIVE_UINT32, p.sym);
+				static const char* LatticeNames[6] = {"Lattice Constant a", "Lattice Constant b", "Lattice Constant c", "Lattice Constant alpha", "Lattice Constant beta", "Lattice Constant gamma"};
+				for(size_t j = 0; j < 6; j++) {
+					p.lat[j] = 0.0f;
+					if(detail::h5Has(group, LatticeNames[j])) detail::h5Read(group, LatticeNames[j], H5T_NATIVE_FLOAT, p.lat[j]);
+				}
+				std::fill(p.el, p.el + 36, 0.0f);//elastic constants and categories aren't stored in hdf5 files
+				if(detail::h5Has(group, "hkl Families")) {//compound members are matched by name
+					const detail::H5Id dset(H5Dopen2(group, "hkl Families", H5P_DEFAULT), H5Dclose);
+					const detail::H5Id space(H5Dget_space(dset), H5Sclose);
+					const detail::H5Id type(H5Tcreate(H5T_COMPOUND, sizeof(HKLFamily)), H5Tclose);
+					H5Tinsert(type, "H"                    , HOFFSET(HKLFamily, hkl      )                          , H5T_NATIVE_INT32);
+					H5Tinsert(type, "K"                    , HOFFSET(HKLFamily, hkl      ) +     sizeof(std::int32_t), H5T_NATIVE_INT32);
+					H5Tinsert(type, "L"                    , HOFFSET(HKLFamily, hkl      ) + 2 * sizeof(std::int32_t), H5T_NATIVE_INT32);
+					H5Tinsert(type, "Diffraction Intensity", HOFFSET(HKLFamily, intensity)                          , H5T_NATIVE_INT32);
+					H5Tinsert(type, "Use in Indexing"      , HOFFSET(HKLFamily, useIdx   )                          , H5T_NATIVE_INT32);
+					H5Tinsert(type, "Show bands"           , HOFFSET(HKLFamily, showBands)                          , H5T_NATIVE_INT32);
+					const hssize_t count = H5Sget_simple_extent_npoints(space);
+					p.hklFam.resize(count > 0 ? (size_t)count : 0);
+					if(!p.hklFam.empty() && H5Dread(dset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, p.hklFam.data()) < 0) throw std::runtime_error(fileName + " hkl families couldn't be read for phase " + name);
+				}
+				phaseList.push_back(p);
+			}
+			std::sort(phaseList.begin(), phaseList.end(), [](const Phase& a, const Phase& b){return a.num < b.num;});//links are sorted by name ("10" < "2")
+		}
+
+		//read each requested column directly into the scan arrays (hdf5 converts types and interleaves euler angles)
+		const size_t tokenCount = detail::h5Has(data, "Fit") ? 10 : (detail::h5Has(data, "SEM Signal") ? 9 : 8);
+		allocate(tokenCount, columns);
+		const size_t totalPoints = numPoints();
+		size_t pointsRead = totalPoints;
+		auto readColumn = [&](const char* name, const hid_t memType, void * const buffer, const size_t stride) {
+			if(NULL != buffer) pointsRead = std::min(pointsRead, detail::h5Column(data, name, memType, buffer, totalPoints, stride));
+		};
+		const ScanBuffers buff = buffers();
+		readColumn("Phi1"      , H5T_NATIVE_FLOAT , NULL == buff.eu ? NULL : buff.eu    , 3);
+		readColumn("Phi"       , H5T_NATIVE_FLOAT , NULL == buff.eu ? NULL : buff.eu + 1, 3);
+		readColumn("Phi2"      , H5T_NATIVE_FLOAT , NULL == buff.eu ? NULL : buff.eu + 2, 3);
+		readColumn("X Position", H5T_NATIVE_FLOAT , buff.x    , 1);
+		readColumn("Y Position", H5T_NATIVE_FLOAT , buff.y    , 1);
+		readColumn("IQ"        , H5T_NATIVE_FLOAT , buff.iq   , 1);
+		readColumn("CI"        , H5T_NATIVE_FLOAT , buff.ci   , 1);
+		readColumn("SEM Signal", H5T_NATIVE_FLOAT , buff.sem  , 1);
+		readColumn("Fit"       , H5T_NATIVE_FLOAT , buff.fit  , 1);
+		readColumn("Phase"     , sizeof(size_t) == 8 ? H5T_NATIVE_UINT64 : H5T_NATIVE_UINT32, buff.phase, 1);
+
+		//rows are stored from their last column to their first
+		if(pointsRead == totalPoints) {
+			if(NULL != buff.eu   ) detail::reverseRows(buff.eu   , *this, 3);
+			if(NULL != buff.x    ) detail::reverseRows(buff.x    , *this);
+			if(NULL != buff.y    ) detail::reverseRows(buff.y    , *this);
+			if(NULL != buff.iq   ) detail::reverseRows(buff.iq   , *this);
+			if(NULL != buff.ci   ) detail::reverseRows(buff.ci   , *this);
+			if(NULL != buff.sem  ) detail::reverseRows(buff.sem  , *this);
+			if(NULL != buff.fit  ) detail::reverseRows(buff.fit  , *this);
+			if(NULL != buff.phase) detail::reverseRows(buff.phase, *this);
+			if(!qu.empty()) computeQuats(quPlanar);
 		}
+		return pointsRead;
 	}
+#endif
 
 	//@brief: read an ang header and parse the values
-	//@param is: input stream to read the header from
+	//@param data: start of header (first character of the file)
+	//@param end: end of the buffer (this is never read past)
+	//@param offset: location to write offset to data start (in bytes)
 	//@return: number of tokens (number of data columns)
-	size_t OrientationMap::readAngHeader(std::istream& is) {
+	size_t ScanHeader::readAngHeader(char const * const data, char const * const end, size_t& offset) {
 		//flags for which header tokens have been parsed
 		bool readPixPerUm        = false;
 		bool readXStar           = false, readYStar    = false, readZStar = false;
@@ -300,29 +5407,42 @@ namespace tsl {
 		size_t phaseElasticCount = 6   ;
 		bool readPhaseCategories = true;
 
-		//now start parsing the header
-		char line[512];//buffer to hold single line of header
-		std::string token;//current header token
-		while('#' == is.peek()) {//all header lines start with #, keep going until we get to data
-			is.getline(line, sizeof(line));//extract entire line from file
-			std::istringstream iss(line+1);//skip the '#'
-			if(iss >> token) {//get the key word if the line isn't blank
-				//get value for appropriate key
-				if       (0 == token.compare("TEM_PIXperUM"   )) {iss >> pixPerUm       ; readPixPerUm        = true;
-				} else if(0 == token.compare("x-star"         )) {iss >> xStar          ; readXStar           = true;
-				} else if(0 == token.compare("y-star"         )) {iss >> yStar          ; readYStar           = true;
-				} else if(0 == token.compare("z-star"         )) {iss >> zStar          ; readZStar           = true;
-				} else if(0 == token.compare("WorkingDistance")) {iss >> workingDistance; readWorkingDistance = true;
-				} else if(0 == token.compare("GRID:"          )) {iss >> gridType       ; readGridType        = true;
-				} else if(0 == token.compare("XSTEP:"         )) {iss >> xStep          ; readXStep           = true;
-				} else if(0 == token.compare("YSTEP:"         )) {iss >> yStep          ; readYStep           = true;
-				} else if(0 == token.compare("NCOLS_ODD:"     )) {iss >> nColsOdd       ; readColsOdd         = true;
-				} else if(0 == token.compare("NCOLS_EVEN:"    )) {iss >> nColsEven      ; readColsEven        = true;
-				} else if(0 == token.compare("NROWS:"         )) {iss >> nRows          ; readRows            = true;
-				} else if(0 == token.compare("OPERATOR:"      )) {iss >> operatorName   ; readOperatorName    = true;
-				} else if(0 == token.compare("SAMPLEID:"      )) {iss >> sampleId       ; readSampleId        = true;
-				} else if(0 == token.compare("SCANID:"        )) {iss >> scanId         ; readScanId          = true;
-				} else if(0 == token.compare("Phase"          )) {
+		//now start parsing the header directly from the buffer
+		using detail::keywordHash;
+		phaseList.clear();//don't append to phases from a previous read
+		char const * line = data;//start of current header line
+		while(line < end && '#' == *line) {//all header lines start with #, keep going until we get to data
+			char const * const lineEnd = (char const *)std::memchr(line, '\n', end - line);
+			detail::LineTokenizer iss(line + 1, NULL == lineEnd ? end : lineEnd);//skip the '#'
+			line = NULL == lineEnd ? end : lineEnd + 1;//advance to next line
+			const std::string_view token = iss.next();//get the key word
+			if(token.empty()) continue;//skip blank lines
+
+			//tsl doesn't print space between categories and first number
+			const bool categories = 0 == token.compare(0, 10, "Categories");
+			if(categories) iss.data = token.data() + 10;//rewind to first character after categories key
+
+			//get value for appropriate key (keywords are dispatched by hash, duplicate hashes would fail to compile)
+			const std::string_view key = categories ? std::string_view("Categories") : token;
+			bool known = true;
+			switch(keywordHash(key)) {
+				case keywordHash("TEM_PIXperUM"    ): known = "TEM_PIXperUM"    == key; iss.parse(pixPerUm       ); readPixPerUm        = true; break;
+				case keywordHash("x-star"          ): known = "x-star"          == key; iss.parse(xStar          ); readXStar           = true; break;
+				case keywordHash("y-star"          ): known = "y-star"          == key; iss.parse(yStar          ); readYStar           = true; break;
+				case keywordHash("z-star"          ): known = "z-star"          == key; iss.parse(zStar          ); readZStar           = true; break;
+				case keywordHash("WorkingDistance" ): known = "WorkingDistance" == key; iss.parse(workingDistance); readWorkingDistance = true; break;
+				case keywordHash("GRID:"           ): known = "GRID:"           == key; iss.parse(gridType       ); readGridType        = true; break;
+				case keywordHash("XSTEP:"          ): known = "XSTEP:"          == key; iss.parse(xStep          ); readXStep           = true; break;
+				case keywordHash("YSTEP:"          ): known = "YSTEP:"          == key; iss.parse(yStep          ); readYStep           = true; break;
+				case keywordHash("NCOLS_ODD:"      ): known = "NCOLS_ODD:"      == key; iss.parse(nColsOdd       ); readColsOdd         = true; break;
+				case keywordHash("NCOLS_EVEN:"     ): known = "NCOLS_EVEN:"     == key; iss.parse(nColsEven      ); readColsEven        = true; break;
+				case keywordHash("NROWS:"          ): known = "NROWS:"          == key; iss.parse(nRows          ); readRows            = true; break;
+				case keywordHash("OPERATOR:"       ): known = "OPERATOR:"       == key; iss.parse(operatorName   ); readOperatorName    = true; break;
+				case keywordHash("SAMPLEID:"       ): known = "SAMPLEID:"       == key; iss.parse(sampleId       ); readSampleId        = true; break;
+				case keywordHash("SCANID:"         ): known = "SCANID:"         == key; iss.parse(scanId         ); readScanId          = true; break;
+				case keywordHash("Phase"           ): {
+					if(!(known = "Phase" == key)) break;
+
 					//check that all attributes for previous phase were read
 					std::stringstream ss;
 					ss << phaseList.size();
@@ -344,46 +5464,48 @@ namespace tsl {
 
 					//add a new blank phase to the list
 					phaseList.resize(phaseList.size() + 1);
-					iss >> phaseList.back().num;
-				} else if(0 == token.compare("MaterialName"  )) {iss >> phaseList.back().name; readPhaseMaterial = true;
-				} else if(0 == token.compare("Formula"       )) {iss >> phaseList.back().form; readPhaseFormula  = true;
-				} else if(0 == token.compare("Info"          )) {iss >> phaseList.back().info; readPhaseInfo     = true;
-				} else if(0 == token.compare("Symmetry"      )) {iss >> phaseList.back().sym ; readPhaseSymmetry = true;
-				} else if(0 == token.compare("NumberFamilies")) {
-					iss >> targetFamilies;//read the number of families
+					iss.parse(phaseList.back().num);
+				} break;
+				case keywordHash("MaterialName"    ): known = "MaterialName"    == key && !phaseList.empty(); if(known) {iss.parse(phaseList.back().name); readPhaseMaterial = true;} break;
+				case keywordHash("Formula"         ): known = "Formula"         == key && !phaseList.empty(); if(known) {iss.parse(phaseList.back().form); readPhaseFormula  = true;} break;
+				case keywordHash("Info"            ): known = "Info"            == key && !phaseList.empty(); if(known) {iss.parse(phaseList.back().info); readPhaseInfo     = true;} break;
+				case keywordHash("Symmetry"        ): known = "Symmetry"        == key && !phaseList.empty(); if(known) {iss.parse(phaseList.back().sym ); readPhaseSymmetry = true;} break;
+				case keywordHash("NumberFamilies"  ):
+					if(!(known = "NumberFamilies" == key && !phaseList.empty())) break;
+					iss.parse(targetFamilies);//read the number of families
 					phaseList.back().hklFam.reserve(targetFamilies);//allocate space for the families
 					readPhaseHkl = true;
-				} else if(0 == token.compare("LatticeConstants")) {
-					iss >> phaseList.back().lat[0]
-					    >> phaseList.back().lat[1]
-					    >> phaseList.back().lat[2]
-					    >> phaseList.back().lat[3]
-					    >> phaseList.back().lat[4]
-					    >> phaseList.back().lat[5];
+					break;
+				case keywordHash("LatticeConstants"):
+					if(!(known = "LatticeConstants" == key && !phaseList.empty())) break;
+					for(size_t i = 0; i < 6; i++) iss.parse(phaseList.back().lat[i]);
 					readPhaseLattice = true;
-				} else if(0 == token.compare("hklFamilies")) {
+					break;
+				case keywordHash("hklFamilies"     ): {
+					if(!(known = "hklFamilies" == key && !phaseList.empty())) break;
 					phaseList.back().hklFam.resize(phaseList.back().hklFam.size() + 1);//add new family (space was already reserved)
-					iss >> phaseList.back().hklFam.back().hkl[0]
-					    >> phaseList.back().hklFam.back().hkl[1]
-					    >> phaseList.back().hklFam.back().hkl[2]
-					    >> phaseList.back().hklFam.back().useIdx
-					    >> phaseList.back().hklFam.back().intensity
-					    >> phaseList.back().hklFam.back().showBands;
-				} else if(0 == token.compare("ElasticConstants")) {
-					iss >> phaseList.back().el[6*phaseElasticCount + 0]
-					    >> phaseList.back().el[6*phaseElasticCount + 1]
-					    >> phaseList.back().el[6*phaseElasticCount + 2]
-					    >> phaseList.back().el[6*phaseElasticCount + 3]
-					    >> phaseList.back().el[6*phaseElasticCount + 4]
-					    >> phaseList.back().el[6*phaseElasticCount + 5];
+					HKLFamily& fam = phaseList.back().hklFam.back();
+					iss.parse(fam.hkl[0]   );
+					iss.parse(fam.hkl[1]   );
+					iss.parse(fam.hkl[2]   );
+					iss.parse(fam.useIdx   );
+					iss.parse(fam.intensity);
+					iss.parse(fam.showBands);
+				} break;
+				case keywordHash("ElasticConstants"):
+					if(!(known = "ElasticConstants" == key && !phaseList.empty() && phaseElasticCount < 6)) break;
+					for(size_t i = 0; i < 6; i++) iss.parse(phaseList.back().el[6*phaseElasticCount + i]);
 					++phaseElasticCount;
-				} else if(0 == token.compare(0, 10, "Categories")) {//tsl doesn't print space between categories and first number
-					//rewind to first character after categories key
-					iss.seekg((size_t) iss.tellg() + 10 - token.length());
-					std::copy(std::istream_iterator<size_t>(iss), std::istream_iterator<size_t>(), std::back_inserter(phaseList.back().cats));
+					break;
+				case keywordHash("Categories"      ): {
+					if(!(known = !phaseList.empty())) break;
+					size_t cat;
+					for(char const * p = iss.data; p != (iss.data = detail::parseUInt(p, iss.end, cat)); p = iss.data) phaseList.back().cats.push_back(cat);
 					readPhaseCategories = true;
-				} else {throw std::runtime_error("unknown ang header keyword '" + token + "'");}
+				} break;
+				default: known = false;
 			}
+			if(!known) throw std::runtime_error("unknown ang header keyword '" + std::string(token) + "'");
 		}
 
 		//check that all values of final phase were read
@@ -418,15 +5540,13 @@ namespace tsl {
 		if(!readSampleId       ) throw std::runtime_error("missing ang header value SAMPLEID"       );
 		if(!readScanId         ) throw std::runtime_error("missing ang header value SCANID"         );
 
-		//extract first line of data without advancing stream
-		const std::streamoff start = is.tellg();//save position of data start
-		is.getline(line, sizeof(line));//copy first data line
-		is.seekg(start);//rewind stream to data start
-
-		//get number of tokens
+		//count the number of values in the first line of data
+		offset = line - data;//save position of data start
+		if(line >= end) return 10;//no data (empty scan or truncated file), the data readers report any missing points
+		char const * const lineEnd = (char const *)std::memchr(line, '\n', end - line);
+		detail::LineTokenizer iss(line, NULL == lineEnd ? end : lineEnd);
 		size_t tokenCount = 0;
-		std::istringstream iss(line);
-		while(iss >> token) tokenCount++;//count number of values in first data line
+		while(!iss.next().empty()) tokenCount++;//count number of values in first data line
 		if(tokenCount < 8) {//make sure there are enough columns
 			std::stringstream ss;
 			ss << "unexpected number of ang values per point (got " << tokenCount << ", expected at least 8)";
@@ -439,87 +5559,1207 @@ namespace tsl {
 	//@param is: input stream set data start
 	//@param tokens: number of tokens per point
 	//@return: number of points (rows) parsed
-	size_t OrientationMap::readAngData(std::istream& is, size_t tokens) {
+	size_t OrientationMap::readAngData(std::istream& is, size_t tokens, detail::RowProgress * const progress) {
 		char line[512];//most ang files have 128 byte lines including '\n' so this should be plenty
-		bool evenRow = true;
+		bool evenRow = false;//the first row (row 1) is an odd row
 		size_t pointsRead = 0;
 		size_t completeRowPoints = 0;
-		size_t currentCol = nColsEven - 1;
-		const size_t totalPoints = iq.size();
-		const bool readSem = tokens > 8;
-		const bool readFit = tokens > 9;
+		size_t currentCol = nColsOdd - 1;
+		const size_t totalPoints = numPoints();
+		const ScanBuffers scan = buffers();
 		while(pointsRead < totalPoints) {//keep going until we run out of point
-			char* data = line;//get pointer to line start
 			if(!is.getline(line, sizeof(line))) break;//get next line
-			const size_t i = completeRowPoints + currentCol;//get index of point currently being parsed
-			eu   [3*i  ] =      strtof (data, &data    );//parse first euler angle
-			eu   [3*i+1] =      strtof (data, &data    );//parse second euler angle
-			eu   [3*i+2] =      strtof (data, &data    );//parse third euler angle
-			x    [i]     =      strtof (data, &data    );//parse x
-			y    [i]     =      strtof (data, &data    );//parse y
-			iq   [i]     =      strtof (data, &data    );//parse image quality
-			ci   [i]     =      strtof (data, &data    );//parse confidence index
-			phase[i]     = std::strtoul(data, &data, 10);//parse phase (as base 10)
-			if(readSem) {//are there 9 or more tokens?
-				sem[i]     = strtof(data, &data);//parse SE signal
-				if(readFit) {//are there 10 or more tokens?
-					fit[i] = strtof(data, NULL);//parse fit
-				}
-			}
+			detail::readAngLine(line, line + std::strlen(line), scan, completeRowPoints + currentCol, tokens);//parse the point
 			pointsRead++;//increment number of points parsed
 			if(0 == currentCol--) {//decrement current column and check if we've reached a new row
 				completeRowPoints += evenRow ? nColsEven : nColsOdd;//update increment to start of current row
 				evenRow = !evenRow;//are we currently on an even or odd row?
 				currentCol = evenRow ? nColsEven - 1 : nColsOdd - 1;//get number of point in new row
+				if(NULL != progress) progress->rowDone();
 			}
 		}
 		return pointsRead;
 	}
 
-	size_t OrientationMap::readAngDataMemMap(std::string fileName, std::streamoff offset, size_t tokens) {
-		//open memory mapped file
-		const memorymap::File mapped(fileName, memorymap::Hint::Sequential);
-		char* data = const_cast<char*>(mapped.constData()) + offset;// !!! this pointer is read only, writing to it will cause undefined behavior (const_cast is for strtof etc)
-		uint64_t fileBytes = mapped.size();//it is our responsibility to not go past the end of the memory map
+	//@brief: read ang data using a memory map
+	//@param data: start of data (first character after the header)
+	//@param end: end of the memory map (this is never read past)
+	//@param tokens: number of tokens per point
+	//@param threads: number of threads to parse data with (0 to use all hardware threads)
+	//@return: number of points (rows) parsed
+	size_t OrientationMap::readAngDataMemMap(char const * const data, char const * const end, size_t tokens, const size_t threads, detail::RowProgress * const progress, const size_t firstLine, ScanStats * const scanStats) {
+		if(data >= end) return 0;//no data
+
+		//split the data into one newline aligned chunk per thread (but don't bother splitting small files)
+		const std::vector<char const *> bounds = detail::splitLines(data, end, 0 == threads ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads);
+		const size_t chunks = bounds.size() - 1;
+
+		//single threaded reads can skip the line counting prepass
+		if(1 == chunks) return readAngChunk(data, end, firstLine, tokens, progress, scanStats);
+
+		//count the number of lines in each chunk to get the index of each chunk's first line
+		std::vector<size_t> lines(chunks + 1, 0);
+		lines[0] = firstLine;
+		std::vector<std::thread> workers;
+		for(size_t i = 0; i < chunks; i++) workers.emplace_back([&, i](){lines[i+1] = std::count(bounds[i], bounds[i+1], '\n');});
+		for(std::thread& t : workers) t.join();
+		std::partial_sum(lines.begin(), lines.end(), lines.begin());//convert line counts to first line of each chunk
+
+		//now parse each chunk directly into the scan arrays (with thread local statistics)
+		//exceptions (e.g. from the progress callback) are caught in each worker and the first is rethrown once every worker has finished
+		std::vector<size_t> pointsRead(chunks, 0);
+		std::vector<ScanStats> partial;
+		if(NULL != scanStats) {
+			partial.assign(chunks, *scanStats);
+			for(ScanStats& p : partial) p.clear();
+		}
+		std::vector<std::exception_ptr> errors(chunks);
+		workers.clear();
+		for(size_t i = 0; i < chunks; i++) {
+			workers.emplace_back([&, i](){
+				try {
+					pointsRead[i] = readAngChunk(bounds[i], bounds[i+1], lines[i], tokens, progress, partial.empty() ? NULL : &partial[i]);
+				} catch (...) {
+					errors[i] = std::current_exception();
+				}
+			});
+		}
+		for(std::thread& t : workers) t.join();
+		for(const std::exception_ptr& e : errors) {
+			if(e) std::rethrow_exception(e);
+		}
+		for(const ScanStats& p : partial) scanStats->merge(p);
+		return std::accumulate(pointsRead.begin(), pointsRead.end(), size_t(0));
+	}
+
+	//@brief: read ang data from buffers filled by background reads or decompression
+	//@param file: source to read buffers from (memorymap::ReadAheadFile or detail::Decompressor)
+	//@param data: start of data in the current buffer (first character after the header)
+	//@param end: end of the current buffer
+	//@param tokens: number of tokens per point
+	//@param threads: number of threads to parse each buffer with (0 to use all hardware threads)
+	//@param progress: progress to update as rows are completed (or NULL)
+	//@param scanStats: statistics to accumulate as rows are completed (or NULL)
+	//@return: number of points (rows) parsed
+	template <typename Source> size_t OrientationMap::readAngDataBuffered(Source& file, char const * data, char const * end, size_t tokens, const size_t threads, detail::RowProgress * const progress, ScanStats * const scanStats) {
+		size_t pointsRead = 0;
+		const size_t totalPoints = numPoints();
+		while(pointsRead < totalPoints) {
+			//parse the complete lines of this buffer while the next buffer is read in the background
+			char const * last = end;
+			while(last > data && '\n' != last[-1]) --last;//find the start of the trailing partial line
+			pointsRead += readAngDataMemMap(data, last, tokens, threads, progress, pointsRead, scanStats);
+
+			//get the next buffer with the partial line moved in front of it
+			size_t bytes = 0;
+			char const * const next = file.next(last, bytes);
+			if(NULL == next) {//end of file, parse the final line if it doesn't end with a newline
+				if(last < end) pointsRead += readAngDataMemMap(last, end, tokens, 1, progress, pointsRead, scanStats);
+				break;
+			}
+			data = next;
+			end = next + bytes;
+		}
+		return pointsRead;
+	}
+
+	//@brief: parse a block of complete ang data lines
+	//@param data: start of first line to parse
+	//@param end: end of block (one past the last '\n')
+	//@param line: index of first line in block (relative to the data start)
+	//@param tokens: number of tokens per point
+	//@param progress: progress to update as rows are completed (or NULL)
+	//@param scanStats: statistics to accumulate as rows are completed (or NULL)
+	//@return: number of points (rows) parsed
+	size_t OrientationMap::readAngChunk(char const * data, char const * const end, size_t line, size_t tokens, detail::RowProgress * const progress, ScanStats * const scanStats) {
+		//get position of first line in the scan arrays
+		bool evenRow;
+		size_t completeRowPoints, currentCol;
+		lineToPoint(line, completeRowPoints, currentCol, evenRow);
 
 		//parse data
-		bool evenRow = true;
 		size_t pointsRead = 0;
-		size_t completeRowPoints = 0;
-		size_t currentCol = nColsEven - 1;
-		size_t totalPoints = iq.size();
-		uint64_t bytesRead = (uint64_t)offset+1;//skipped header bytes count towards file size
-		const bool readSem  = tokens >  8;
-		const bool readFit  = tokens >  9;
-		const bool extraTok = tokens > 10;
-		while(pointsRead < totalPoints && bytesRead < fileBytes) {//keep going until we run out of points or file
-			char* dStart = data;//save pointer to line start
-			const size_t i = completeRowPoints + currentCol;//get index of point currently being parsed
-			eu   [3*i  ] =      strtof (data, &data    );//parse first euler angle
-			eu   [3*i+1] =      strtof (data, &data    );//parse second euler angle
-			eu   [3*i+2] =      strtof (data, &data    );//parse third euler angle
-			x    [i]     =      strtof (data, &data    );//parse x
-			y    [i]     =      strtof (data, &data    );//parse y
-			iq   [i]     =      strtof (data, &data    );//parse image quality
-			ci   [i]     =      strtof (data, &data    );//parse confidence index
-			phase[i]     = std::strtoul(data, &data, 10);//parse phase (as base 10)
-			if(readSem) {//are there 9 or more tokens?
-				sem[i] = strtof(data, &data);//parse SE signal
-				if(readFit) {//are there 10 or more tokens?
-					fit[i] = strtof(data, &data);//parse fit
-					if(extraTok) while('\n' != *data) ++data;//skip extra tokens until the end of the line
-				}
-			}
-			bytesRead += data - dStart;//count number of bytes read (make sure we don't read past the end of the file)
+		const size_t totalPoints = numPoints();
+		const ScanBuffers scan = buffers();
+		static const size_t QuatBatch = 256;//maximum number of pixels to parse before converting euler angles to quaternions
+		const bool quats = NULL != scan.qu && NULL != scan.eu;
+		size_t runEnd = completeRowPoints + currentCol + 1;//one past the last pixel parsed but not yet converted to a quaternion (pixels are filled from the end of each row)
+		size_t rowEnd = runEnd;//one past the last pixel parsed but not yet added to the statistics
+		auto addStats = [&](const size_t first, const size_t count) {//add a contiguous run of pixels to the statistics while they are still in cache
+			scanStats->add(NULL == scan.iq ? NULL : scan.iq + first, NULL == scan.ci ? NULL : scan.ci + first, NULL == scan.fit ? NULL : scan.fit + first, NULL == scan.phase ? NULL : scan.phase + first, count);
+		};
+		while(line + pointsRead < totalPoints && data < end) {//keep going until we run out of points or chunk
+			const size_t i = completeRowPoints + currentCol;//index of point
+			data = detail::readAngLine(data, end, scan, i, tokens);//parse the point
+			data = detail::nextLine(data, end);//skip extra tokens / line ending until the end of the line
 			pointsRead++;//increment number of points parsed
+			if(quats && (0 == currentCol || runEnd - i == QuatBatch)) {//convert quaternions while the euler angles are still in L1
+				detail::eulerToQuat(scan.eu, scan.qu, scan.quPlane, i, runEnd - i);
+				runEnd = i;
+			}
 			if(0 == currentCol--) {//decrement current column and check if we've reached a new row
+				if(NULL != scanStats) addStats(i, rowEnd - i);
 				completeRowPoints += evenRow ? nColsEven : nColsOdd;//update increment to start of current row
 				evenRow = !evenRow;//are we currently on an even or odd row?
 				currentCol = evenRow ? nColsEven - 1 : nColsOdd - 1;//get number of point in new row
+				runEnd = rowEnd = completeRowPoints + currentCol + 1;
+				if(NULL != progress) {
+					progress->rowDone();
+					if(progress->cancelled()) break;//another thread's callback threw
+				}
+			}
+		}
+		const size_t next = completeRowPoints + currentCol + 1;//last point parsed
+		if(quats && runEnd > next) detail::eulerToQuat(scan.eu, scan.qu, scan.quPlane, next, runEnd - next);//convert the remainder of a partial row
+		if(NULL != scanStats && rowEnd > next) addStats(next, rowEnd - next);
+		return pointsRead;
+	}
+
+	//@brief: parse and validate a block of complete ang data lines
+	//@param data: start of first line to parse
+	//@param end: end of block (one past the last '\n')
+	//@param line: index of first line in block (relative to the data start)
+	//@param tokens: number of tokens per point
+	//@param file: start of the file (for line offsets)
+	//@param origin: x/y coordinates of the first point (for position checks)
+	//@param report: report to add bad lines to
+	//@return: number of points (rows) parsed
+	size_t OrientationMap::validateAngChunk(char const * data, char const * const end, size_t line, const size_t tokens, char const * const file, const float origin[2], ValidationReport& report) {
+		//valid phase IDs
+		std::vector<size_t> phases(1, 0);
+		for(const Phase& p : phaseList) phases.push_back(p.num);
+
+		//check that a token is a decimal number ([+-]digits[.digits][(e|E)[+-]digits])
+		auto isNumber = [](char const * p, char const * const tokenEnd) {
+			if(p < tokenEnd && ('-' == *p || '+' == *p)) ++p;
+			size_t digits = 0;
+			for(; p < tokenEnd && std::isdigit((unsigned char)*p); ++p) ++digits;
+			if(p < tokenEnd && '.' == *p) {
+				for(++p; p < tokenEnd && std::isdigit((unsigned char)*p); ++p) ++digits;
+			}
+			if(0 == digits) return false;
+			if(p < tokenEnd && ('e' == *p || 'E' == *p)) {
+				if(++p < tokenEnd && ('-' == *p || '+' == *p)) ++p;
+				if(p == tokenEnd) return false;
+				for(; p < tokenEnd && std::isdigit((unsigned char)*p); ++p) {}
+			}
+			return p == tokenEnd;
+		};
+
+		//get position of first line in the scan arrays
+		bool evenRow;
+		size_t completeRowPoints, currentCol;
+		lineToPoint(line, completeRowPoints, currentCol, evenRow);
+		size_t row = 2 * (completeRowPoints / (nColsOdd + nColsEven)) + (evenRow ? 1 : 0);
+		const bool hex = GridType::Hexagonal == gridType;
+
+		//parse each line into a single point, check it, then copy it to the requested columns
+		static const float TwoPi = 6.28318531f, Pi = 3.14159265f, Unindexed = 12.566371f, Tol = 1e-3f;
+		const ScanBuffers scan = buffers();
+		float eu3[3], vals[6];//x, y, iq, ci, sem, fit
+		size_t ph = 0;
+		const ScanBuffers point = {eu3, vals, vals + 1, vals + 2, vals + 3, vals + 4, vals + 5, &ph};
+		size_t pointsRead = 0;
+		const size_t totalPoints = numPoints();
+		while(line + pointsRead < totalPoints && data < end) {
+			//bound the line and check its tokens
+			char const * const lineStart = data;
+			char const * const next = detail::nextLine(data, end);
+			char const * lineEnd = next;
+			while(lineEnd > lineStart && ('\n' == lineEnd[-1] || '\r' == lineEnd[-1])) --lineEnd;
+			LineProblem problems = LineProblem::None;
+			size_t count = 0;
+			for(char const * p = lineStart; p < lineEnd; ) {
+				while(p < lineEnd && (' ' == *p || '\t' == *p)) ++p;
+				if(p == lineEnd) break;
+				char const * const tokenStart = p;
+				while(p < lineEnd && ' ' != *p && '\t' != *p) ++p;
+				if(count++ < tokens && !isNumber(tokenStart, p)) problems = problems | LineProblem::Number;
+			}
+			if(count < tokens) problems = problems | LineProblem::Tokens;
+
+			//parse the line (missing tokens are 0)
+			std::fill(eu3, eu3 + 3, 0.0f);
+			std::fill(vals, vals + 6, 0.0f);
+			ph = 0;
+			detail::readAngLine(lineStart, lineEnd, point, 0, tokens);
+
+			//check values
+			const bool unindexed = std::fabs(eu3[0] - Unindexed) < Tol && std::fabs(eu3[1] - Unindexed) < Tol && std::fabs(eu3[2] - Unindexed) < Tol;
+			const bool inRange = eu3[0] >= -Tol && eu3[0] <= TwoPi + Tol && eu3[1] >= -Tol && eu3[1] <= Pi + Tol && eu3[2] >= -Tol && eu3[2] <= TwoPi + Tol;
+			if(!unindexed && !inRange) problems = problems | LineProblem::Euler;
+			if(phases.end() == std::find(phases.begin(), phases.end(), ph)) problems = problems | LineProblem::Phase;
+			const size_t col = (evenRow ? nColsEven : nColsOdd) - 1 - currentCol;//column in file order
+			const float gridX = origin[0] + xStep * (col + (hex && evenRow ? 0.5f : 0.0f)), gridY = origin[1] + yStep * row;
+			if(!(std::fabs(vals[0] - gridX) <= 0.25f * std::fabs(xStep)) || !(std::fabs(vals[1] - gridY) <= 0.25f * std::fabs(yStep))) problems = problems | LineProblem::Position;
+			if(LineProblem::None != problems) report.add(lineStart - file, line + pointsRead, problems);
+
+			//copy the point to the requested columns
+			const size_t i = completeRowPoints + currentCol;
+			if(NULL != scan.eu   ) std::copy(eu3, eu3 + 3, scan.eu + 3 * i);
+			if(NULL != scan.x    ) scan.x  [i] = vals[0];
+			if(NULL != scan.y    ) scan.y  [i] = vals[1];
+			if(NULL != scan.iq   ) scan.iq [i] = vals[2];
+			if(NULL != scan.ci   ) scan.ci [i] = vals[3];
+			if(NULL != scan.sem  ) scan.sem[i] = vals[4];
+			if(NULL != scan.fit  ) scan.fit[i] = vals[5];
+			if(NULL != scan.phase) scan.phase[i] = ph;
+
+			//move to the next point
+			data = next;
+			pointsRead++;
+			if(0 == currentCol--) {
+				completeRowPoints += evenRow ? nColsEven : nColsOdd;
+				evenRow = !evenRow;
+				currentCol = evenRow ? nColsEven - 1 : nColsOdd - 1;
+				++row;
 			}
 		}
+		report.pointsRead += pointsRead;
 		return pointsRead;
 	}
+
+	//@brief: compute the position of a line of ang data in the scan arrays
+	//@param line: index of line (relative to the data start)
+	//@param completeRowPoints: location to write number of points in rows before the line
+	//@param currentCol: location to write index of the line's point within its row
+	//@param evenRow: location to write true/false if the line is in an even/odd row
+	void OrientationMap::lineToPoint(const size_t line, size_t& completeRowPoints, size_t& currentCol, bool& evenRow) const {
+		//rows alternate between odd and even widths starting from an odd row (identical for square grids)
+		const size_t pairPoints = nColsOdd + nColsEven;//points in an odd + even row pair
+		size_t col = line % pairPoints;//position within row pair
+		completeRowPoints = line - col;//points in complete row pairs
+		evenRow = col >= nColsOdd;
+		if(evenRow) {//second row of pair
+			completeRowPoints += nColsOdd;
+			col -= nColsOdd;
+		}
+		currentCol = (evenRow ? nColsEven : nColsOdd) - 1 - col;//points are filled from the end of each row
+	}
+
+	//@brief: read many scans in parallel using a shared pool of threads
+	//@param fileNames: files to read (currently only .ang and .angb are supported)
+	//@param callback: function to call with the index (into fileNames) and data of each scan as it is completed (calls are serialized and in completion order, the scan may be moved from)
+	//@param threads: number of threads in the pool (0 to use all hardware threads)
+	//@param columns: columns to read
+	//@note: small files are parsed by a single thread while large files are split into chunks that are parsed by any idle thread
+	//@note: if a file can't be read the remaining files are still read, and the first exception is rethrown once all files are finished
+	void readMany(const std::vector<std::string>& fileNames, std::function<void(size_t, OrientationMap&)> callback, const size_t threads, const Column columns) {
+		//state of a file that is being read
+		struct Job {
+			size_t                            index     ;//index of file in fileNames
+			OrientationMap                    scan      ;//scan being read
+			std::unique_ptr<memorymap::File>  file      ;//memory mapped ang file (kept open until all chunks are parsed)
+			size_t                            tokens    ;//number of tokens per point
+			std::vector<char const *>         bounds    ;//chunk boundaries
+			std::vector<size_t>               lines     ;//index of first line in each chunk
+			std::vector<size_t>               pointsRead;//number of points parsed from each chunk
+			std::atomic<size_t>               remaining ;//number of chunks left in the current pass
+		};
+
+		std::mutex     callbackMutex;//serializes calls to callback and access to error
+		std::exception_ptr error    ;//first exception encountered
+		detail::TaskPool pool(threads);
+
+		//@brief: record the first exception
+		auto fail = [&](){
+			std::lock_guard<std::mutex> lock(callbackMutex);
+			if(!error) error = std::current_exception();
+		};
+
+		//@brief: check that a file was completely read and pass it to the callback
+		auto finish = [&](Job& job, const size_t pointsRead) {
+			job.file.reset();//unmap file as soon as possible
+			try {
+				const size_t totalPoints = job.scan.numPoints();
+				if(pointsRead < totalPoints) {
+					std::stringstream ss;
+					ss << fileNames[job.index] << " ended after reading " << pointsRead << " of " << totalPoints << " data points";
+					throw std::runtime_error(ss.str());
+				}
+				std::lock_guard<std::mutex> lock(callbackMutex);
+				callback(job.index, job.scan);
+			} catch (...) {
+				fail();
+			}
+		};
+
+		//queue a task to open and parse the header of every file, work on files that are in flight is queued in front of these
+		for(size_t i = 0; i < fileNames.size(); i++) {
+			pool.push([&, i](){
+				std::shared_ptr<Job> job = std::make_shared<Job>();
+				job->index = i;
+				try {
+					//binary files and up to date sidecars are read directly
+					const std::string& name = fileNames[i];
+					const FileType type = getFileType(name);
+					if(FileType::Angb == type) return finish(*job, job->scan.readAngb(name, std::string(), columns));
+					if(FileType::Ang != type) throw std::runtime_error("unsupported file type (currently only .ang and .angb files are supported)");
+					try {
+						const std::string sidecar = OrientationMap::SidecarName(name);
+						if(std::filesystem::exists(sidecar)) return finish(*job, job->scan.readAngb(sidecar, name, columns));
+					} catch (std::exception&) {//stale or corrupt cache (or an unreadable directory), fall back to the ang file
+						job->scan.phaseList.clear();
+					}
+
+					//parse the header and split the data into chunks
+					if(!std::filesystem::exists(name)) throw std::runtime_error("ang file " + name + " doesn't exist");
+					job->file.reset(new memorymap::File(name, memorymap::Hint::Sequential));
+					char const * const data = job->file->constData();
+					char const * const end  = data + job->file->size();
+					size_t offset = 0;
+					job->tokens = job->scan.readAngHeader(data, end, offset);
+					job->scan.allocate(job->tokens, columns);
+					if(data + offset >= end) return finish(*job, 0);
+					job->bounds = detail::splitLines(data + offset, end, pool.size());
+					const size_t chunks = job->bounds.size() - 1;
+					if(1 == chunks) return finish(*job, job->scan.readAngChunk(data + offset, end, 0, job->tokens));//small files are parsed by this thread
+
+					//count lines in each chunk in parallel, the last chunk counted queues the parsing pass
+					job->lines.assign(chunks + 1, 0);
+					job->pointsRead.assign(chunks, 0);
+					job->remaining = chunks;
+					for(size_t c = 0; c < chunks; c++) {
+						pool.push([&, job, c](){
+							job->lines[c+1] = std::count(job->bounds[c], job->bounds[c+1], '\n');
+							if(0 != --job->remaining) return;
+							std::partial_sum(job->lines.begin(), job->lines.end(), job->lines.begin());//convert line counts to first line of each chunk
+
+							//parse each chunk directly into the scan arrays, the last chunk parsed finishes the file
+							const size_t parseChunks = job->bounds.size() - 1;
+							job->remaining = parseChunks;
+							for(size_t k = 0; k < parseChunks; k++) {
+								pool.push([&, job, k](){
+									try {
+										job->pointsRead[k] = job->scan.readAngChunk(job->bounds[k], job->bounds[k+1], job->lines[k], job->tokens);
+									} catch (...) {
+										fail();
+									}
+									if(0 == --job->remaining) finish(*job, std::accumulate(job->pointsRead.begin(), job->pointsRead.end(), size_t(0)));
+								}, true);
+							}
+						}, true);
+					}
+				} catch (...) {
+					fail();
+				}
+			});
+		}
+
+		//wait for all files and report the first error
+		pool.wait();
+		if(error) std::rethrow_exception(error);
+	}
+
+	//@brief: read many scans in parallel using a shared pool of threads
+	//@param fileNames: files to read (currently only .ang and .angb are supported)
+	//@param threads: number of threads in the pool (0 to use all hardware threads)
+	//@param columns: columns to read
+	//@return: scans in the same order as fileNames
+	std::vector<OrientationMap> readMany(const std::vector<std::string>& fileNames, const size_t threads, const Column columns) {
+		std::vector<OrientationMap> scans(fileNames.size());
+		readMany(fileNames, [&scans](size_t i, OrientationMap& scan){scans[i] = std::move(scan);}, threads, columns);
+		return scans;
+	}
+
+	//@brief: quantize values (the range is taken from the values)
+	//@param values: values to quantize (must be finite)
+	//@param count: number of values
+	//@param arena: arena to carve codes from
+	void QuantizedColumn::assign(float const * const values, const size_t count, const ScanArena& arena) {
+		//get the range of the values
+		codes = ScanVector<std::uint16_t>(ScanAllocator<std::uint16_t>(arena));
+		offset = step = 0;
+		if(0 == count) return;
+		const std::pair<float const *, float const *> range = std::minmax_element(values, values + count);
+		const double vMin = *range.first, vMax = *range.second;
+		if(!std::isfinite(vMin) || !std::isfinite(vMax)) throw std::runtime_error("can't quantize non finite values");
+
+		//quantize to the nearest code
+		offset = (float)vMin;
+		step = (float)((vMax - vMin) / 65535.0);
+		resizeUninitialized(codes, count);
+		if(0 == step) {
+			std::fill(codes.begin(), codes.end(), std::uint16_t(0));
+		} else {
+			const double scale = 1.0 / step;
+			for(size_t i = 0; i < count; i++) codes[i] = (std::uint16_t)std::min(65535.0, std::round((values[i] - offset) * scale));
+		}
+	}
+
+	//@brief: decode all values
+	//@param values: location to write decoded values (must hold at least size() values)
+	void QuantizedColumn::decode(float * const values) const {
+		for(size_t i = 0; i < codes.size(); i++) values[i] = offset + step * float(codes[i]);
+	}
+
+	//@brief: read a scan and compact it
+	//@param fileName: file to read (currently only .ang and .angb are supported)
+	//@param threads: number of threads to parse data with (0 to use all hardware threads)
+	//@param columns: columns to keep
+	//@note: the full precision scan is read into a temporary arena which is freed before returning
+	template <typename PhaseT, typename ScalarT>
+	CompactOrientationMap<PhaseT, ScalarT>::CompactOrientationMap(std::string fileName, const size_t threads, const Column columns) {
+		OrientationMap om;
+		om.read(fileName, threads, columns);
+		assign(om);
+	}
+
+	//@brief: replace the contents with a compact copy of an orientation map
+	//@param om: orientation map to copy
+	template <typename PhaseT, typename ScalarT>
+	void CompactOrientationMap<PhaseT, ScalarT>::assign(const OrientationMap& om) {
+		//make sure the phases fit in the storage type before changing anything
+		if(!om.phase.empty()) {
+			const size_t maxPhase = *std::max_element(om.phase.begin(), om.phase.end());
+			if(maxPhase > (size_t)std::numeric_limits<PhaseT>::max()) {
+				std::stringstream ss;
+				ss << "phase " << maxPhase << " doesn't fit in compact phase storage (maximum " << (size_t)std::numeric_limits<PhaseT>::max() << ")";
+				throw std::runtime_error(ss.str());
+			}
+		}
+
+		//copy header and columns
+		static_cast<ScanHeader&>(*this) = om;
+		eu    = ScanVector<float >(om.eu.begin(), om.eu.end(), ScanAllocator<float>(arena));
+		x     = ScanVector<float >(om.x .begin(), om.x .end(), ScanAllocator<float>(arena));
+		y     = ScanVector<float >(om.y .begin(), om.y .end(), ScanAllocator<float>(arena));
+		compact(om.iq , iq );
+		compact(om.ci , ci );
+		compact(om.sem, sem);
+		compact(om.fit, fit);
+		phase = ScanVector<PhaseT>(ScanAllocator<PhaseT>(arena));
+		resizeUninitialized(phase, om.phase.size());
+		std::transform(om.phase.begin(), om.phase.end(), phase.begin(), [](const size_t p){return (PhaseT)p;});
+	}
+
+	//@brief: convert back to a full precision orientation map
+	//@return: orientation map (quantized columns are decoded)
+	template <typename PhaseT, typename ScalarT>
+	OrientationMap CompactOrientationMap<PhaseT, ScalarT>::expand() const {
+		OrientationMap om;
+		static_cast<ScanHeader&>(om) = *this;
+		om.eu.assign(eu.begin(), eu.end());
+		om.x .assign(x .begin(), x .end());
+		om.y .assign(y .begin(), y .end());
+		expand(iq , om.iq );
+		expand(ci , om.ci );
+		expand(sem, om.sem);
+		expand(fit, om.fit);
+		om.phase.assign(phase.begin(), phase.end());
+		return om;
+	}
+
+	//@brief: get the memory used by the scan columns
+	//@return: number of bytes
+	template <typename PhaseT, typename ScalarT>
+	size_t CompactOrientationMap<PhaseT, ScalarT>::bytes() const {
+		return (eu.size() + x.size() + y.size()) * sizeof(float) + bytes(iq) + bytes(ci) + bytes(sem) + bytes(fit) + phase.size() * sizeof(PhaseT);
+	}
+
+	//@brief: get the laue group of a tsl symmetry number
+	//@param sym: tsl symmetry number (Phase::sym)
+	//@return: laue group (throws for unknown symmetries)
+	LaueGroup laueGroup(const std::uint32_t sym) {
+		switch(sym) {
+			case  1: return LaueGroup::Triclinic     ;
+			case  2: return LaueGroup::Monoclinic    ;
+			case 22: return LaueGroup::Orthorhombic  ;
+			case  4: return LaueGroup::TetragonalLow ;
+			case 42: return LaueGroup::TetragonalHigh;
+			case  3: return LaueGroup::TrigonalLow   ;
+			case 32: return LaueGroup::TrigonalHigh  ;
+			case  6: return LaueGroup::HexagonalLow  ;
+			case 62: return LaueGroup::HexagonalHigh ;
+			case 23: return LaueGroup::CubicLow      ;
+			case 43: return LaueGroup::CubicHigh     ;
+		}
+		std::stringstream ss;
+		ss << "unknown tsl symmetry " << sym;
+		throw std::runtime_error(ss.str());
+	}
+
+	//@brief: get a forward neighbor of a pixel
+	//@param row: index of row
+	//@param col: index of column (in file order)
+	//@param k: index of neighbor (< forwardNeighbors())
+	//@return: index of neighbor in the scan arrays, or SIZE_MAX if the neighbor is outside the scan
+	size_t ScanHeader::forwardNeighbor(const size_t row, const size_t col, const size_t k) const {
+		if(0 == k) return col + 1 < rowWidth(row) ? index(row, col + 1) : SIZE_MAX;//+x
+		if(row + 1 >= nRows) return SIZE_MAX;
+		size_t nCol = col;//+y for square grids
+		if(GridType::Hexagonal == gridType) {
+			//odd rows (even indices) are at integer multiples of the step, even rows are offset by half a step
+			const bool shifted = 1 == row % 2;
+			if(1 == k) {//+y -x/2
+				if(!shifted && 0 == col) return SIZE_MAX;
+				nCol = shifted ? col : col - 1;
+			} else {//+y +x/2
+				nCol = shifted ? col + 1 : col;
+			}
+		}
+		return nCol < rowWidth(row + 1) ? index(row + 1, nCol) : SIZE_MAX;
+	}
+
+	//@brief: get a neighbor of a pixel
+	//@param row: index of row
+	//@param col: index of column (in file order)
+	//@param k: index of neighbor (< neighbors()), k < forwardNeighbors() is the same as forwardNeighbor, otherwise -x, -y (-y -x/2, -y +x/2 for hexagonal grids)
+	//@return: index of neighbor in the scan arrays, or SIZE_MAX if the neighbor is outside the scan
+	size_t ScanHeader::neighbor(const size_t row, const size_t col, const size_t k) const {
+		const size_t f = forwardNeighbors();
+		if(k < f) return forwardNeighbor(row, col, k);
+		if(f == k) return col > 0 ? index(row, col - 1) : SIZE_MAX;//-x
+		if(0 == row) return SIZE_MAX;
+		size_t nCol = col;//-y for square grids
+		if(GridType::Hexagonal == gridType) {
+			//the previous row has the same offset as the next row
+			const bool shifted = 1 == row % 2;
+			if(f + 1 == k) {//-y -x/2
+				if(!shifted && 0 == col) return SIZE_MAX;
+				nCol = shifted ? col : col - 1;
+			} else {//-y +x/2
+				nCol = shifted ? col + 1 : col;
+			}
+		}
+		return nCol < rowWidth(row - 1) ? index(row - 1, nCol) : SIZE_MAX;
+	}
+
+	//@brief: compute disorientation angles between neighboring pixels using the crystal symmetry of each phase
+	//@param om: orientation map (quaternions are used if they were computed, otherwise they are computed from the euler angles)
+	//@param threads: number of threads to compute with (0 to use all hardware threads), rows are split between threads
+	//@return: angle between each pixel and its forward neighbors
+	//@note: phase IDs are matched against Phase::num (phase 0 is the only phase of single phase scans and unindexed otherwise)
+	NeighborMisorientation neighborMisorientation(const OrientationMap& om, const size_t threads) {
+		//get quaternions
+		const size_t totalPoints = om.numPoints();
+		ScanVector<float> converted;
+		float const * qu = om.qu.data();
+		size_t plane = om.quPlanar ? totalPoints : 0;
+		if(om.qu.size() != 4 * totalPoints) {
+			if(om.eu.size() != 3 * totalPoints) throw std::runtime_error("euler angles or quaternions are required to compute misorientations");
+			resizeUninitialized(converted, 4 * totalPoints);
+			detail::eulerToQuat(om.eu.data(), converted.data(), 0, 0, totalPoints);
+			qu = converted.data();
+			plane = 0;
+		}
+		const size_t compStride  = 0 == plane ? 1 : plane;
+		const size_t pointStride = 0 == plane ? 4 : 1;
+		const std::vector<int> groups = detail::phaseGroups(om);
+
+		//allocate output
+		NeighborMisorientation result;
+		result.neighbors = om.forwardNeighbors();
+		result.angles.resize(totalPoints * result.neighbors);
+
+		//compute angles for a block of rows
+		auto computeRows = [&](const size_t first, const size_t last) {
+			static const size_t Batch = 64;//misorientations per batch
+			float w[Batch], x[Batch], y[Batch], z[Batch], angles[Batch];
+			size_t out[Batch];
+			size_t count = 0;
+			int group = -1;
+			auto flush = [&]() {
+				detail::disorientationBatch((LaueGroup)group, w, x, y, z, angles, count);
+				for(size_t i = 0; i < count; i++) result.angles[out[i]] = angles[i];
+				count = 0;
+			};
+			for(size_t row = first; row < last; row++) {
+				const size_t width = om.rowWidth(row);
+				for(size_t col = 0; col < width; col++) {
+					const size_t i = om.index(row, col);
+					const int gi = groups[om.phase.empty() ? 0 : om.phase[i]];
+					float const * const q1 = qu + i * pointStride;
+					for(size_t k = 0; k < result.neighbors; k++) {
+						//handle edges, unindexed pixels, and phase boundaries
+						const size_t o = i * result.neighbors + k;
+						const size_t j = om.forwardNeighbor(row, col, k);
+						if(SIZE_MAX == j) {
+							result.angles[o] = std::numeric_limits<float>::quiet_NaN();
+							continue;
+						}
+						const int gj = groups[om.phase.empty() ? 0 : om.phase[j]];
+						if(gi < 0 || gj < 0 || (!om.phase.empty() && om.phase[i] != om.phase[j])) {
+							result.angles[o] = std::numeric_limits<float>::infinity();
+							continue;
+						}
+
+						//queue misorientation q1 * conj(q2), stored conjugated so the symmetry kernel is a dot product
+						if(count > 0 && (gi != group || Batch == count)) flush();
+						group = gi;
+						float const * const q2 = qu + j * pointStride;
+						const float w1 = q1[0], x1 = q1[compStride], y1 = q1[2*compStride], z1 = q1[3*compStride];
+						const float w2 = q2[0], x2 = q2[compStride], y2 = q2[2*compStride], z2 = q2[3*compStride];
+						w[count] =   w1 * w2 + x1 * x2 + y1 * y2 + z1 * z2 ;
+						x[count] = -(x1 * w2 - w1 * x2 - y1 * z2 + z1 * y2);
+						y[count] = -(y1 * w2 - w1 * y2 + x1 * z2 - z1 * x2);
+						z[count] = -(z1 * w2 - w1 * z2 - x1 * y2 + y1 * x2);
+						out[count++] = o;
+					}
+				}
+			}
+			if(count > 0) flush();
+		};
+
+		//split rows between threads
+		size_t chunks = 0 == threads ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads;
+		chunks = std::max<size_t>(1, std::min(chunks, om.nRows));
+		if(1 == chunks) {
+			computeRows(0, om.nRows);
+		} else {
+			std::vector<std::thread> workers;
+			for(size_t i = 0; i < chunks; i++) workers.emplace_back(computeRows, om.nRows * i / chunks, om.nRows * (i + 1) / chunks);
+			for(std::thread& t : workers) t.join();
+		}
+		return result;
+	}
+
+	//@brief: segment a scan into grains (connected pixels with neighbor disorientations within a tolerance)
+	//@param om: orientation map to segment (see neighborMisorientation for requirements)
+	//@param tolerance: maximum disorientation angle between neighboring pixels in the same grain (radians)
+	//@param minCI: pixels with a confidence index below this value aren't segmented (ignored if the ci column wasn't read)
+	//@param threads: number of threads to segment with (0 to use all hardware threads)
+	//@return: grain ID of each pixel and statistics for each grain (IDs are numbered in order of each grain's first pixel so they don't depend on the thread count)
+	GrainMap segmentGrains(const OrientationMap& om, const float tolerance, const float minCI, const size_t threads) {
+		//compute neighbor disorientations and find pixels to segment
+		const size_t totalPoints = om.numPoints();
+		if(totalPoints > (size_t)std::numeric_limits<std::uint32_t>::max()) throw std::runtime_error("scan has too many pixels to segment");
+		const NeighborMisorientation miso = neighborMisorientation(om, threads);
+		const std::vector<int> groups = detail::phaseGroups(om);
+		auto valid = [&](const size_t i) {
+			if(groups[om.phase.empty() ? 0 : om.phase[i]] < 0) return false;//unindexed
+			return om.ci.empty() || om.ci[i] >= minCI;
+		};
+
+		//disjoint set forest where each root is the smallest index in its set (so parent[i] <= i)
+		ScanVector<std::uint32_t> parent(totalPoints);
+		auto find = [&parent](std::uint32_t i) {
+			while(parent[i] != i) {
+				parent[i] = parent[parent[i]];//path halving
+				i = parent[i];
+			}
+			return i;
+		};
+		auto unite = [&](const std::uint32_t a, const std::uint32_t b) {
+			const std::uint32_t ra = find(a), rb = find(b);
+			if(ra < rb) parent[rb] = ra;
+			else if(rb < ra) parent[ra] = rb;
+		};
+
+		//union pixels within blocks of rows in parallel (each block owns a contiguous range of indices)
+		size_t chunks = 0 == threads ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads;
+		chunks = std::max<size_t>(1, std::min(chunks, om.nRows));
+		std::vector<size_t> rowBounds(chunks + 1);
+		for(size_t i = 0; i <= chunks; i++) rowBounds[i] = om.nRows * i / chunks;
+		auto uniteBlock = [&](const size_t c) {
+			const size_t first = rowBounds[c], last = rowBounds[c+1];
+			for(size_t i = om.rowStart(first); i < om.rowStart(last); i++) parent[i] = (std::uint32_t)i;
+			for(size_t row = first; row < last; row++) {
+				for(size_t col = 0; col < om.rowWidth(row); col++) {
+					const size_t i = om.index(row, col);
+					if(!valid(i)) continue;
+					for(size_t k = 0; k < miso.neighbors; k++) {
+						if(row + 1 == last && 0 != k) continue;//neighbors in the next block are merged afterwards
+						if(!(miso(i, k) <= tolerance)) continue;//NaN / infinity for missing neighbors / phase boundaries
+						const size_t j = om.forwardNeighbor(row, col, k);
+						if(valid(j)) unite((std::uint32_t)i, (std::uint32_t)j);
+					}
+				}
+			}
+		};
+		if(1 == chunks) {
+			uniteBlock(0);
+		} else {
+			std::vector<std::thread> workers;
+			for(size_t c = 0; c < chunks; c++) workers.emplace_back(uniteBlock, c);
+			for(std::thread& t : workers) t.join();
+		}
+
+		//merge across block boundaries
+		for(size_t c = 1; c < chunks; c++) {
+			const size_t row = rowBounds[c] - 1;//last row of the previous block
+			for(size_t col = 0; col < om.rowWidth(row); col++) {
+				const size_t i = om.index(row, col);
+				if(!valid(i)) continue;
+				for(size_t k = 1; k < miso.neighbors; k++) {
+					if(!(miso(i, k) <= tolerance)) continue;
+					const size_t j = om.forwardNeighbor(row, col, k);
+					if(valid(j)) unite((std::uint32_t)i, (std::uint32_t)j);
+				}
+			}
+		}
+
+		//flatten the forest (parents always precede children) and number grains in order of their first pixel
+		GrainMap result;
+		result.ids.resize(totalPoints);
+		result.grains.resize(1);
+		result.grains[0].firstRow = SIZE_MAX;//like every other grain, set by the first pixel found below
+		for(size_t i = 0; i < totalPoints; i++) {
+			if(!valid(i)) {
+				result.ids[i] = 0;
+				continue;
+			}
+			const std::uint32_t root = parent[parent[i]];//parent of parent is already flattened to its root
+			parent[i] = root;
+			if(root == i) {//first pixel of a new grain
+				result.ids[i] = (std::uint32_t)result.grains.size();
+				Grain g = {};
+				g.phase = om.phase.empty() ? 0 : om.phase[i];
+				g.seed = i;
+				g.firstRow = SIZE_MAX;
+				result.grains.push_back(g);
+			} else {
+				result.ids[i] = result.ids[root];
+			}
+		}
+
+		//accumulate grain statistics
+		const bool hex = GridType::Hexagonal == om.gridType;
+		std::vector<double> sums(result.grains.size() * 4, 0.0);//x, y, ci, iq
+		for(size_t row = 0; row < om.nRows; row++) {
+			for(size_t col = 0; col < om.rowWidth(row); col++) {
+				const size_t i = om.index(row, col);
+				const std::uint32_t id = result.ids[i];
+				Grain& g = result.grains[id];
+				++g.pixels;
+				if(SIZE_MAX == g.firstRow || row < g.firstRow) g.firstRow = row;
+				g.lastRow = std::max(g.lastRow, row);
+				double * const sum = sums.data() + 4 * id;
+				sum[0] += om.x.empty() ? om.xStep * (col + (hex && 1 == row % 2 ? 0.5 : 0.0)) : om.x[i];//compute coordinates from the grid if needed
+				sum[1] += om.y.empty() ? om.yStep * row : om.y[i];
+				sum[2] += om.ci.empty() ? 0.0f : om.ci[i];
+				sum[3] += om.iq.empty() ? 0.0f : om.iq[i];
+			}
+		}
+		for(size_t id = 0; id < result.grains.size(); id++) {
+			Grain& g = result.grains[id];
+			if(0 == g.pixels) {
+				g.firstRow = 0;
+				continue;
+			}
+			g.x  = float(sums[4*id  ] / g.pixels);
+			g.y  = float(sums[4*id+1] / g.pixels);
+			g.ci = float(sums[4*id+2] / g.pixels);
+			g.iq = float(sums[4*id+3] / g.pixels);
+		}
+		return result;
+	}
+
+	//@brief: neighbor confidence index correlation: pixels with a confidence index below a threshold take the orientation, phase, and confidence index of their highest CI neighbor (if it is higher than their own)
+	//@param om: orientation map to clean (the ci column is required, the eu, qu, and phase columns are updated if they were read)
+	//@param minCI: pixels with a confidence index below this value are cleaned
+	//@param threads: number of threads to clean with (0 to use all hardware threads)
+	//@param iterations: maximum number of iterations (1 for the usual single pass, 0 to repeat until no pixel changes)
+	//@return: iteration counts
+	//@note: every iteration only reads the result of the previous iteration so results don't depend on the thread count
+	CleanupResult neighborCiCorrelation(OrientationMap& om, const float minCI, const size_t threads, const size_t iterations) {
+		const size_t totalPoints = om.numPoints();
+		if(totalPoints > (size_t)std::numeric_limits<std::uint32_t>::max()) throw std::runtime_error("scan has too many pixels to clean");
+		if(om.ci.size() != totalPoints) throw std::runtime_error("neighbor CI correlation requires the ci column");
+
+		//each pixel takes the values of the highest CI neighbor that improves it (pixels only ever copy original values through origin)
+		ScanVector<std::uint32_t> origin(totalPoints);
+		std::iota(origin.begin(), origin.end(), std::uint32_t(0));
+		const float * const ci = om.ci.data();
+		auto dirty = [&](const size_t i) {return ci[origin[i]] < minCI;};
+		auto choose = [&](const size_t i, size_t const * const nbrs, const size_t count) {
+			size_t best = SIZE_MAX;
+			float bestCi = ci[origin[i]];
+			for(size_t k = 0; k < count; k++) {
+				const float c = ci[origin[nbrs[k]]];
+				if(c > bestCi) {
+					best = nbrs[k];
+					bestCi = c;
+				}
+			}
+			return best;
+		};
+		const CleanupResult result = detail::iterateNeighborhoods(om, origin.data(), NULL, threads, iterations, dirty, choose);
+
+		//copy values from origins
+		if(result.changed > 0) {
+			size_t chunks = 0 == threads ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads;
+			chunks = std::max<size_t>(1, std::min(chunks, om.nRows));
+			detail::gatherOrigins(om.eu   , origin.data(), totalPoints, 3, false      , chunks);
+			detail::gatherOrigins(om.qu   , origin.data(), totalPoints, 4, om.quPlanar, chunks);
+			detail::gatherOrigins(om.phase, origin.data(), totalPoints, 1, false      , chunks);
+			detail::gatherOrigins(om.ci   , origin.data(), totalPoints, 1, false      , chunks);
+		}
+		return result;
+	}
+
+	//@brief: grain dilation: pixels that don't belong to a grain are added to the grain most of their neighbors belong to (repeated until every pixel connected to a grain is assigned)
+	//@param om: orientation map to clean (dilated pixels take the eu, qu, and phase of their highest CI neighbor in the grain they join)
+	//@param grains: segmentation of om (see segmentGrains), ids are updated and pixel counts are recomputed (the other grain statistics still describe the original segmentation)
+	//@param minPixels: grains with fewer pixels than this are dissolved before dilating
+	//@param threads: number of threads to clean with (0 to use all hardware threads)
+	//@param iterations: maximum number of iterations (0 to repeat until no pixel changes)
+	//@return: iteration counts
+	//@note: ties are broken by the highest neighbor CI and then the lowest grain ID so results don't depend on the thread count
+	CleanupResult dilateGrains(OrientationMap& om, GrainMap& grains, const size_t minPixels, const size_t threads, const size_t iterations) {
+		const size_t totalPoints = om.numPoints();
+		if(totalPoints > (size_t)std::numeric_limits<std::uint32_t>::max()) throw std::runtime_error("scan has too many pixels to clean");
+		if(grains.ids.size() != totalPoints || grains.grains.empty()) throw std::runtime_error("grain map doesn't match orientation map");
+		const size_t numGrains = grains.grains.size();
+		if(std::any_of(grains.ids.begin(), grains.ids.end(), [numGrains](const std::uint32_t id){return id >= numGrains;})) throw std::runtime_error("grain map has a grain ID outside of its grain list");
+
+		//dissolve small grains
+		std::uint32_t * const ids = grains.ids.data();
+		for(size_t i = 0; i < totalPoints; i++) {
+			if(grains.grains[ids[i]].pixels < minPixels) ids[i] = 0;
+		}
+
+		//each unassigned pixel joins the most common grain of its neighbors
+		ScanVector<std::uint32_t> origin(totalPoints);
+		std::iota(origin.begin(), origin.end(), std::uint32_t(0));
+		auto ciOf = [&](const size_t i) {return om.ci.empty() ? 0.0f : om.ci[origin[i]];};
+		auto dirty = [&](const size_t i) {return 0 == ids[i];};
+		auto choose = [&](const size_t, size_t const * const nbrs, const size_t count) {
+			//tally neighboring grains
+			std::uint32_t cand[6];//candidate grain IDs
+			size_t votes[6], source[6], n = 0;//vote count and highest CI neighbor for each candidate
+			for(size_t k = 0; k < count; k++) {
+				const std::uint32_t id = ids[nbrs[k]];
+				if(0 == id) continue;
+				size_t c = std::find(cand, cand + n, id) - cand;
+				if(c == n) {
+					cand[n] = id;
+					votes[n] = 0;
+					source[n++] = nbrs[k];
+				} else if(ciOf(nbrs[k]) > ciOf(source[c])) {
+					source[c] = nbrs[k];
+				}
+				++votes[c];
+			}
+
+			//pick the winner
+			size_t best = SIZE_MAX;
+			for(size_t c = 0; c < n; c++) {
+				if(SIZE_MAX == best || votes[c] > votes[best]) {
+					best = c;
+					continue;
+				}
+				if(votes[c] < votes[best]) continue;
+				const float ciC = ciOf(source[c]), ciB = ciOf(source[best]);
+				if(ciC > ciB || (ciC == ciB && cand[c] < cand[best])) best = c;
+			}
+			return SIZE_MAX == best ? SIZE_MAX : source[best];
+		};
+		const CleanupResult result = detail::iterateNeighborhoods(om, origin.data(), ids, threads, iterations, dirty, choose);
+
+		//copy values from origins and recount grain pixels
+		if(result.changed > 0) {
+			size_t chunks = 0 == threads ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads;
+			chunks = std::max<size_t>(1, std::min(chunks, om.nRows));
+			detail::gatherOrigins(om.eu   , origin.data(), totalPoints, 3, false      , chunks);
+			detail::gatherOrigins(om.qu   , origin.data(), totalPoints, 4, om.quPlanar, chunks);
+			detail::gatherOrigins(om.phase, origin.data(), totalPoints, 1, false      , chunks);
+		}
+		for(Grain& g : grains.grains) g.pixels = 0;
+		for(size_t i = 0; i < totalPoints; i++) ++grains.grains[ids[i]].pixels;
+		return result;
+	}
+
+	//@brief: grain CI standardization: set the confidence index of every pixel in a grain to the highest confidence index in the grain
+	//@param om: orientation map to clean (the ci column is required)
+	//@param grains: segmentation of om (see segmentGrains), pixels with grain ID 0 aren't changed
+	//@param threads: number of threads to clean with (0 to use all hardware threads)
+	void standardizeCi(OrientationMap& om, const GrainMap& grains, const size_t threads) {
+		const size_t totalPoints = om.numPoints();
+		if(om.ci.size() != totalPoints) throw std::runtime_error("CI standardization requires the ci column");
+		if(grains.ids.size() != totalPoints) throw std::runtime_error("grain map doesn't match orientation map");
+		const size_t numGrains = grains.grains.size();
+		if(std::any_of(grains.ids.begin(), grains.ids.end(), [numGrains](const std::uint32_t id){return id >= numGrains;})) throw std::runtime_error("grain map has a grain ID outside of its grain list");
+
+		//find the highest CI of each grain in blocks of pixels
+		size_t chunks = 0 == threads ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads;
+		chunks = std::max<size_t>(1, std::min(chunks, om.nRows));
+		std::vector<float> best(chunks * numGrains, -std::numeric_limits<float>::infinity());
+		auto findMax = [&](const size_t c) {
+			float * const m = best.data() + c * numGrains;
+			for(size_t i = totalPoints * c / chunks; i < totalPoints * (c + 1) / chunks; i++) m[grains.ids[i]] = std::max(m[grains.ids[i]], om.ci[i]);
+		};
+		auto assign = [&](const size_t c) {
+			for(size_t i = totalPoints * c / chunks; i < totalPoints * (c + 1) / chunks; i++) {
+				if(0 != grains.ids[i]) om.ci[i] = best[grains.ids[i]];
+			}
+		};
+		auto run = [&](auto& work) {
+			if(1 == chunks) {
+				work(0);
+			} else {
+				std::vector<std::thread> workers;
+				for(size_t c = 0; c < chunks; c++) workers.emplace_back([&work, c](){work(c);});
+				for(std::thread& t : workers) t.join();
+			}
+		};
+		run(findMax);
+		for(size_t c = 1; c < chunks; c++) {
+			for(size_t id = 0; id < numGrains; id++) best[id] = std::max(best[id], best[c * numGrains + id]);
+		}
+		run(assign);
+	}
+
+	//@brief: build the index table for a scan geometry
+	//@param header: geometry of scans to resample (grid type, dimensions, and step sizes)
+	//@param step: pixel size of square grid (0 to use the x step of the source grid)
+	SquareResampler::SquareResampler(const ScanHeader& header, const float step) : step(0 == step ? header.xStep : step), srcOdd(header.nColsOdd), srcEven(header.nColsEven), srcRows(header.nRows), srcX(header.xStep), srcY(header.yStep), srcGrid(header.gridType) {
+		//sanity check geometry
+		if(!(this->step > 0) || !(srcX > 0) || !(srcY > 0)) throw std::runtime_error("resampling requires positive step sizes");
+		if(0 == srcRows || 0 == srcOdd) throw std::runtime_error("can't resample an empty scan");
+		if(header.numPoints() > (size_t)std::numeric_limits<std::int32_t>::max()) throw std::runtime_error("scan has too many pixels to resample");
+
+		//compute extent of the source grid (hex rows with odd indices are shifted by half a step)
+		const bool hex = GridType::Hexagonal == srcGrid;
+		float maxX = float(srcOdd - 1) * srcX;
+		if(hex && srcRows > 1 && srcEven > 0) maxX = std::max(maxX, (float(srcEven - 1) + 0.5f) * srcX);
+		const float maxY = float(srcRows - 1) * srcY;
+		width  = (size_t)std::floor(maxX / this->step + 0.5f) + 1;
+		height = (size_t)std::floor(maxY / this->step + 0.5f) + 1;
+
+		//find the nearest source pixel for each square pixel (only the source rows above and below can contain it)
+		source.resize(width * height);
+		for(size_t row = 0; row < height; row++) {
+			const float py = this->step * row;
+			const size_t below = std::min(srcRows - 1, (size_t)std::floor(py / srcY));
+			const size_t above = std::min(srcRows - 1, below + 1);
+			for(size_t col = 0; col < width; col++) {
+				const float px = this->step * col;
+				size_t best = 0;
+				float bestDist = std::numeric_limits<float>::infinity();
+				for(const size_t r : {below, above}) {
+					const size_t rowWidth = 0 == r % 2 ? srcOdd : srcEven;
+					if(0 == rowWidth) continue;
+					const float shift = hex && 1 == r % 2 ? 0.5f : 0.0f;
+					const float fc = std::round(px / srcX - shift);
+					const size_t c = fc <= 0 ? 0 : std::min(rowWidth - 1, (size_t)fc);
+					const float dx = (c + shift) * srcX - px;
+					const float dy = r * srcY - py;
+					const float dist = dx * dx + dy * dy;
+					if(dist < bestDist) {//ties go to the lower row index (smaller y), which is checked first
+						bestDist = dist;
+						best = (r / 2) * (srcOdd + srcEven) + (1 == r % 2 ? srcOdd : 0) + rowWidth - 1 - c;//rows are stored from their last column to their first
+					}
+				}
+				source[row * width + width - 1 - col] = (std::uint32_t)best;
+			}
+		}
+	}
+
+	//@brief: get a cached index table for a scan geometry (tables are built the first time a geometry is requested)
+	//@param header: geometry of scans to resample
+	//@param step: pixel size of square grid (0 to use the x step of the source grid)
+	//@return: resampler for the geometry
+	//@note: the most recently used geometries are kept alive by the cache
+	std::shared_ptr<const SquareResampler> SquareResampler::Get(const ScanHeader& header, const float step) {
+		static const size_t CacheSize = 4;
+		static std::mutex mutex;
+		static std::deque<std::shared_ptr<const SquareResampler> > cache;//most recently used first
+		const float squareStep = 0 == step ? header.xStep : step;
+
+		//check for an existing table
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			for(size_t i = 0; i < cache.size(); i++) {
+				if(cache[i]->matches(header) && cache[i]->step == squareStep) {
+					std::shared_ptr<const SquareResampler> table = cache[i];
+					cache.erase(cache.begin() + i);
+					cache.push_front(table);
+					return table;
+				}
+			}
+		}
+
+		//build a new table outside the lock (a duplicate may be built if two threads request the same geometry at once)
+		std::shared_ptr<const SquareResampler> table = std::make_shared<const SquareResampler>(header, squareStep);
+		std::lock_guard<std::mutex> lock(mutex);
+		cache.push_front(table);
+		if(cache.size() > CacheSize) cache.pop_back();
+		return table;
+	}
+
+	//@brief: check if a scan has the geometry this table was built for
+	//@param header: scan to check
+	//@return: true if the scan can be resampled with this table
+	bool SquareResampler::matches(const ScanHeader& header) const {
+		return srcGrid == header.gridType && srcOdd == header.nColsOdd && srcEven == header.nColsEven && srcRows == header.nRows && srcX == header.xStep && srcY == header.yStep;
+	}
+
+	//@brief: resample all columns of a scan onto the square grid
+	//@param om: scan to resample (must match the geometry the table was built for)
+	//@param threads: number of threads to resample with (0 to use all hardware threads)
+	//@return: square grid scan with the same columns as om (x and y are recomputed for the new grid)
+	OrientationMap SquareResampler::resample(const OrientationMap& om, const size_t threads) const {
+		if(!matches(om)) throw std::runtime_error("scan doesn't match the geometry of the resampling table");
+		const size_t srcPoints = om.numPoints();
+
+		//build header for the square grid
+		OrientationMap sq;
+		static_cast<ScanHeader&>(sq) = om;
+		sq.gridType = GridType::Square;
+		sq.xStep = sq.yStep = step;
+		sq.nColsOdd = sq.nColsEven = width;
+		sq.nRows = height;
+
+		//allocate the same columns as the source
+		Column columns = Column(0);
+		if(om.eu   .size() == 3 * srcPoints) columns = columns | Column::Eu   ;
+		if(om.x    .size() ==     srcPoints) columns = columns | Column::X    ;
+		if(om.y    .size() ==     srcPoints) columns = columns | Column::Y    ;
+		if(om.iq   .size() ==     srcPoints) columns = columns | Column::Iq   ;
+		if(om.ci   .size() ==     srcPoints) columns = columns | Column::Ci   ;
+		if(om.sem  .size() ==     srcPoints) columns = columns | Column::Sem  ;
+		if(om.fit  .size() ==     srcPoints) columns = columns | Column::Fit  ;
+		if(om.phase.size() ==     srcPoints) columns = columns | Column::Phase;
+		if(om.qu   .size() == 4 * srcPoints) columns = columns | (om.quPlanar ? Column::QuSoA : Column::Qu);
+		sq.allocate(10, columns);
+		const size_t points = source.size();
+
+		//coordinates of the first source pixel (so the square grid has the same origin)
+		const float x0 = om.x.empty() ? 0.0f : om.x[om.index(0, 0)];
+		const float y0 = om.y.empty() ? 0.0f : om.y[om.index(0, 0)];
+
+		//gather every column for blocks of rows in a single pass
+		static const size_t MinChunkPoints = 64 * 1024;
+		size_t chunks = 0 == threads ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads;
+		chunks = std::max<size_t>(1, std::min<size_t>(chunks, points / MinChunkPoints));
+		auto remap = [&](const size_t c) {
+			const size_t firstRow = height *  c      / chunks;
+			const size_t lastRow  = height * (c + 1) / chunks;
+			const size_t first = firstRow * width;
+			const size_t n = (lastRow - firstRow) * width;
+			std::uint32_t const * const index = source.data() + first;
+			if(!sq.eu   .empty()) detail::gather(om.eu   .data(), index, sq.eu   .data() + 3 * first, n, 3);
+			if(!sq.iq   .empty()) detail::gather(om.iq   .data(), index, sq.iq   .data() +     first, n   );
+			if(!sq.ci   .empty()) detail::gather(om.ci   .data(), index, sq.ci   .data() +     first, n   );
+			if(!sq.sem  .empty()) detail::gather(om.sem  .data(), index, sq.sem  .data() +     first, n   );
+			if(!sq.fit  .empty()) detail::gather(om.fit  .data(), index, sq.fit  .data() +     first, n   );
+			if(!sq.phase.empty()) detail::gather(om.phase.data(), index, sq.phase.data() +     first, n   );
+			if(!sq.qu   .empty()) {
+				if(sq.quPlanar) {
+					for(size_t k = 0; k < 4; k++) detail::gather(om.qu.data() + k * srcPoints, index, sq.qu.data() + k * points + first, n);
+				} else {
+					detail::gather(om.qu.data(), index, sq.qu.data() + 4 * first, n, 4);
+				}
+			}
+			for(size_t row = firstRow; row < lastRow; row++) {//compute coordinates for the new grid
+				for(size_t col = 0; col < width; col++) {
+					const size_t i = sq.index(row, col);
+					if(!sq.x.empty()) sq.x[i] = x0 + step * col;
+					if(!sq.y.empty()) sq.y[i] = y0 + step * row;
+				}
+			}
+		};
+		if(1 == chunks) {
+			remap(0);
+		} else {
+			std::vector<std::thread> workers;
+			for(size_t c = 0; c < chunks; c++) workers.emplace_back(remap, c);
+			for(std::thread& t : workers) t.join();
+		}
+		return sq;
+	}
+
+	//@brief: build the mapping for a scan geometry
+	//@param header: scan geometry
+	//@param tileSize: width and height of each tile in pixels (rounded up to a power of 2)
+	TiledLayout::TiledLayout(const ScanHeader& header, const size_t tileSize) : nColsOdd(header.nColsOdd), nColsEven(header.nColsEven), nRows(header.nRows), points(header.numPoints()), shift(0) {
+		while((size_t(1) << shift) < tileSize) ++shift;
+		mask = (size_t(1) << shift) - 1;
+		tilesWide = (std::max(nColsOdd, nColsEven) + mask) >> shift;
+		tilesHigh = (nRows + mask) >> shift;
+	}
+
+	//@brief: get the scan array index of a slot in a tiled column
+	//@param slot: slot in tiled column
+	//@return: index of pixel in the scan arrays, or SIZE_MAX for padding
+	size_t TiledLayout::scanIndex(const size_t slot) const {
+		const size_t tile = slot >> (2 * shift), within = slot & ((size_t(1) << (2 * shift)) - 1);
+		const size_t row = ((tile / tilesWide) << shift) + (within >> shift);
+		const size_t col = ((tile % tilesWide) << shift) + (within & mask);
+		const size_t width = 0 == row % 2 ? nColsOdd : nColsEven;
+		if(row >= nRows || col >= width) return SIZE_MAX;
+		return (row / 2) * (nColsOdd + nColsEven) + (1 == row % 2 ? nColsOdd : 0) + width - 1 - col;
+	}
+
+	//@brief: convert a column from scan array order to the tiled layout
+	//@param scan: column in scan array order
+	//@param tiled: location to write tiled column (must hold k * slots() values), padding is value initialized
+	//@param k: number of components per value (e.g. 3 for euler angles)
+	//@param threads: number of threads to convert with (0 to use all hardware threads), rows of tiles are split between threads
+	template <typename T> void TiledLayout::toTiled(T const * const scan, T * const tiled, const size_t k, const size_t threads) const {
+		convert<true>(scan, tiled, k, threads);
+	}
+
+	//@brief: convert a column from the tiled layout to scan array order
+	//@param tiled: tiled column
+	//@param scan: location to write column in scan array order (must hold k * numPoints() values)
+	//@param k: number of components per value (e.g. 3 for euler angles)
+	//@param threads: number of threads to convert with (0 to use all hardware threads), rows of tiles are split between threads
+	template <typename T> void TiledLayout::toScan(T const * const tiled, T * const scan, const size_t k, const size_t threads) const {
+		convert<false>(tiled, scan, k, threads);
+	}
+
+	//@brief: convert a column from scan array order to the tiled layout
+	//@param scan: column in scan array order (interleaved components, e.g. OrientationMap::eu, convert planar quaternions one plane at a time with the pointer overload)
+	//@param k: number of components per value (e.g. 3 for euler angles), the column must hold k * numPoints() values
+	//@param threads: number of threads to convert with (0 to use all hardware threads)
+	//@return: tiled column (empty if scan is empty)
+	template <typename T> ScanVector<T> TiledLayout::toTiled(const ScanVector<T>& scan, const size_t k, const size_t threads) const {
+		if(scan.empty()) return ScanVector<T>();
+		if(0 == k || scan.size() != k * points) throw std::runtime_error("column size doesn't match tiled layout");
+		ScanVector<T> tiled(k * slots());
+		toTiled(scan.data(), tiled.data(), k, threads);
+		return tiled;
+	}
+
+	//@brief: convert a column from the tiled layout to scan array order
+	//@param tiled: tiled column (interleaved components)
+	//@param k: number of components per value (e.g. 3 for euler angles), the column must hold k * slots() values
+	//@param threads: number of threads to convert with (0 to use all hardware threads)
+	//@return: column in scan array order (empty if tiled is empty)
+	template <typename T> ScanVector<T> TiledLayout::toScan(const ScanVector<T>& tiled, const size_t k, const size_t threads) const {
+		if(tiled.empty()) return ScanVector<T>();
+		if(0 == k || tiled.size() != k * slots()) throw std::runtime_error("column size doesn't match tiled layout");
+		ScanVector<T> scan(k * points);
+		toScan(tiled.data(), scan.data(), k, threads);
+		return scan;
+	}
+
+	//@brief: copy between scan array order and the tiled layout
+	//@param src: column to copy from (in scan array order if Forward, tiled otherwise)
+	//@param dst: column to copy to (tiled if Forward, in scan array order otherwise)
+	//@param k: number of components per value
+	//@param threads: number of threads to convert with
+	template <bool Forward, typename T> void TiledLayout::convert(T const * const src, T * const dst, const size_t k, const size_t threads) const {
+		//copy a row of tiles, each row of pixels is a reversed run in scan order and a run of tile rows in the tiled layout
+		const size_t size = size_t(1) << shift, paddedWidth = tilesWide << shift;
+		auto convertBand = [&](const size_t firstTileRow, const size_t lastTileRow) {
+			for(size_t row = firstTileRow << shift; row < (lastTileRow << shift); row++) {
+				const size_t width = row >= nRows ? 0 : (0 == row % 2 ? nColsOdd : nColsEven);
+				const size_t rowData = k * ((row / 2) * (nColsOdd + nColsEven) + (1 == row % 2 ? nColsOdd : 0));//offset of row in scan array order
+				for(size_t c0 = 0; c0 < paddedWidth; c0 += size) {
+					const size_t run = k * index(row, c0);//offset of run in tiled column
+					const size_t count = c0 >= width ? 0 : std::min(size, width - c0);
+					if(Forward) {
+						for(size_t c = 0; c < count; c++) std::copy(src + rowData + k * (width - 1 - c0 - c), src + rowData + k * (width - c0 - c), dst + run + k * c);
+						std::fill(dst + run + k * count, dst + run + k * size, T());//padding
+					} else {
+						for(size_t c = 0; c < count; c++) std::copy(src + run + k * c, src + run + k * (c + 1), dst + rowData + k * (width - 1 - c0 - c));
+					}
+				}
+			}
+		};
+		size_t chunks = 0 == threads ? std::max<size_t>(1, std::thread::hardware_concurrency()) : threads;
+		chunks = std::max<size_t>(1, std::min(chunks, tilesHigh));
+		if(1 == chunks) {
+			convertBand(0, tilesHigh);
+		} else {
+			std::vector<std::thread> workers;
+			for(size_t i = 0; i < chunks; i++) workers.emplace_back(convertBand, tilesHigh * i / chunks, tilesHigh * (i + 1) / chunks);
+			for(std::thread& t : workers) t.join();
+		}
+	}
 }
 
 #endif//_tsl_h_
\ No newline at end of file
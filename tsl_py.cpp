@@ -0,0 +1,180 @@
+//python bindings for tsl::OrientationMap (scan columns are exposed as numpy arrays that share the C++ buffers)
+//build and test with pybind11 and numpy installed (see setup.py / pyproject.toml):
+//	pip install . && python test_tsl.py
+//usage:
+//	import tsl
+//	om = tsl.read('scan.ang', threads = 0, columns = tsl.Column.Eu | tsl.Column.Ci)
+//	om.ci.mean(), om.eu.shape, [p.name for p in om.phases]
+
+#include <sstream>
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+#include "tsl.hpp"
+
+namespace py = pybind11;
+
+//@brief: wrap a scan column in a numpy array without copying
+//@param column: column to wrap
+//@param shape: shape of array (the product must match the column size)
+//@param owner: python object that owns the column (kept alive by the array)
+//@return: array sharing the column's memory, or None if the column wasn't read
+template <typename T> py::object wrapColumn(tsl::ScanVector<T>& column, const std::vector<py::ssize_t>& shape, py::handle owner) {
+	if(column.empty()) return py::none();
+	return py::array_t<T>(shape, column.data(), owner);
+}
+
+//@brief: wrap a per pixel column of an orientation map
+//@param self: python OrientationMap
+//@param member: column to wrap
+//@param comps: number of components per pixel (1 for 1d arrays)
+//@return: array of shape (numPoints,) or (numPoints, comps), or None if the column wasn't read
+template <typename T> py::object pixelColumn(py::object self, tsl::ScanVector<T> tsl::OrientationMap::* member, const size_t comps) {
+	tsl::OrientationMap& om = self.cast<tsl::OrientationMap&>();
+	const py::ssize_t points = (py::ssize_t)om.numPoints();
+	if(1 == comps) return wrapColumn(om.*member, {points}, self);
+	return wrapColumn(om.*member, {points, (py::ssize_t)comps}, self);
+}
+
+//@brief: wrap a column of a square grid scan as an image without copying (rows are stored reversed so columns have a negative stride)
+//@param self: python OrientationMap
+//@param name: name of column ('eu', 'x', 'y', 'iq', 'ci', 'sem', 'fit', or 'phase')
+//@return: array of shape (nRows, nCols) or (nRows, nCols, 3) for euler angles
+py::object image(py::object self, const std::string& name) {
+	tsl::OrientationMap& om = self.cast<tsl::OrientationMap&>();
+	if(tsl::GridType::Square != om.gridType) throw std::runtime_error("images are only available for square grids (use resample_square for hexagonal scans)");
+	const py::ssize_t rows = (py::ssize_t)om.nRows, cols = (py::ssize_t)om.nColsOdd;
+	auto wrap = [&](auto& column, const py::ssize_t comps) -> py::object {
+		typedef typename std::decay<decltype(column)>::type::value_type T;
+		if(column.empty()) throw std::runtime_error("column '" + name + "' wasn't read");
+		if(0 == rows || 0 == cols) return py::array_t<T>(std::vector<py::ssize_t>{rows, cols});
+		const py::ssize_t item = (py::ssize_t)sizeof(T);
+		T * const first = column.data() + comps * (cols - 1);//first column of the first row is stored last
+		if(1 == comps) return py::array_t<T>({rows, cols}, {cols * item, -item}, first, self);
+		return py::array_t<T>({rows, cols, comps}, {cols * comps * item, -comps * item, item}, first, self);
+	};
+	if("eu"    == name) return wrap(om.eu   , 3);
+	if("x"     == name) return wrap(om.x    , 1);
+	if("y"     == name) return wrap(om.y    , 1);
+	if("iq"    == name) return wrap(om.iq   , 1);
+	if("ci"    == name) return wrap(om.ci   , 1);
+	if("sem"   == name) return wrap(om.sem  , 1);
+	if("fit"   == name) return wrap(om.fit  , 1);
+	if("phase" == name) return wrap(om.phase, 1);
+	throw std::runtime_error("unknown column '" + name + "'");
+}
+
+//@brief: read a scan with the GIL released
+//@param fileName: file to read
+//@param threads: number of threads to parse with (0 to use all hardware threads)
+//@param columns: columns to read (tsl.Column flags)
+//@return: scan
+std::unique_ptr<tsl::OrientationMap> readScan(const std::string& fileName, const size_t threads, const std::uint32_t columns) {
+	std::unique_ptr<tsl::OrientationMap> om(new tsl::OrientationMap());
+	py::gil_scoped_release release;//parsing doesn't touch python objects
+	om->read(fileName, threads, tsl::Column(columns));
+	return om;
+}
+
+PYBIND11_MODULE(tsl, m) {
+	m.doc() = "TSL orientation map reader";
+
+	//column selection flags (combine with |)
+	py::enum_<tsl::Column>(m, "Column", py::arithmetic())
+		.value("Eu"   , tsl::Column::Eu   )
+		.value("X"    , tsl::Column::X    )
+		.value("Y"    , tsl::Column::Y    )
+		.value("Iq"   , tsl::Column::Iq   )
+		.value("Ci"   , tsl::Column::Ci   )
+		.value("Phase", tsl::Column::Phase)
+		.value("Sem"  , tsl::Column::Sem  )
+		.value("Fit"  , tsl::Column::Fit  )
+		.value("All"  , tsl::Column::All  )
+		.value("Qu"   , tsl::Column::Qu   )
+		.value("QuSoA", tsl::Column::QuSoA);
+
+	//header objects are plain copies
+	py::class_<tsl::HKLFamily>(m, "HKLFamily")
+		.def_property_readonly("hkl"       , [](const tsl::HKLFamily& f){return py::make_tuple(f.hkl[0], f.hkl[1], f.hkl[2]);})
+		.def_readonly         ("use_index" , &tsl::HKLFamily::useIdx   )
+		.def_readonly         ("intensity" , &tsl::HKLFamily::intensity)
+		.def_readonly         ("show_bands", &tsl::HKLFamily::showBands)
+		.def("__repr__", [](const tsl::HKLFamily& f){
+			std::ostringstream ss;
+			ss << "HKLFamily(" << f.hkl[0] << ' ' << f.hkl[1] << ' ' << f.hkl[2] << ')';
+			return ss.str();
+		});
+
+	py::class_<tsl::Phase>(m, "Phase")
+		.def_readonly         ("num"         , &tsl::Phase::num   )
+		.def_readonly         ("name"        , &tsl::Phase::name  )
+		.def_readonly         ("formula"     , &tsl::Phase::form  )
+		.def_readonly         ("info"        , &tsl::Phase::info  )
+		.def_readonly         ("symmetry"    , &tsl::Phase::sym   )
+		.def_readonly         ("hkl_families", &tsl::Phase::hklFam)
+		.def_readonly         ("categories"  , &tsl::Phase::cats  )
+		.def_property_readonly("lattice"     , [](const tsl::Phase& p){return std::vector<float>(p.lat, p.lat + 6);})
+		.def_property_readonly("elastic"     , [](const tsl::Phase& p){return std::vector<float>(p.el, p.el + 36);})//6x6 matrix in row major order
+		.def("__repr__", [](const tsl::Phase& p){return "Phase(" + std::to_string(p.num) + ", '" + p.name + "')";});
+
+	//orientation maps own their columns, arrays returned by the properties keep the map alive
+	py::class_<tsl::OrientationMap>(m, "OrientationMap")
+		.def(py::init(&readScan), py::arg("file_name"), py::arg("threads") = 0, py::arg("columns") = (std::uint32_t)tsl::Column::All)
+
+		//header
+		.def_readonly         ("pix_per_um"      , &tsl::OrientationMap::pixPerUm       )
+		.def_readonly         ("x_star"          , &tsl::OrientationMap::xStar          )
+		.def_readonly         ("y_star"          , &tsl::OrientationMap::yStar          )
+		.def_readonly         ("z_star"          , &tsl::OrientationMap::zStar          )
+		.def_readonly         ("working_distance", &tsl::OrientationMap::workingDistance)
+		.def_readonly         ("x_step"          , &tsl::OrientationMap::xStep          )
+		.def_readonly         ("y_step"          , &tsl::OrientationMap::yStep          )
+		.def_readonly         ("n_cols_odd"      , &tsl::OrientationMap::nColsOdd       )
+		.def_readonly         ("n_cols_even"     , &tsl::OrientationMap::nColsEven      )
+		.def_readonly         ("n_rows"          , &tsl::OrientationMap::nRows          )
+		.def_readonly         ("operator_name"   , &tsl::OrientationMap::operatorName   )
+		.def_readonly         ("sample_id"       , &tsl::OrientationMap::sampleId       )
+		.def_readonly         ("scan_id"         , &tsl::OrientationMap::scanId         )
+		.def_readonly         ("phases"          , &tsl::OrientationMap::phaseList      )
+		.def_property_readonly("grid_type"       , [](const tsl::OrientationMap& om){
+			std::ostringstream ss;
+			ss << om.gridType;
+			return ss.str();
+		})
+		.def_property_readonly("num_points"      , &tsl::OrientationMap::numPoints)
+
+		//layout helpers
+		.def("row_width", &tsl::OrientationMap::rowWidth, py::arg("row"))
+		.def("row_start", &tsl::OrientationMap::rowStart, py::arg("row"))
+		.def("index"    , &tsl::OrientationMap::index   , py::arg("row"), py::arg("col"))
+
+		//scan data (None for columns that weren't read)
+		.def_property_readonly("eu"   , [](py::object self){return pixelColumn(self, &tsl::OrientationMap::eu   , 3);})
+		.def_property_readonly("x"    , [](py::object self){return pixelColumn(self, &tsl::OrientationMap::x    , 1);})
+		.def_property_readonly("y"    , [](py::object self){return pixelColumn(self, &tsl::OrientationMap::y    , 1);})
+		.def_property_readonly("iq"   , [](py::object self){return pixelColumn(self, &tsl::OrientationMap::iq   , 1);})
+		.def_property_readonly("ci"   , [](py::object self){return pixelColumn(self, &tsl::OrientationMap::ci   , 1);})
+		.def_property_readonly("sem"  , [](py::object self){return pixelColumn(self, &tsl::OrientationMap::sem  , 1);})
+		.def_property_readonly("fit"  , [](py::object self){return pixelColumn(self, &tsl::OrientationMap::fit  , 1);})
+		.def_property_readonly("phase", [](py::object self){return pixelColumn(self, &tsl::OrientationMap::phase, 1);})
+		.def_property_readonly("qu"   , [](py::object self) {//(numPoints, 4) interleaved or (4, numPoints) planar
+			tsl::OrientationMap& om = self.cast<tsl::OrientationMap&>();
+			const py::ssize_t points = (py::ssize_t)om.numPoints();
+			return om.quPlanar ? wrapColumn(om.qu, {4, points}, self) : wrapColumn(om.qu, {points, 4}, self);
+		})
+		.def("image", &image, py::arg("column"))
+
+		//processing that returns new maps
+		.def("resample_square", [](const tsl::OrientationMap& om, const float step, const size_t threads){
+			py::gil_scoped_release release;
+			return std::unique_ptr<tsl::OrientationMap>(new tsl::OrientationMap(tsl::resampleSquare(om, step, threads)));
+		}, py::arg("step") = 0.0f, py::arg("threads") = 0)
+		.def("__repr__", [](const tsl::OrientationMap& om){
+			std::ostringstream ss;
+			ss << "OrientationMap(" << om.gridType << " (" << om.nColsOdd << '/' << om.nColsEven << ") x " << om.nRows << ", " << om.phaseList.size() << " phase(s))";
+			return ss.str();
+		});
+
+	m.def("read", &readScan, py::arg("file_name"), py::arg("threads") = 0, py::arg("columns") = (std::uint32_t)tsl::Column::All, "read a scan (the GIL is released while parsing)");
+	m.def("can_read", &tsl::OrientationMap::CanRead, py::arg("file_name"));
+}